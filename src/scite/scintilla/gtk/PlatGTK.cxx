@@ -1950,6 +1950,146 @@ DynamicLibrary *DynamicLibrary::Load(const char *modulePath) {
 	return static_cast<DynamicLibrary *>( new DynamicLibraryImpl(modulePath) );
 }
 
+class BackgroundThreadImpl : public BackgroundThread {
+	GThread *thread;
+	Procedure procedure;
+	void *argument;
+	static gpointer Run(gpointer data) {
+		BackgroundThreadImpl *bt = static_cast<BackgroundThreadImpl *>(data);
+		bt->procedure(bt->argument);
+		return NULL;
+	}
+public:
+	BackgroundThreadImpl(Procedure procedure_, void *argument_) :
+		thread(0), procedure(procedure_), argument(argument_) {
+#if GLIB_CHECK_VERSION(2,32,0)
+		thread = g_thread_try_new("Scintilla", Run, this, NULL);
+#else
+		thread = g_thread_create(Run, this, TRUE, NULL);
+#endif
+	}
+	virtual ~BackgroundThreadImpl() {
+		if (thread)
+			g_thread_join(thread);
+	}
+	bool IsValid() const {
+		return thread != 0;
+	}
+};
+
+BackgroundThread *BackgroundThread::Start(Procedure procedure, void *argument) {
+#ifdef G_THREADS_IMPL_NONE
+	return 0;
+#else
+	BackgroundThreadImpl *bt = new BackgroundThreadImpl(procedure, argument);
+	if (!bt->IsValid()) {
+		delete bt;
+		return 0;
+	}
+	return bt;
+#endif
+}
+
+int BackgroundThread::Processors() {
+#if GLIB_CHECK_VERSION(2,36,0)
+	return g_get_num_processors();
+#else
+	return 1;
+#endif
+}
+
+class BackgroundMutexImpl : public BackgroundMutex {
+#if GLIB_CHECK_VERSION(2,32,0)
+	GMutex m;
+#endif
+	GMutex *pm;
+public:
+	BackgroundMutexImpl() {
+#if GLIB_CHECK_VERSION(2,32,0)
+		pm = &m;
+		g_mutex_init(pm);
+#else
+		pm = g_mutex_new();
+#endif
+	}
+	virtual ~BackgroundMutexImpl() {
+#if GLIB_CHECK_VERSION(2,32,0)
+		g_mutex_clear(pm);
+#else
+		g_mutex_free(pm);
+#endif
+	}
+	virtual void Lock() {
+		g_mutex_lock(pm);
+	}
+	virtual void Unlock() {
+		g_mutex_unlock(pm);
+	}
+};
+
+BackgroundMutex *BackgroundMutex::Allocate() {
+	return new BackgroundMutexImpl();
+}
+
+class BackgroundEventImpl : public BackgroundEvent {
+#if GLIB_CHECK_VERSION(2,32,0)
+	GMutex m;
+	GCond c;
+#endif
+	GMutex *pm;
+	GCond *pc;
+	bool set;
+public:
+	BackgroundEventImpl() : set(false) {
+#if GLIB_CHECK_VERSION(2,32,0)
+		pm = &m;
+		g_mutex_init(pm);
+		pc = &c;
+		g_cond_init(pc);
+#else
+		pm = g_mutex_new();
+		pc = g_cond_new();
+#endif
+	}
+	virtual ~BackgroundEventImpl() {
+#if GLIB_CHECK_VERSION(2,32,0)
+		g_cond_clear(pc);
+		g_mutex_clear(pm);
+#else
+		g_cond_free(pc);
+		g_mutex_free(pm);
+#endif
+	}
+	virtual void Set() {
+		g_mutex_lock(pm);
+		set = true;
+		g_cond_signal(pc);
+		g_mutex_unlock(pm);
+	}
+	virtual bool Wait(int milliseconds) {
+		g_mutex_lock(pm);
+#if GLIB_CHECK_VERSION(2,32,0)
+		const gint64 endTime = g_get_monotonic_time() + milliseconds * G_TIME_SPAN_MILLISECOND;
+		while (!set && g_cond_wait_until(pc, pm, endTime)) {
+		}
+#else
+		GTimeVal endTime;
+		g_get_current_time(&endTime);
+		g_time_val_add(&endTime, milliseconds * 1000);
+		while (!set && g_cond_timed_wait(pc, pm, &endTime)) {
+		}
+#endif
+		const bool wasSet = set;
+		set = false;
+		g_mutex_unlock(pm);
+		return wasSet;
+	}
+};
+
+BackgroundEvent *BackgroundEvent::Allocate() {
+	return new BackgroundEventImpl();
+}
+
 double ElapsedTime::Duration(bool reset) {
 	GTimeVal curTime;
 	g_get_current_time(&curTime);
@@ -20,7 +20,7 @@ namespace Scintilla {
 	#define SCI_METHOD
 #endif
 
-enum { dvOriginal=0, dvLineEnd=1 };
+enum { dvOriginal=0, dvLineEnd=1, dvContiguousRange=2 };
 
 class IDocument {
 public:
@@ -54,6 +54,11 @@ public:
 	virtual int SCI_METHOD GetCharacterAndWidth(Sci_Position position, Sci_Position *pWidth) const = 0;
 };
 
+class IDocumentWithContiguousRange : public IDocumentWithLineEnd {
+public:
+	virtual const char * SCI_METHOD ContiguousRange(Sci_Position position, Sci_Position *rangeLength) const = 0;
+};
+
 enum { lvOriginal=0, lvSubStyles=1 };
 
 class ILexer {
@@ -93,6 +98,14 @@ public:
 	virtual void * SCI_METHOD ConvertToDocument() = 0;
 };
 
+class IMappedText {
+public:
+	// Called when the document no longer needs the text
+	virtual void SCI_METHOD Release() = 0;
+	virtual const char * SCI_METHOD Text() = 0;
+	virtual Sci_Position SCI_METHOD Length() = 0;
+};
+
 #ifdef SCI_NAMESPACE
 }
 #endif
@@ -454,6 +454,62 @@ public:
 	static DynamicLibrary *Load(const char *modulePath);
 };
 
+/**
+ * Thread for work, such as wrapping lines, that does not use the GUI or a Surface.
+ */
+class BackgroundThread {
+public:
+	typedef void (*Procedure)(void *argument);
+
+	/// Waits for the procedure to return.
+	virtual ~BackgroundThread() {}
+
+	/// @return A thread running procedure(argument) or NULL when the platform has no threads
+	/// so the caller should do the work itself.
+	static BackgroundThread *Start(Procedure procedure, void *argument);
+
+	/// @return The number of processors available to run threads.
+	static int Processors();
+};
+
+/**
+ * Mutual exclusion for data shared with background threads.
+ */
+class BackgroundMutex {
+public:
+	virtual ~BackgroundMutex() {}
+	virtual void Lock() = 0;
+	virtual void Unlock() = 0;
+	static BackgroundMutex *Allocate();
+};
+
+class BackgroundLock {
+	BackgroundMutex *mutex;
+	// Private so BackgroundLock objects can not be copied
+	BackgroundLock(const BackgroundLock &);
+	BackgroundLock &operator=(const BackgroundLock &);
+public:
+	explicit BackgroundLock(BackgroundMutex *mutex_) : mutex(mutex_) {
+		mutex->Lock();
+	}
+	~BackgroundLock() {
+		mutex->Unlock();
+	}
+};
+
+/**
+ * Lets a background thread wake a thread waiting for it to make progress.
+ */
+class BackgroundEvent {
+public:
+	virtual ~BackgroundEvent() {}
+	virtual void Set() = 0;
+	/// Wait until Set is called or the time runs out.
+	/// @return Whether Set was called. Each Set wakes one Wait.
+	virtual bool Wait(int milliseconds) = 0;
+	static BackgroundEvent *Allocate();
+};
+
 #if defined(__clang__)
 # if __has_feature(attribute_analyzer_noreturn)
 #  define CLANG_ANALYZER_NORETURN __attribute__((analyzer_noreturn))
@@ -223,14 +223,38 @@ bool IsStreamCommentStyle(int style) {
 		style == SCE_C_COMMENTDOCKEYWORDERROR;
 }
 
+struct SymbolValue {
+	std::string value;
+	std::string arguments;
+	mutable std::vector<std::string> tokens;	///< value split into tokens when first evaluated
+	mutable bool tokenized;
+	SymbolValue(const std::string &value_="", const std::string &arguments_="") :
+		value(value_), arguments(arguments_), tokenized(false) {
+	}
+	SymbolValue &operator = (const std::string &value_) {
+		value = value_;
+		arguments.clear();
+		ForgetTokens();
+		return *this;
+	}
+	bool IsMacro() const {
+		return !arguments.empty();
+	}
+	void ForgetTokens() const {
+		tokens.clear();
+		tokenized = false;
+	}
+};
+
+// A change to the preprocessor definitions made by a line, remembering what it replaced
+// so that it can be undone when the line is lexed again.
 struct PPDefinition {
 	Sci_Position line;
 	std::string key;
-	std::string value;
-	bool isUndef;
-	std::string arguments;
-	PPDefinition(Sci_Position line_, const std::string &key_, const std::string &value_, bool isUndef_ = false, std::string arguments_="") :
-		line(line_), key(key_), value(value_), isUndef(isUndef_), arguments(arguments_) {
+	bool replaced;	///< key was defined before this line
+	SymbolValue previous;
+	PPDefinition(Sci_Position line_, const std::string &key_, bool replaced_=false, const SymbolValue &previous_=SymbolValue()) :
+		line(line_), key(key_), replaced(replaced_), previous(previous_) {
 	}
 };
 
@@ -445,22 +469,11 @@ class LexerCPP : public ILexerWithSubStyles {
 	WordList keywords4;
 	WordList ppDefinitions;
 	WordList markerList;
-	struct SymbolValue {
-		std::string value;
-		std::string arguments;
-		SymbolValue(const std::string &value_="", const std::string &arguments_="") : value(value_), arguments(arguments_) {
-		}
-		SymbolValue &operator = (const std::string &value_) {
-			value = value_;
-			arguments.clear();
-			return *this;
-		}
-		bool IsMacro() const {
-			return !arguments.empty();
-		}
-	};
 	typedef std::map<std::string, SymbolValue> SymbolTable;
 	SymbolTable preprocessorDefinitionsStart;
+	// The start definitions changed by each entry of ppDefineHistory. Kept between calls to Lex
+	// so restarting only undoes the changes made on or after the restart line.
+	SymbolTable preprocessorDefinitionsCurrent;
 	OptionsCPP options;
 	OptionSetCPP osCPP;
 	EscapeSequence escapeSeq;
@@ -550,8 +563,14 @@ public:
 	static int MaskActive(int style) {
 		return style & ~activeFlag;
 	}
+	void Define(Sci_Position line, const std::string &key, const SymbolValue &value);
+	void Undefine(Sci_Position line, const std::string &key);
+	void RememberDefinition(Sci_Position line, const std::string &key);
+	void TruncateDefinitions(size_t length);
+	void ForgetTokens();
 	void EvaluateTokens(std::vector<std::string> &tokens, const SymbolTable &preprocessorDefinitions);
 	std::vector<std::string> Tokenize(const std::string &expr) const;
+	const std::vector<std::string> &ValueTokens(const SymbolValue &symbol) const;
 	bool EvaluateExpression(const std::string &expr, const SymbolTable &preprocessorDefinitions);
 };
 
@@ -562,6 +581,7 @@ Sci_Position SCI_METHOD LexerCPP::PropertySet(const char *key, const char *val)
 			if (options.identifiersAllowDollars) {
 				setWord.Add('$');
 			}
+			ForgetTokens();
 		}
 		return 0;
 	}
@@ -622,20 +642,58 @@ Sci_Position SCI_METHOD LexerCPP::WordListSet(int n, const char *wl) {
 						preprocessorDefinitionsStart[name] = val;
 					}
 				}
+				ppDefineHistory.clear();
+				preprocessorDefinitionsCurrent = preprocessorDefinitionsStart;
 			}
 		}
 	}
 	return firstModification;
 }
 
-// Functor used to truncate history
-struct After {
-	Sci_Position line;
-	explicit After(Sci_Position line_) : line(line_) {}
-	bool operator()(PPDefinition &p) const {
-		return p.line > line;
+// Used to find where history is truncated as it is in line order
+static bool LineBeforeDefinition(Sci_Position line, const PPDefinition &p) {
+	return line < p.line;
+}
+
+void LexerCPP::Define(Sci_Position line, const std::string &key, const SymbolValue &value) {
+	RememberDefinition(line, key);
+	preprocessorDefinitionsCurrent[key] = value;
+}
+
+void LexerCPP::Undefine(Sci_Position line, const std::string &key) {
+	RememberDefinition(line, key);
+	preprocessorDefinitionsCurrent.erase(key);
+}
+
+void LexerCPP::RememberDefinition(Sci_Position line, const std::string &key) {
+	SymbolTable::const_iterator it = preprocessorDefinitionsCurrent.find(key);
+	if (it != preprocessorDefinitionsCurrent.end())
+		ppDefineHistory.push_back(PPDefinition(line, key, true, it->second));
+	else
+		ppDefineHistory.push_back(PPDefinition(line, key));
+}
+
+// Undo changes to the definitions, most recent first, until only length remain.
+void LexerCPP::TruncateDefinitions(size_t length) {
+	while (ppDefineHistory.size() > length) {
+		const PPDefinition &change = ppDefineHistory.back();
+		if (change.replaced)
+			preprocessorDefinitionsCurrent[change.key] = change.previous;
+		else
+			preprocessorDefinitionsCurrent.erase(change.key);
+		ppDefineHistory.pop_back();
 	}
-};
+}
+
+// Tokens depend on setWord so are found again after it changes.
+void LexerCPP::ForgetTokens() {
+	for (SymbolTable::const_iterator it = preprocessorDefinitionsStart.begin(); it != preprocessorDefinitionsStart.end(); ++it)
+		it->second.ForgetTokens();
+	for (SymbolTable::const_iterator it = preprocessorDefinitionsCurrent.begin(); it != preprocessorDefinitionsCurrent.end(); ++it)
+		it->second.ForgetTokens();
+	for (std::vector<PPDefinition>::const_iterator it = ppDefineHistory.begin(); it != ppDefineHistory.end(); ++it)
+		it->previous.ForgetTokens();
+}
 
 void SCI_METHOD LexerCPP::Lex(Sci_PositionU startPos, Sci_Position length, int initStyle, IDocument *pAccess) {
 	LexAccessor styler(pAccess);
@@ -695,21 +753,15 @@ void SCI_METHOD LexerCPP::Lex(Sci_PositionU startPos, Sci_Position length, int i
 	// Truncate ppDefineHistory before current line
 
 	if (!options.updatePreprocessor)
-		ppDefineHistory.clear();
+		TruncateDefinitions(0);
 
-	std::vector<PPDefinition>::iterator itInvalid = std::find_if(ppDefineHistory.begin(), ppDefineHistory.end(), After(lineCurrent-1));
+	std::vector<PPDefinition>::iterator itInvalid = std::upper_bound(ppDefineHistory.begin(), ppDefineHistory.end(), lineCurrent-1, LineBeforeDefinition);
 	if (itInvalid != ppDefineHistory.end()) {
-		ppDefineHistory.erase(itInvalid, ppDefineHistory.end());
+		TruncateDefinitions(itInvalid - ppDefineHistory.begin());
 		definitionsChanged = true;
 	}
 
-	SymbolTable preprocessorDefinitions = preprocessorDefinitionsStart;
-	for (std::vector<PPDefinition>::iterator itDef = ppDefineHistory.begin(); itDef != ppDefineHistory.end(); ++itDef) {
-		if (itDef->isUndef)
-			preprocessorDefinitions.erase(itDef->key);
-		else
-			preprocessorDefinitions[itDef->key] = SymbolValue(itDef->value, itDef->arguments);
-	}
+	const SymbolTable &preprocessorDefinitions = preprocessorDefinitionsCurrent;
 
 	std::string rawStringTerminator = rawStringTerminators.ValueAt(lineCurrent-1);
 	SparseState<std::string> rawSTNew(lineCurrent);
@@ -1232,8 +1284,7 @@ void SCI_METHOD LexerCPP::Lex(Sci_PositionU startPos, Sci_Position length, int i
 									std::string value;
 									if (startValue < restOfLine.length())
 										value = restOfLine.substr(startValue);
-									preprocessorDefinitions[key] = SymbolValue(value, args);
-									ppDefineHistory.push_back(PPDefinition(lineCurrent, key, value, false, args));
+									Define(lineCurrent, key, SymbolValue(value, args));
 									definitionsChanged = true;
 								} else {
 									// Value
@@ -1241,8 +1292,7 @@ void SCI_METHOD LexerCPP::Lex(Sci_PositionU startPos, Sci_Position length, int i
 									while ((startValue < restOfLine.length()) && IsSpaceOrTab(restOfLine[startValue]))
 										startValue++;
 									std::string value = restOfLine.substr(startValue);
-									preprocessorDefinitions[key] = value;
-									ppDefineHistory.push_back(PPDefinition(lineCurrent, key, value));
+									Define(lineCurrent, key, SymbolValue(value));
 									definitionsChanged = true;
 								}
 							}
@@ -1252,8 +1302,7 @@ void SCI_METHOD LexerCPP::Lex(Sci_PositionU startPos, Sci_Position length, int i
 								std::vector<std::string> tokens = Tokenize(restOfLine);
 								if (tokens.size() >= 1) {
 									const std::string key = tokens[0];
-									preprocessorDefinitions.erase(key);
-									ppDefineHistory.push_back(PPDefinition(lineCurrent, key, "", true));
+									Undefine(lineCurrent, key);
 									definitionsChanged = true;
 								}
 							}
@@ -1437,10 +1486,11 @@ void LexerCPP::EvaluateTokens(std::vector<std::string> &tokens, const SymbolTabl
 		if (setWordStart.Contains(static_cast<unsigned char>(tokens[i][0]))) {
 			SymbolTable::const_iterator it = preprocessorDefinitions.find(tokens[i]);
 			if (it != preprocessorDefinitions.end()) {
-				// Tokenize value
-				std::vector<std::string> macroTokens = Tokenize(it->second.value);
+				const std::vector<std::string> &valueTokens = ValueTokens(it->second);
 				if (it->second.IsMacro()) {
 					if ((i + 1 < tokens.size()) && (tokens.at(i + 1) == "(")) {
+						std::vector<std::string> macroTokens = valueTokens;
+
 						// Create map of argument name to value
 						std::vector<std::string> argumentNames = StringSplit(it->second.arguments, ',');
 						std::map<std::string, std::string> arguments;
@@ -1481,7 +1531,7 @@ void LexerCPP::EvaluateTokens(std::vector<std::string> &tokens, const SymbolTabl
 					// Remove invocation
 					tokens.erase(tokens.begin() + i);
 					// Insert results back into tokens
-					tokens.insert(tokens.begin() + i, macroTokens.begin(), macroTokens.end());
+					tokens.insert(tokens.begin() + i, valueTokens.begin(), valueTokens.end());
 				}
 			} else {
 				// Identifier not found
@@ -1614,6 +1664,15 @@ std::vector<std::string> LexerCPP::Tokenize(const std::string &expr) const {
 	return tokens;
 }
 
+// Macro values are evaluated many times so keep their tokens.
+const std::vector<std::string> &LexerCPP::ValueTokens(const SymbolValue &symbol) const {
+	if (!symbol.tokenized) {
+		symbol.tokens = Tokenize(symbol.value);
+		symbol.tokenized = true;
+	}
+	return symbol.tokens;
+}
+
 bool LexerCPP::EvaluateExpression(const std::string &expr, const SymbolTable &preprocessorDefinitions) {
 	std::vector<std::string> tokens = Tokenize(expr);
 
@@ -24,6 +24,9 @@ private:
 	 * in case there is some backtracking. */
 	enum {bufferSize=4000, slopSize=bufferSize/8};
 	char buf[bufferSize+1];
+	/** @a text is either @a buf or, when the document can provide it, a direct pointer
+	 * to a contiguous range of the document's text which avoids copying. */
+	const char *text;
 	Sci_Position startPos;
 	Sci_Position endPos;
 	int codePage;
@@ -36,6 +39,19 @@ private:
 	int documentVersion;
 
 	void Fill(Sci_Position position) {
+		if (documentVersion >= dvContiguousRange) {
+			const Sci_Position rangeStart = (position > slopSize) ? (position - slopSize) : 0;
+			Sci_Position rangeLength = 0;
+			const char *range = static_cast<IDocumentWithContiguousRange *>(pAccess)->ContiguousRange(rangeStart, &rangeLength);
+			// Near the gap it is better to copy both sides into buf
+			if (range && (rangeStart + rangeLength >= position + slopSize)) {
+				text = range;
+				startPos = rangeStart;
+				endPos = rangeStart + rangeLength;
+				return;
+			}
+		}
+		text = buf;
 		startPos = position - slopSize;
 		if (startPos + bufferSize > lenDoc)
 			startPos = lenDoc - bufferSize;
@@ -51,7 +67,7 @@ private:
 
 public:
 	explicit LexAccessor(IDocument *pAccess_) :
-		pAccess(pAccess_), startPos(extremePosition), endPos(0),
+		pAccess(pAccess_), text(buf), startPos(extremePosition), endPos(0),
 		codePage(pAccess->CodePage()),
 		encodingType(enc8bit),
 		lenDoc(pAccess->Length()),
@@ -77,7 +93,16 @@ public:
 		if (position < startPos || position >= endPos) {
 			Fill(position);
 		}
-		return buf[position - startPos];
+		return text[position - startPos];
+	}
+	/** The document may move its text when changed or while notifying watchers of changes
+	 * so a direct pointer is dropped before any call that may do that. */
+	void ReleaseRange() {
+		if (text != buf) {
+			text = buf;
+			startPos = extremePosition;
+			endPos = 0;
+		}
 	}
 	IDocumentWithLineEnd *MultiByteAccess() const {
 		if (documentVersion >= dvLineEnd) {
@@ -94,7 +119,7 @@ public:
 				return chDefault;
 			}
 		}
-		return buf[position - startPos];
+		return text[position - startPos];
 	}
 	bool IsLeadByte(char ch) const {
 		return pAccess->IsDBCSLeadByte(ch);
@@ -140,6 +165,7 @@ public:
 	}
 	void Flush() {
 		if (validLen > 0) {
+			ReleaseRange();
 			pAccess->SetStyles(validLen, styleBuf);
 			startPosStyling += validLen;
 			validLen = 0;
@@ -149,10 +175,12 @@ public:
 		return pAccess->GetLineState(line);
 	}
 	int SetLineState(Sci_Position line, int state) {
+		ReleaseRange();
 		return pAccess->SetLineState(line, state);
 	}
 	// Style setting
 	void StartAt(Sci_PositionU start) {
+		ReleaseRange();
 		pAccess->StartStyling(start, '\377');
 		startPosStyling = start;
 	}
@@ -174,6 +202,7 @@ public:
 				Flush();
 			if (validLen + (pos - startSeg + 1) >= bufferSize) {
 				// Too big for buffer so send directly
+				ReleaseRange();
 				pAccess->SetStyleFor(pos - startSeg + 1, static_cast<char>(chAttr));
 			} else {
 				for (Sci_PositionU i = startSeg; i <= pos; i++) {
@@ -185,14 +214,17 @@ public:
 		startSeg = pos+1;
 	}
 	void SetLevel(Sci_Position line, int level) {
+		ReleaseRange();
 		pAccess->SetLevel(line, level);
 	}
 	void IndicatorFill(Sci_Position start, Sci_Position end, int indicator, int value) {
+		ReleaseRange();
 		pAccess->DecorationSetCurrentIndicator(indicator);
 		pAccess->DecorationFillRange(start, value, end - start);
 	}
 
 	void ChangeLexerState(Sci_Position start, Sci_Position end) {
+		ReleaseRange();
 		pAccess->ChangeLexerState(start, end);
 	}
 };
@@ -52,6 +52,8 @@ public:
 	const char *GetWordListDescription(int index) const;
 
 	ILexer *Create() const;
+	// Lexers made from functions keep all their state in the document
+	bool Reentrant() const { return fnFactory == 0; }
 
 	virtual void Lex(Sci_PositionU startPos, Sci_Position length, int initStyle,
                   WordList *keywordlists[], Accessor &styler) const;
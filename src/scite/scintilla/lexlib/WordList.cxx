@@ -68,7 +68,7 @@ static char **ArrayFromWordList(char *wordlist, int *len, bool onlyLineEnds = fa
 }
 
 WordList::WordList(bool onlyLineEnds_) :
-	words(0), list(0), len(0), onlyLineEnds(onlyLineEnds_) {
+	words(0), list(0), len(0), onlyLineEnds(onlyLineEnds_), hashTable(0), hashMask(0) {
 	// Prevent warnings by static analyzers about uninitialized starts.
 	starts[0] = -1;
 }
@@ -100,9 +100,12 @@ void WordList::Clear() {
 		delete []list;
 		delete []words;
 	}
+	delete []hashTable;
 	words = 0;
 	list = 0;
 	len = 0;
+	hashTable = 0;
+	hashMask = 0;
 }
 
 #ifdef _MSC_VER
@@ -123,6 +126,16 @@ static void SortWordList(char **words, unsigned int len) {
 
 #endif
 
+static unsigned int HashWord(const char *s) {
+	// FNV-1a
+	unsigned int hash = 2166136261u;
+	for (; *s; s++) {
+		hash ^= static_cast<unsigned char>(*s);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
 void WordList::Set(const char *s) {
 	Clear();
 	const size_t lenS = strlen(s) + 1;
@@ -140,34 +153,25 @@ void WordList::Set(const char *s) {
 		unsigned char indexChar = words[l][0];
 		starts[indexChar] = l;
 	}
+	// Keep the table at most half full so that probe sequences stay short.
+	unsigned int hashSize = 16;
+	while (hashSize < static_cast<unsigned int>(len) * 2)
+		hashSize *= 2;
+	hashTable = new int[hashSize];
+	std::fill(hashTable, hashTable + hashSize, -1);
+	hashMask = hashSize - 1;
+	for (int w = 0; w < len; w++) {
+		unsigned int slot = HashWord(words[w]) & hashMask;
+		while ((hashTable[slot] >= 0) && (strcmp(words[hashTable[slot]], words[w]) != 0))
+			slot = (slot + 1) & hashMask;
+		if (hashTable[slot] < 0)
+			hashTable[slot] = w;
+	}
 }
 
-/** Check whether a string is in the list.
- * List elements are either exact matches or prefixes.
- * Prefix elements start with '^' and match all strings that start with the rest of the element
- * so '^GTK_' matches 'GTK_X', 'GTK_MAJOR_VERSION', and 'GTK_'.
+/** Check whether s starts with any of the prefix elements which start with '^'.
  */
-bool WordList::InList(const char *s) const {
-	if (0 == words)
-		return false;
-	unsigned char firstChar = s[0];
-	int j = starts[firstChar];
-	if (j >= 0) {
-		while (static_cast<unsigned char>(words[j][0]) == firstChar) {
-			if (s[1] == words[j][1]) {
-				const char *a = words[j] + 1;
-				const char *b = s + 1;
-				while (*a && *a == *b) {
-					a++;
-					b++;
-				}
-				if (!*a && !*b)
-					return true;
-			}
-			j++;
-		}
-	}
-	j = starts[static_cast<unsigned int>('^')];
+static bool InPrefixes(char * const *words, int j, const char *s) {
 	if (j >= 0) {
 		while (words[j][0] == '^') {
 			const char *a = words[j] + 1;
@@ -184,6 +188,76 @@ bool WordList::InList(const char *s) const {
 	return false;
 }
 
+/** Narrow [first, last) to the words with ch at position.
+ * All the words in the range must share their first position characters so
+ * they are sorted by the character at position.
+ */
+static void NarrowToCharacter(char * const *words, int &first, int &last, int position, unsigned char ch) {
+	int low = first;
+	int high = last;
+	while (low < high) {
+		const int middle = low + (high - low) / 2;
+		if (static_cast<unsigned char>(words[middle][position]) < ch)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	first = low;
+	high = last;
+	while (low < high) {
+		const int middle = low + (high - low) / 2;
+		if (static_cast<unsigned char>(words[middle][position]) <= ch)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	last = low;
+}
+
+/** Compare s with a word that has the same first character, allowing s to stop
+ * anywhere after a marker in the word.
+ */
+static bool AbbreviationMatches(const char *word, const char *s, const char marker) {
+	bool isSubword = false;
+	int start = 1;
+	if (word[1] == marker) {
+		isSubword = true;
+		start++;
+	}
+	if (s[1] == word[start]) {
+		const char *a = word + start;
+		const char *b = s + 1;
+		while (*a && *a == *b) {
+			a++;
+			if (*a == marker) {
+				isSubword = true;
+				a++;
+			}
+			b++;
+		}
+		if ((!*a || isSubword) && !*b)
+			return true;
+	}
+	return false;
+}
+
+/** Check whether a string is in the list.
+ * List elements are either exact matches or prefixes.
+ * Prefix elements start with '^' and match all strings that start with the rest of the element
+ * so '^GTK_' matches 'GTK_X', 'GTK_MAJOR_VERSION', and 'GTK_'.
+ */
+bool WordList::InList(const char *s) const {
+	if (0 == words)
+		return false;
+	unsigned int slot = HashWord(s) & hashMask;
+	for (int w = hashTable[slot]; w >= 0; w = hashTable[slot]) {
+		if ((words[w][0] == s[0]) && (strcmp(words[w], s) == 0))
+			return true;
+		slot = (slot + 1) & hashMask;
+	}
+	return InPrefixes(words, starts[static_cast<unsigned int>('^')], s);
+}
+
 /** similar to InList, but word s can be a substring of keyword.
  * eg. the keyword define is defined as def~ine. This means the word must start
  * with def to be a keyword, but also defi, defin and define are valid.
@@ -192,48 +266,31 @@ bool WordList::InList(const char *s) const {
 bool WordList::InListAbbreviated(const char *s, const char marker) const {
 	if (0 == words)
 		return false;
-	unsigned char firstChar = s[0];
-	int j = starts[firstChar];
-	if (j >= 0) {
-		while (static_cast<unsigned char>(words[j][0]) == firstChar) {
-			bool isSubword = false;
-			int start = 1;
-			if (words[j][1] == marker) {
-				isSubword = true;
-				start++;
-			}
-			if (s[1] == words[j][start]) {
-				const char *a = words[j] + start;
-				const char *b = s + 1;
-				while (*a && *a == *b) {
-					a++;
-					if (*a == marker) {
-						isSubword = true;
-						a++;
-					}
-					b++;
-				}
-				if ((!*a || isSubword) && !*b)
+	// A word can only match if it is s or if it has a marker straight after
+	// some leading part of s. The sorted words starting with each leading part
+	// form a range which narrows as the part grows.
+	int first = 0;
+	int last = len;
+	for (int position = 0;; position++) {
+		if (position > 0) {
+			int markerFirst = first;
+			int markerLast = last;
+			NarrowToCharacter(words, markerFirst, markerLast, position, marker);
+			for (int j = markerFirst; j < markerLast; j++) {
+				if (AbbreviationMatches(words[j], s, marker))
 					return true;
 			}
-			j++;
-		}
-	}
-	j = starts[static_cast<unsigned int>('^')];
-	if (j >= 0) {
-		while (words[j][0] == '^') {
-			const char *a = words[j] + 1;
-			const char *b = s;
-			while (*a && *a == *b) {
-				a++;
-				b++;
-			}
-			if (!*a)
-				return true;
-			j++;
 		}
+		if (!s[position])
+			break;
+		NarrowToCharacter(words, first, last, position, s[position]);
+		if (first == last)
+			break;
 	}
-	return false;
+	// words[first] is the shortest word starting with s so it is s if s is present.
+	if ((first < last) && s[0] && AbbreviationMatches(words[first], s, marker))
+		return true;
+	return InPrefixes(words, starts[static_cast<unsigned int>('^')], s);
 }
 
 const char *WordList::WordAt(int n) const {
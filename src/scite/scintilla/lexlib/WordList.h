@@ -21,6 +21,8 @@ class WordList {
 	int len;
 	bool onlyLineEnds;	///< Delimited by any white space or only line ends
 	int starts[256];
+	int *hashTable;	///< Indices into words by hash with open addressing, -1 for empty slots
+	unsigned int hashMask;	///< Size of hashTable - 1 as the size is a power of 2
 public:
 	explicit WordList(bool onlyLineEnds_ = false);
 	~WordList();
@@ -11,14 +11,17 @@
 #include <stdarg.h>
 
 #include <stdexcept>
+#include <vector>
 #include <algorithm>
 
 #include "Platform.h"
 
 #include "Scintilla.h"
+#include "ILexer.h"
 #include "Position.h"
 #include "SplitVector.h"
 #include "Partitioning.h"
+#include "ChunkedVector.h"
 #include "CellBuffer.h"
 #include "UniConversion.h"
 
@@ -79,45 +82,88 @@ Action::Action() {
 	data = 0;
 	lenData = 0;
 	mayCoalesce = false;
+	block = 0;
 }
 
-Action::~Action() {
-	Destroy();
-}
-
-void Action::Create(actionType at_, int position_, const char *data_, int lenData_, bool mayCoalesce_) {
-	delete []data;
-	data = NULL;
-	position = position_;
+void Action::Create(actionType at_, int position_, char *data_, int lenData_, bool mayCoalesce_, int block_) {
 	at = at_;
-	if (lenData_) {
-		data = new char[lenData_];
-		memcpy(data, data_, lenData_);
-	}
+	position = position_;
+	data = data_;
 	lenData = lenData_;
 	mayCoalesce = mayCoalesce_;
+	block = block_;
 }
 
-void Action::Destroy() {
-	delete []data;
-	data = 0;
+UndoArena::UndoArena() : blocksReleased(0), allocated(0) {
 }
 
-void Action::Grab(Action *source) {
-	delete []data;
+UndoArena::~UndoArena() {
+	ReleaseAll();
+}
 
-	position = source->position;
-	at = source->at;
-	data = source->data;
-	lenData = source->lenData;
-	mayCoalesce = source->mayCoalesce;
+void UndoArena::AddBlock(int size) {
+	Block blockNew;
+	blockNew.text = new char[size];
+	blockNew.size = size;
+	blockNew.used = 0;
+	blocks.push_back(blockNew);
+	allocated += size;
+}
 
-	// Ownership of source data transferred to this
-	source->position = 0;
-	source->at = startAction;
-	source->data = 0;
-	source->lenData = 0;
-	source->mayCoalesce = true;
+char *UndoArena::Allocate(int length, int &block) {
+	if (blocks.empty() || (blocks.back().size - blocks.back().used < length)) {
+		AddBlock(std::max(static_cast<int>(blockSize), length));
+	}
+	Block &last = blocks.back();
+	char *text = last.text + last.used;
+	last.used += length;
+	block = blocksReleased + static_cast<int>(blocks.size()) - 1;
+	return text;
+}
+
+char *UndoArena::Extend(char *text, int length, int lengthExtra, int &block) {
+	Block &last = blocks.back();
+	if ((text + length == last.text + last.used) && (last.size - last.used >= lengthExtra)) {
+		last.used += lengthExtra;
+		return text;
+	}
+	// The old copy is left unused until its block is released
+	char *moved = Allocate(length + lengthExtra, block);
+	memcpy(moved, text, length);
+	return moved;
+}
+
+void UndoArena::ReleaseFrom(const char *text, int block) {
+	const size_t index = block - blocksReleased;
+	while (blocks.size() > index + 1) {
+		allocated -= blocks.back().size;
+		delete []blocks.back().text;
+		blocks.pop_back();
+	}
+	if (index < blocks.size()) {
+		blocks[index].used = static_cast<int>(text - blocks[index].text);
+		if (blocks[index].used == 0) {
+			allocated -= blocks[index].size;
+			delete []blocks[index].text;
+			blocks.pop_back();
+		}
+	}
+}
+
+void UndoArena::ReleaseBefore(int block) {
+	const int count = std::min(block - blocksReleased, static_cast<int>(blocks.size()));
+	if (count > 0) {
+		for (int b = 0; b < count; b++) {
+			allocated -= blocks[b].size;
+			delete []blocks[b].text;
+		}
+		blocks.erase(blocks.begin(), blocks.begin() + count);
+		blocksReleased += count;
+	}
+}
+
+void UndoArena::ReleaseAll() {
+	ReleaseBefore(blocksReleased + static_cast<int>(blocks.size()));
 }
 
 // The undo history stores a sequence of user operations that represent the user's view of the
@@ -147,6 +193,8 @@ UndoHistory::UndoHistory() {
 	undoSequenceDepth = 0;
 	savePoint = 0;
 	tentativePoint = -1;
+	memoryLimit = 0;
+	evictionBlocked = false;
 
 	actions[currentAction].Create(startAction);
 }
@@ -163,14 +211,58 @@ void UndoHistory::EnsureUndoRoom() {
 		// Run out of undo nodes so extend the array
 		int lenActionsNew = lenActions * 2;
 		Action *actionsNew = new Action[lenActionsNew];
-		for (int act = 0; act <= currentAction; act++)
-			actionsNew[act].Grab(&actions[act]);
+		const int lastAction = std::max(currentAction, maxAction);
+		for (int act = 0; act <= lastAction; act++)
+			actionsNew[act] = actions[act];
 		delete []actions;
 		lenActions = lenActionsNew;
 		actions = actionsNew;
 	}
 }
 
+void UndoHistory::ReleaseFrom(int act) {
+	for (; act <= maxAction; act++) {
+		if (actions[act].lenData > 0) {
+			arena.ReleaseFrom(actions[act].data, actions[act].block);
+			return;
+		}
+	}
+}
+
+// Typing and deleting produce a run of small actions in one user operation which
+// are merged into the previous action while it is the last text in the arena.
+bool UndoHistory::MergeAction(actionType at, int position, const char *data, int lengthData,
+	bool mayCoalesce, const char *&merged) {
+	const int mergeLimit = 4096;
+	if ((currentAction < 1) || (lengthData <= 0) || !mayCoalesce)
+		return false;
+	// The save and tentative points must stay between the previous action and this one
+	if ((currentAction == savePoint) || (currentAction == tentativePoint))
+		return false;
+	Action &actPrevious = actions[currentAction - 1];
+	if ((actPrevious.at != at) || (actPrevious.lenData <= 0) || !actPrevious.mayCoalesce ||
+		(actPrevious.lenData + lengthData > mergeLimit))
+		return false;
+	const bool append = ((at == insertAction) && (position == actPrevious.position + actPrevious.lenData)) ||
+		((at == removeAction) && (position == actPrevious.position));
+	const bool prepend = (at == removeAction) && (position + lengthData == actPrevious.position);
+	if (!append && !prepend)
+		return false;
+	char *text = arena.Extend(actPrevious.data, actPrevious.lenData, lengthData, actPrevious.block);
+	if (append) {
+		memcpy(text + actPrevious.lenData, data, lengthData);
+		merged = text + actPrevious.lenData;
+	} else {
+		memmove(text + lengthData, text, actPrevious.lenData);
+		memcpy(text, data, lengthData);
+		actPrevious.position = position;
+		merged = text;
+	}
+	actPrevious.data = text;
+	actPrevious.lenData += lengthData;
+	return true;
+}
+
 const char *UndoHistory::AppendAction(actionType at, int position, const char *data, int lengthData,
 	bool &startSequence, bool mayCoalesce) {
 	EnsureUndoRoom();
@@ -239,12 +331,80 @@ const char *UndoHistory::AppendAction(actionType at, int position, const char *d
 		currentAction++;
 	}
 	startSequence = oldCurrentAction != currentAction;
-	int actionWithData = currentAction;
-	actions[currentAction].Create(at, position, data, lengthData, mayCoalesce);
+	if (startSequence)
+		evictionBlocked = false;
+	// Any redo actions are discarded
+	ReleaseFrom(currentAction);
+	const char *merged = 0;
+	if (!startSequence && MergeAction(at, position, data, lengthData, mayCoalesce, merged)) {
+		maxAction = currentAction;
+		return merged;
+	}
+	char *text = 0;
+	int block = 0;
+	if (lengthData > 0) {
+		text = arena.Allocate(lengthData, block);
+		memcpy(text, data, lengthData);
+	}
+	actions[currentAction].Create(at, position, text, lengthData, mayCoalesce, block);
 	currentAction++;
 	actions[currentAction].Create(startAction);
 	maxAction = currentAction;
-	return actions[actionWithData].data;
+	if ((memoryLimit > 0) && !evictionBlocked && (Memory() > static_cast<size_t>(memoryLimit))) {
+		EvictOldest();
+	}
+	return text;
+}
+
+// Whole user operations are evicted from the start of the history until it is a quarter
+// below the limit so that eviction is not repeated for every action.
+// The operation containing the current action is never evicted. A save point in the evicted
+// operations can no longer be reached so is forgotten while later save points move with the actions.
+// When that operation alone keeps the history over the limit, eviction stops until another
+// operation starts so that each action added to a large group does not scan the whole group.
+void UndoHistory::EvictOldest() {
+	if (tentativePoint >= 0)
+		return;
+	const size_t target = memoryLimit - memoryLimit / 4;
+	size_t memory = Memory();
+	int evicted = 0;
+	int act = 1;
+	while (memory > target) {
+		size_t freed = sizeof(Action);
+		while ((act < currentAction) && (actions[act].at != startAction)) {
+			freed += actions[act].lenData + sizeof(Action);
+			act++;
+		}
+		if (act >= currentAction)
+			break;
+		// act is the start action ending an operation
+		evicted = act;
+		memory -= std::min(memory, freed);
+		act++;
+	}
+	if (evicted == 0) {
+		evictionBlocked = true;
+		return;
+	}
+	actions[0] = actions[evicted];
+	for (int actMove = evicted + 1; actMove <= maxAction; actMove++)
+		actions[actMove - evicted] = actions[actMove];
+	for (int actClear = maxAction - evicted + 1; actClear <= maxAction; actClear++)
+		actions[actClear].Create(startAction);
+	currentAction -= evicted;
+	maxAction -= evicted;
+	if (savePoint >= evicted)
+		savePoint -= evicted;
+	else
+		savePoint = -1;
+	act = 0;
+	while ((act <= maxAction) && (actions[act].lenData <= 0))
+		act++;
+	if (act <= maxAction)
+		arena.ReleaseBefore(actions[act].block);
+	else
+		arena.ReleaseAll();
+	evictionBlocked = Memory() > static_cast<size_t>(memoryLimit);
 }
 
 void UndoHistory::BeginUndoAction() {
@@ -252,6 +412,7 @@ void UndoHistory::BeginUndoAction() {
 	if (undoSequenceDepth == 0) {
 		if (actions[currentAction].at != startAction) {
 			currentAction++;
+			ReleaseFrom(currentAction);
 			actions[currentAction].Create(startAction);
 			maxAction = currentAction;
 		}
@@ -267,10 +428,16 @@ void UndoHistory::EndUndoAction() {
 	if (0 == undoSequenceDepth) {
 		if (actions[currentAction].at != startAction) {
 			currentAction++;
+			ReleaseFrom(currentAction);
 			actions[currentAction].Create(startAction);
 			maxAction = currentAction;
 		}
 		actions[currentAction].mayCoalesce = false;
+		// The group is complete so eviction may now remove operations before it
+		evictionBlocked = false;
+		if ((memoryLimit > 0) && (Memory() > static_cast<size_t>(memoryLimit))) {
+			EvictOldest();
+		}
 	}
 }
 
@@ -280,12 +447,23 @@ void UndoHistory::DropUndoSequence() {
 
 void UndoHistory::DeleteUndoHistory() {
 	for (int i = 1; i < maxAction; i++)
-		actions[i].Destroy();
+		actions[i].Create(startAction);
+	arena.ReleaseAll();
 	maxAction = 0;
 	currentAction = 0;
 	actions[currentAction].Create(startAction);
 	savePoint = 0;
 	tentativePoint = -1;
+	evictionBlocked = false;
+}
+
+size_t UndoHistory::Memory() const {
+	return arena.Allocated() + (maxAction + 1) * sizeof(Action);
+}
+
+void UndoHistory::SetMemoryLimit(int memoryLimit_) {
+	memoryLimit = std::max(memoryLimit_, 0);
+	evictionBlocked = false;
 }
 
 void UndoHistory::SetSavePoint() {
@@ -303,6 +481,7 @@ void UndoHistory::TentativeStart() {
 void UndoHistory::TentativeCommit() {
 	tentativePoint = -1;
 	// Truncate undo history
+	ReleaseFrom(currentAction + 1);
 	maxAction = currentAction;
 }
 
@@ -366,16 +545,57 @@ void UndoHistory::CompletedRedoStep() {
 	currentAction++;
 }
 
-CellBuffer::CellBuffer() {
+CellBuffer::CellBuffer(bool chunked) : substance(chunked), style(chunked) {
+	mappedText = 0;
+	mapped = 0;
+	lengthMapped = 0;
 	readOnly = false;
 	utf8LineEnds = 0;
 	collectingUndo = true;
 }
 
 CellBuffer::~CellBuffer() {
+	ReleaseMapped();
+}
+
+void CellBuffer::SetMapped(IMappedText *mappedText_) {
+	PLATFORM_ASSERT(Length() == 0);
+	ReleaseMapped();
+	mappedText = mappedText_;
+	mapped = mappedText->Text();
+	lengthMapped = mappedText->Length();
+	if (!mapped || (lengthMapped <= 0)) {
+		ReleaseMapped();
+	}
+	ResetLineEnds();
+}
+
+void CellBuffer::ReleaseMapped() {
+	if (mappedText) {
+		mappedText->Release();
+		mappedText = 0;
+	}
+	mapped = 0;
+	lengthMapped = 0;
+}
+
+void CellBuffer::Materialise() {
+	if (mapped) {
+		substance.InsertFromArray(0, mapped, 0, lengthMapped);
+		ReleaseMapped();
+	}
+}
+
+void CellBuffer::EnsureStyleLength(int length) {
+	if (style.Length() < length) {
+		style.InsertValue(style.Length(), length - style.Length(), 0);
+	}
 }
 
 char CellBuffer::CharAt(int position) const {
+	if (mapped) {
+		return ((position >= 0) && (position < lengthMapped)) ? mapped[position] : 0;
+	}
 	return substance.ValueAt(position);
 }
 
@@ -384,9 +604,13 @@ void CellBuffer::GetCharRange(char *buffer, int position, int lengthRetrieve) co
 		return;
 	if (position < 0)
 		return;
-	if ((position + lengthRetrieve) > substance.Length()) {
+	if ((position + lengthRetrieve) > Length()) {
 		Platform::DebugPrintf("Bad GetCharRange %d for %d of %d\n", position,
-		                      lengthRetrieve, substance.Length());
+		                      lengthRetrieve, Length());
+		return;
+	}
+	if (mapped) {
+		memcpy(buffer, mapped + position, lengthRetrieve);
 		return;
 	}
 	substance.GetRange(buffer, position, lengthRetrieve);
@@ -401,26 +625,48 @@ void CellBuffer::GetStyleRange(unsigned char *buffer, int position, int lengthRe
 		return;
 	if (position < 0)
 		return;
-	if ((position + lengthRetrieve) > style.Length()) {
+	if ((position + lengthRetrieve) > Length()) {
 		Platform::DebugPrintf("Bad GetStyleRange %d for %d of %d\n", position,
-		                      lengthRetrieve, style.Length());
+		                      lengthRetrieve, Length());
 		return;
 	}
-	style.GetRange(reinterpret_cast<char *>(buffer), position, lengthRetrieve);
+	// Positions after the allocated styles have style 0
+	const int lengthStyled = std::max(std::min(lengthRetrieve, style.Length() - position), 0);
+	if (lengthStyled > 0)
+		style.GetRange(reinterpret_cast<char *>(buffer), position, lengthStyled);
+	memset(buffer + lengthStyled, 0, lengthRetrieve - lengthStyled);
 }
 
 const char *CellBuffer::BufferPointer() {
+	Materialise();
 	return substance.BufferPointer();
 }
 
 const char *CellBuffer::RangePointer(int position, int rangeLength) {
+	if (mapped) {
+		return mapped + position;
+	}
 	return substance.RangePointer(position, rangeLength);
 }
 
 int CellBuffer::GapPosition() const {
+	if (mapped) {
+		return lengthMapped;
+	}
 	return substance.GapPosition();
 }
 
+const char *CellBuffer::ContiguousRange(int position, int &rangeLength) const {
+	rangeLength = 0;
+	if ((position < 0) || (position >= Length()))
+		return 0;
+	if (mapped) {
+		rangeLength = lengthMapped - position;
+		return mapped + position;
+	}
+	return substance.ContiguousRange(position, rangeLength);
+}
+
 // The char* returned is to an allocation owned by the undo history
 const char *CellBuffer::InsertString(int position, const char *s, int insertLength, bool &startSequence) {
 	// InsertString and DeleteChars are the bottleneck though which all changes occur
@@ -439,7 +685,8 @@ const char *CellBuffer::InsertString(int position, const char *s, int insertLeng
 
 bool CellBuffer::SetStyleAt(int position, char styleValue) {
 	char curVal = style.ValueAt(position);
-	if (curVal != styleValue) {
+	if ((curVal != styleValue) && (position >= 0) && (position < Length())) {
+		EnsureStyleLength(position + 1);
 		style.SetValueAt(position, styleValue);
 		return true;
 	} else {
@@ -450,7 +697,13 @@ bool CellBuffer::SetStyleAt(int position, char styleValue) {
 bool CellBuffer::SetStyleFor(int position, int lengthStyle, char styleValue) {
 	bool changed = false;
 	PLATFORM_ASSERT(lengthStyle == 0 ||
-		(lengthStyle > 0 && lengthStyle + position <= style.Length()));
+		(lengthStyle > 0 && lengthStyle + position <= Length()));
+	if (styleValue == 0) {
+		// Positions after the allocated styles already have style 0
+		lengthStyle = std::max(std::min(lengthStyle, style.Length() - position), 0);
+	} else if (lengthStyle > 0) {
+		EnsureStyleLength(std::min(position + lengthStyle, Length()));
+	}
 	while (lengthStyle--) {
 		char curVal = style.ValueAt(position);
 		if (curVal != styleValue) {
@@ -462,6 +715,38 @@ bool CellBuffer::SetStyleFor(int position, int lengthStyle, char styleValue) {
 	return changed;
 }
 
+/// Copy styles straight into the contiguous pieces of the style buffer.
+/// @return true if any style changed, with firstChanged and lastChanged set to the range changed.
+bool CellBuffer::SetStyles(int position, int lengthStyle, const char *styles, int &firstChanged, int &lastChanged) {
+	PLATFORM_ASSERT(lengthStyle == 0 ||
+		(lengthStyle > 0 && lengthStyle + position <= Length()));
+	// Positions after the allocated styles already have style 0
+	int lengthAllocate = lengthStyle;
+	while ((lengthAllocate > 0) && (position + lengthAllocate > style.Length()) && (styles[lengthAllocate - 1] == 0))
+		lengthAllocate--;
+	if (lengthAllocate > 0)
+		EnsureStyleLength(position + lengthAllocate);
+	lengthStyle = std::max(std::min(lengthStyle, style.Length() - position), 0);
+	bool changed = false;
+	int offset = 0;
+	while (offset < lengthStyle) {
+		int rangeLength = 0;
+		char *range = style.ContiguousRange(position + offset, rangeLength);
+		rangeLength = std::min(rangeLength, lengthStyle - offset);
+		for (int i = 0; i < rangeLength; i++) {
+			if (range[i] != styles[offset + i]) {
+				if (!changed)
+					firstChanged = position + offset + i;
+				changed = true;
+				lastChanged = position + offset + i;
+				range[i] = styles[offset + i];
+			}
+		}
+		offset += rangeLength;
+	}
+	return changed;
+}
+
 // The char* returned is to an allocation owned by the undo history
 const char *CellBuffer::DeleteChars(int position, int deleteLength, bool &startSequence) {
 	// InsertString and DeleteChars are the bottleneck though which all changes occur
@@ -471,7 +756,7 @@ const char *CellBuffer::DeleteChars(int position, int deleteLength, bool &startS
 		if (collectingUndo) {
 			// Save into the undo/redo stack, but only the characters - not the formatting
 			// The gap would be moved to position anyway for the deletion so this doesn't cost extra
-			data = substance.RangePointer(position, deleteLength);
+			data = RangePointer(position, deleteLength);
 			data = uh.AppendAction(removeAction, position, data, deleteLength, startSequence);
 		}
 
@@ -481,12 +766,17 @@ const char *CellBuffer::DeleteChars(int position, int deleteLength, bool &startS
 }
 
 int CellBuffer::Length() const {
+	if (mapped) {
+		return lengthMapped;
+	}
 	return substance.Length();
 }
 
 void CellBuffer::Allocate(int newSize) {
-	substance.ReAllocate(newSize);
-	style.ReAllocate(newSize);
+	if (!mapped) {
+		substance.ReAllocate(newSize);
+		style.ReAllocate(newSize);
+	}
 }
 
 void CellBuffer::SetLineEndTypes(int utf8LineEnds_) {
@@ -576,10 +866,10 @@ void CellBuffer::RemoveLine(int line) {
 
 bool CellBuffer::UTF8LineEndOverlaps(int position) const {
 	unsigned char bytes[] = {
-		static_cast<unsigned char>(substance.ValueAt(position-2)),
-		static_cast<unsigned char>(substance.ValueAt(position-1)),
-		static_cast<unsigned char>(substance.ValueAt(position)),
-		static_cast<unsigned char>(substance.ValueAt(position+1)),
+		static_cast<unsigned char>(CharAt(position-2)),
+		static_cast<unsigned char>(CharAt(position-1)),
+		static_cast<unsigned char>(CharAt(position)),
+		static_cast<unsigned char>(CharAt(position+1)),
 	};
 	return UTF8IsSeparator(bytes) || UTF8IsSeparator(bytes+1) || UTF8IsNEL(bytes+1);
 }
@@ -596,7 +886,7 @@ void CellBuffer::ResetLineEnds() {
 	unsigned char chBeforePrev = 0;
 	unsigned char chPrev = 0;
 	for (int i = 0; i < length; i++) {
-		unsigned char ch = substance.ValueAt(position + i);
+		unsigned char ch = mapped ? mapped[position + i] : substance.ValueAt(position + i);
 		if (ch == '\r') {
 			InsertLine(lineInsert, (position + i) + 1, atLineStart);
 			lineInsert++;
@@ -624,6 +914,7 @@ void CellBuffer::BasicInsertString(int position, const char *s, int insertLength
 	if (insertLength == 0)
 		return;
 	PLATFORM_ASSERT(insertLength > 0);
+	Materialise();
 
 	unsigned char chAfter = substance.ValueAt(position);
 	bool breakingUTF8LineEnd = false;
@@ -632,7 +923,8 @@ void CellBuffer::BasicInsertString(int position, const char *s, int insertLength
 	}
 
 	substance.InsertFromArray(position, s, 0, insertLength);
-	style.InsertValue(position, insertLength, 0);
+	if (position < style.Length())
+		style.InsertValue(position, insertLength, 0);
 
 	int lineInsert = lv.LineFromPosition(position) + 1;
 	bool atLineStart = lv.LineStart(lineInsert-1) == position;
@@ -700,6 +992,7 @@ void CellBuffer::BasicInsertString(int position, const char *s, int insertLength
 void CellBuffer::BasicDeleteChars(int position, int deleteLength) {
 	if (deleteLength == 0)
 		return;
+	Materialise();
 
 	if ((position == 0) && (deleteLength == substance.Length())) {
 		// If whole buffer is being deleted, faster to reinitialise lines data
@@ -762,7 +1055,8 @@ void CellBuffer::BasicDeleteChars(int position, int deleteLength) {
 		}
 	}
 	substance.DeleteRange(position, deleteLength);
-	style.DeleteRange(position, deleteLength);
+	if (position < style.Length())
+		style.DeleteRange(position, std::min(deleteLength, style.Length() - position));
 }
 
 bool CellBuffer::SetUndoCollection(bool collectUndo) {
@@ -792,6 +1086,18 @@ void CellBuffer::DeleteUndoHistory() {
 	uh.DeleteUndoHistory();
 }
 
+int CellBuffer::UndoMemory() const {
+	return static_cast<int>(std::min(uh.Memory(), static_cast<size_t>(0x7fffffff)));
+}
+
+void CellBuffer::SetUndoMemoryLimit(int memoryLimit) {
+	uh.SetMemoryLimit(memoryLimit);
+}
+
+int CellBuffer::GetUndoMemoryLimit() const {
+	return uh.GetMemoryLimit();
+}
+
 bool CellBuffer::CanUndo() const {
 	return uh.CanUndo();
 }
@@ -807,7 +1113,7 @@ const Action &CellBuffer::GetUndoStep() const {
 void CellBuffer::PerformUndoStep() {
 	const Action &actionStep = uh.GetUndoStep();
 	if (actionStep.at == insertAction) {
-		if (substance.Length() < actionStep.lenData) {
+		if (Length() < actionStep.lenData) {
 			throw std::runtime_error(
 				"CellBuffer::PerformUndoStep: deletion must be less than document length.");
 		}
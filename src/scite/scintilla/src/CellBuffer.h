@@ -12,6 +12,8 @@
 namespace Scintilla {
 #endif
 
+class IMappedText;
+
 // Interface to per-line data that wants to see each line insertion and deletion
 class PerLine {
 public:
@@ -69,6 +71,7 @@ enum actionType { insertAction, removeAction, startAction, containerAction };
 
 /**
  * Actions are used to store all the information required to perform one undo/redo step.
+ * The text of an action is owned by the UndoArena of its UndoHistory.
  */
 class Action {
 public:
@@ -77,16 +80,55 @@ public:
 	char *data;
 	int lenData;
 	bool mayCoalesce;
+	/// Arena block holding data.
+	int block;
 
 	Action();
-	~Action();
-	void Create(actionType at_, int position_=0, const char *data_=0, int lenData_=0, bool mayCoalesce_=true);
-	void Destroy();
-	void Grab(Action *source);
+	void Create(actionType at_, int position_=0, char *data_=0, int lenData_=0, bool mayCoalesce_=true, int block_=0);
+};
+
+/**
+ * Holds the text of undo actions in large blocks, in the same order as the actions.
+ * Text is released from the end when redo actions are discarded and whole blocks
+ * are released from the start when the oldest actions are evicted.
+ * Blocks are numbered from the creation of the arena so numbers stay valid as
+ * blocks are released.
+ */
+class UndoArena {
+	struct Block {
+		char *text;
+		int size;
+		int used;
+	};
+	std::vector<Block> blocks;
+	int blocksReleased;
+	size_t allocated;
+	void AddBlock(int size);
+
+	// Private so UndoArena objects can not be copied
+	UndoArena(const UndoArena &);
+	UndoArena &operator=(const UndoArena &);
+
+public:
+	enum { blockSize = 0x10000 };
+	UndoArena();
+	~UndoArena();
+	char *Allocate(int length, int &block);
+	/// Grow text, which must be the last allocation, by lengthExtra. It is moved when there is no room.
+	char *Extend(char *text, int length, int lengthExtra, int &block);
+	/// Release text, which must be an allocation, and all allocations after it.
+	void ReleaseFrom(const char *text, int block);
+	void ReleaseBefore(int block);
+	void ReleaseAll();
+	size_t Allocated() const {
+		return allocated;
+	}
 };
 
 /**
- *
+ * The actions and text of the undo history. Consecutive typing and deletion within
+ * one user operation are merged into a single action. With a memory limit, the oldest
+ * user operations are evicted once the history grows past the limit.
  */
 class UndoHistory {
 	Action *actions;
@@ -96,8 +138,15 @@ class UndoHistory {
 	int undoSequenceDepth;
 	int savePoint;
 	int tentativePoint;
+	UndoArena arena;
+	int memoryLimit;
+	bool evictionBlocked;	///< Over the limit but only the open operation is left so wait for the next one
 
 	void EnsureUndoRoom();
+	/// Release the text of actions from act onwards.
+	void ReleaseFrom(int act);
+	bool MergeAction(actionType at, int position, const char *data, int lengthData, bool mayCoalesce, const char *&merged);
+	void EvictOldest();
 
 	// Private so UndoHistory objects can not be copied
 	UndoHistory(const UndoHistory &);
@@ -113,6 +162,12 @@ public:
 	void DropUndoSequence();
 	void DeleteUndoHistory();
 
+	/// Bytes used by actions and their text.
+	size_t Memory() const;
+	/// 0 means no limit.
+	void SetMemoryLimit(int memoryLimit_);
+	int GetMemoryLimit() const { return memoryLimit; }
+
 	/// The save point is a marker in the undo stack where the container has stated that
 	/// the buffer was saved. Undo and redo can move over the save point.
 	void SetSavePoint();
@@ -136,15 +191,97 @@ public:
 	void CompletedRedoStep();
 };
 
+/**
+ * Characters or styles held either in a single gap buffer or, for very large
+ * documents, in chunks so that edits far apart do not move the whole gap.
+ */
+class CellStore {
+	SplitVector<char> gapped;
+	ChunkedVector<char> *chunked;
+	// Private so CellStore objects can not be copied
+	CellStore(const CellStore &);
+	CellStore &operator=(const CellStore &);
+public:
+	explicit CellStore(bool chunked_) : chunked(chunked_ ? new ChunkedVector<char>() : 0) {
+	}
+	~CellStore() {
+		delete chunked;
+	}
+	bool IsChunked() const {
+		return chunked != 0;
+	}
+	char ValueAt(int position) const {
+		return chunked ? chunked->ValueAt(position) : gapped.ValueAt(position);
+	}
+	void SetValueAt(int position, char v) {
+		if (chunked)
+			chunked->SetValueAt(position, v);
+		else
+			gapped.SetValueAt(position, v);
+	}
+	int Length() const {
+		return chunked ? chunked->Length() : gapped.Length();
+	}
+	void ReAllocate(int newSize) {
+		if (!chunked)
+			gapped.ReAllocate(newSize);
+	}
+	void InsertFromArray(int positionToInsert, const char *s, int positionFrom, int insertLength) {
+		if (chunked)
+			chunked->InsertFromArray(positionToInsert, s, positionFrom, insertLength);
+		else
+			gapped.InsertFromArray(positionToInsert, s, positionFrom, insertLength);
+	}
+	void InsertValue(int position, int insertLength, char v) {
+		if (chunked)
+			chunked->InsertValue(position, insertLength, v);
+		else
+			gapped.InsertValue(position, insertLength, v);
+	}
+	void DeleteRange(int position, int deleteLength) {
+		if (chunked)
+			chunked->DeleteRange(position, deleteLength);
+		else
+			gapped.DeleteRange(position, deleteLength);
+	}
+	void GetRange(char *buffer, int position, int retrieveLength) const {
+		if (chunked)
+			chunked->GetRange(buffer, position, retrieveLength);
+		else
+			gapped.GetRange(buffer, position, retrieveLength);
+	}
+	char *BufferPointer() {
+		return chunked ? chunked->BufferPointer() : gapped.BufferPointer();
+	}
+	char *RangePointer(int position, int rangeLength) {
+		return chunked ? chunked->RangePointer(position, rangeLength) : gapped.RangePointer(position, rangeLength);
+	}
+	int GapPosition() const {
+		return chunked ? chunked->GapPosition() : gapped.GapPosition();
+	}
+	char *ContiguousRange(int position, int &rangeLength) {
+		return chunked ? chunked->ContiguousRange(position, rangeLength) : gapped.ContiguousRange(position, rangeLength);
+	}
+	const char *ContiguousRange(int position, int &rangeLength) const {
+		return chunked ? chunked->ContiguousRange(position, rangeLength) : gapped.ContiguousRange(position, rangeLength);
+	}
+};
+
 /**
  * Holder for an expandable array of characters that supports undo and line markers.
  * Based on article "Data Structures in a Bit-Mapped Text Editor"
  * by Wilfred J. Hansen, Byte January 1987, page 183.
+ * The text may instead be read from a mapped file until it is first modified.
+ * Styles are only allocated as far as the last position with a non-zero style.
+ * Very large documents may choose chunked storage when they are created.
  */
 class CellBuffer {
 private:
-	SplitVector<char> substance;
-	SplitVector<char> style;
+	CellStore substance;
+	CellStore style;
+	IMappedText *mappedText;
+	const char *mapped;
+	int lengthMapped;
 	bool readOnly;
 	int utf8LineEnds;
 
@@ -155,23 +292,38 @@ private:
 
 	bool UTF8LineEndOverlaps(int position) const;
 	void ResetLineEnds();
+	/// Copy mapped text into substance so it can be modified.
+	void Materialise();
+	void ReleaseMapped();
+	void EnsureStyleLength(int length);
+
+	// Private so CellBuffer objects can not be copied
+	CellBuffer(const CellBuffer &);
 	/// Actions without undo
 	void BasicInsertString(int position, const char *s, int insertLength);
 	void BasicDeleteChars(int position, int deleteLength);
 
 public:
 
-	CellBuffer();
+	explicit CellBuffer(bool chunked=false);
 	~CellBuffer();
 
+	/// Use text from a mapped file for an empty buffer. Takes ownership of mappedText_.
+	void SetMapped(IMappedText *mappedText_);
+	bool IsMapped() const { return mapped != 0; }
+	bool IsChunked() const { return substance.IsChunked(); }
+
 	/// Retrieving positions outside the range of the buffer works and returns 0
 	char CharAt(int position) const;
 	void GetCharRange(char *buffer, int position, int lengthRetrieve) const;
 	char StyleAt(int position) const;
 	void GetStyleRange(unsigned char *buffer, int position, int lengthRetrieve) const;
+	/// Copies mapped text into memory so that a NUL can terminate the text.
 	const char *BufferPointer();
 	const char *RangePointer(int position, int rangeLength);
 	int GapPosition() const;
+	/// Text from position up to the gap without moving anything, setting rangeLength to its length.
+	const char *ContiguousRange(int position, int &rangeLength) const;
 
 	int Length() const;
 	void Allocate(int newSize);
@@ -190,6 +342,7 @@ public:
 	/// @return true if the style of a character is changed.
 	bool SetStyleAt(int position, char styleValue);
 	bool SetStyleFor(int position, int length, char styleValue);
+	bool SetStyles(int position, int length, const char *styles, int &firstChanged, int &lastChanged);
 
 	const char *DeleteChars(int position, int deleteLength, bool &startSequence);
 
@@ -212,6 +365,9 @@ public:
 	void EndUndoAction();
 	void AddUndoAction(int token, bool mayCoalesce);
 	void DeleteUndoHistory();
+	int UndoMemory() const;
+	void SetUndoMemoryLimit(int memoryLimit);
+	int GetUndoMemoryLimit() const;
 
 	/// To perform an undo, StartUndo is called to retrieve the number of steps, then UndoStep is
 	/// called that many times. Similarly for redo.
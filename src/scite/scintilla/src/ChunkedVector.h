@@ -0,0 +1,257 @@
+// Scintilla source code edit control
+/** @file ChunkedVector.h
+ ** Array held as a sequence of gap buffered chunks so that insertions and
+ ** deletions scattered through very large arrays stay cheap.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef CHUNKEDVECTOR_H
+#define CHUNKEDVECTOR_H
+
+#ifdef SCI_NAMESPACE
+namespace Scintilla {
+#endif
+
+/**
+ * Each chunk is a SplitVector so an edit only moves the gap of one chunk
+ * instead of moving the gap through the whole array.
+ * Chunks are split when they grow past twice chunkSize and neighbours are
+ * merged when both fit in chunkSize. Only a sole chunk may be empty.
+ * Requests for a contiguous range join the chunks it spans.
+ */
+template <typename T>
+class ChunkedVector {
+	enum { chunkSize = 0x10000 };
+	typedef SplitVector<T> Chunk;
+	SplitVector<Chunk *> chunks;
+	/// Partition n is the range of chunk n.
+	Partitioning starts;
+	/// Most accesses are near the previous one so remember its chunk.
+	mutable int chunkLast;
+
+	int Chunks() const {
+		return chunks.Length();
+	}
+	int ChunkStart(int chunk) const {
+		return starts.PositionFromPartition(chunk);
+	}
+	int ChunkFromPosition(int position) const {
+		if ((chunkLast < Chunks()) && (position >= ChunkStart(chunkLast)) && (position < ChunkStart(chunkLast + 1)))
+			return chunkLast;
+		chunkLast = starts.PartitionFromPosition(position);
+		return chunkLast;
+	}
+	static Chunk *NewChunk(int length) {
+		Chunk *chunk = new Chunk();
+		chunk->ReAllocate(length + chunkSize / 8);
+		return chunk;
+	}
+	/// Break a chunk that has grown too large into pieces of chunkSize.
+	/// The pieces are new allocations so a large joined chunk releases its memory.
+	void SplitChunk(int chunk) {
+		Chunk *whole = chunks[chunk];
+		const int lengthWhole = whole->Length();
+		if (lengthWhole <= 2 * chunkSize)
+			return;
+		const int start = ChunkStart(chunk);
+		const T *text = whole->RangePointer(0, lengthWhole);
+		int piece = chunk;
+		for (int offset = 0; offset < lengthWhole; offset += chunkSize) {
+			const int lengthPiece = std::min(static_cast<int>(chunkSize), lengthWhole - offset);
+			Chunk *pieceChunk = NewChunk(lengthPiece);
+			pieceChunk->InsertFromArray(0, text + offset, 0, lengthPiece);
+			if (offset == 0) {
+				chunks.SetValueAt(piece, pieceChunk);
+			} else {
+				chunks.Insert(piece, pieceChunk);
+				starts.InsertPartition(piece, start + offset);
+			}
+			piece++;
+		}
+		delete whole;
+	}
+	/// Append the contents of chunks (first, last] to chunk first.
+	void JoinChunks(int first, int last) {
+		if (first >= last)
+			return;
+		Chunk *joined = chunks[first];
+		joined->ReAllocate(ChunkStart(last + 1) - ChunkStart(first) + 1);
+		for (int chunk = first + 1; chunk <= last; chunk++) {
+			Chunk *next = chunks[first + 1];
+			const int lengthNext = next->Length();
+			if (lengthNext > 0)
+				joined->InsertFromArray(joined->Length(), next->RangePointer(0, lengthNext), 0, lengthNext);
+			delete next;
+			chunks.Delete(first + 1);
+			starts.RemovePartition(first + 1);
+		}
+	}
+	void RemoveChunk(int chunk) {
+		delete chunks[chunk];
+		chunks.Delete(chunk);
+		// Chunk 0 always starts at 0 so remove the start of the following chunk which is also 0
+		starts.RemovePartition((chunk == 0) ? 1 : chunk);
+	}
+	/// Merge a chunk with its neighbours when they are small enough together.
+	void MergeAround(int chunk) {
+		if ((chunk + 1 < Chunks()) &&
+			(chunks[chunk]->Length() + chunks[chunk + 1]->Length() <= chunkSize)) {
+			JoinChunks(chunk, chunk + 1);
+		}
+		if ((chunk > 0) && (chunk < Chunks()) &&
+			(chunks[chunk - 1]->Length() + chunks[chunk]->Length() <= chunkSize)) {
+			JoinChunks(chunk - 1, chunk);
+		}
+	}
+
+	// Private so ChunkedVector objects can not be copied
+	ChunkedVector(const ChunkedVector &);
+	ChunkedVector &operator=(const ChunkedVector &);
+
+public:
+	ChunkedVector() : starts(8), chunkLast(0) {
+		chunks.Insert(0, NewChunk(0));
+	}
+
+	~ChunkedVector() {
+		for (int chunk = 0; chunk < Chunks(); chunk++)
+			delete chunks[chunk];
+	}
+
+	/// Retrieving positions outside the range of the array works and returns 0
+	T ValueAt(int position) const {
+		if ((position < 0) || (position >= Length()))
+			return 0;
+		const int chunk = ChunkFromPosition(position);
+		return chunks[chunk]->ValueAt(position - ChunkStart(chunk));
+	}
+
+	void SetValueAt(int position, T v) {
+		if ((position < 0) || (position >= Length()))
+			return;
+		const int chunk = ChunkFromPosition(position);
+		chunks[chunk]->SetValueAt(position - ChunkStart(chunk), v);
+	}
+
+	int Length() const {
+		return ChunkStart(Chunks());
+	}
+
+	/// Chunks are allocated as needed so there is nothing to do in advance.
+	void ReAllocate(int) {
+	}
+
+	/// Insert text from an array in pieces no longer than a chunk.
+	void InsertFromArray(int positionToInsert, const T *s, int positionFrom, int insertLength) {
+		PLATFORM_ASSERT((positionToInsert >= 0) && (positionToInsert <= Length()));
+		if ((positionToInsert < 0) || (positionToInsert > Length()))
+			return;
+		while (insertLength > 0) {
+			const int lengthPiece = std::min(static_cast<int>(chunkSize), insertLength);
+			const int chunk = ChunkFromPosition(positionToInsert);
+			chunks[chunk]->InsertFromArray(positionToInsert - ChunkStart(chunk), s, positionFrom, lengthPiece);
+			starts.InsertText(chunk, lengthPiece);
+			SplitChunk(chunk);
+			positionToInsert += lengthPiece;
+			positionFrom += lengthPiece;
+			insertLength -= lengthPiece;
+		}
+	}
+
+	/// Insert a number of elements all set to v.
+	void InsertValue(int position, int insertLength, T v) {
+		PLATFORM_ASSERT((position >= 0) && (position <= Length()));
+		if ((position < 0) || (position > Length()))
+			return;
+		while (insertLength > 0) {
+			const int lengthPiece = std::min(static_cast<int>(chunkSize), insertLength);
+			const int chunk = ChunkFromPosition(position);
+			chunks[chunk]->InsertValue(position - ChunkStart(chunk), lengthPiece, v);
+			starts.InsertText(chunk, lengthPiece);
+			SplitChunk(chunk);
+			position += lengthPiece;
+			insertLength -= lengthPiece;
+		}
+	}
+
+	void DeleteRange(int position, int deleteLength) {
+		PLATFORM_ASSERT((position >= 0) && (position + deleteLength <= Length()));
+		if ((position < 0) || ((position + deleteLength) > Length()))
+			return;
+		if ((position == 0) && (deleteLength == Length())) {
+			DeleteAll();
+			return;
+		}
+		int chunk = 0;
+		while (deleteLength > 0) {
+			chunk = ChunkFromPosition(position);
+			const int offset = position - ChunkStart(chunk);
+			const int lengthTake = std::min(deleteLength, chunks[chunk]->Length() - offset);
+			chunks[chunk]->DeleteRange(offset, lengthTake);
+			starts.InsertText(chunk, -lengthTake);
+			deleteLength -= lengthTake;
+			if ((chunks[chunk]->Length() == 0) && (Chunks() > 1))
+				RemoveChunk(chunk);
+		}
+		MergeAround(std::min(chunk, Chunks() - 1));
+	}
+
+	void DeleteAll() {
+		for (int chunk = 0; chunk < Chunks(); chunk++)
+			delete chunks[chunk];
+		chunks.DeleteAll();
+		chunks.Insert(0, NewChunk(0));
+		starts.DeleteAll();
+		chunkLast = 0;
+	}
+
+	/// Retrieve a range of elements into an array
+	void GetRange(T *buffer, int position, int retrieveLength) const {
+		PLATFORM_ASSERT((position >= 0) && (position + retrieveLength <= Length()));
+		while (retrieveLength > 0) {
+			const int chunk = ChunkFromPosition(position);
+			const int offset = position - ChunkStart(chunk);
+			const int lengthTake = std::min(retrieveLength, chunks[chunk]->Length() - offset);
+			if (lengthTake <= 0)
+				break;
+			chunks[chunk]->GetRange(buffer, offset, lengthTake);
+			buffer += lengthTake;
+			position += lengthTake;
+			retrieveLength -= lengthTake;
+		}
+	}
+
+	/// Join every chunk into one so the whole array is contiguous.
+	T *BufferPointer() {
+		JoinChunks(0, Chunks() - 1);
+		chunkLast = 0;
+		return chunks[0]->BufferPointer();
+	}
+
+	/// Return a pointer to a range of elements, first joining the chunks
+	/// the range spans when it is not within one chunk.
+	T *RangePointer(int position, int rangeLength) {
+		const int chunk = ChunkFromPosition(position);
+		if ((rangeLength > 0) && (position + rangeLength > ChunkStart(chunk + 1)))
+			JoinChunks(chunk, ChunkFromPosition(position + rangeLength - 1));
+		return chunks[chunk]->RangePointer(position - ChunkStart(chunk), rangeLength);
+	}
+
+	/// Elements before this position are contiguous.
+	int GapPosition() const {
+		return chunks[0]->GapPosition();
+	}
+
+	/// Return the elements from position that are contiguous without joining or moving
+	/// anything and set rangeLength to how many there are.
+	T *ContiguousRange(int position, int &rangeLength) const {
+		const int chunk = ChunkFromPosition(position);
+		return chunks[chunk]->ContiguousRange(position - ChunkStart(chunk), rangeLength);
+	}
+};
+
+#ifdef SCI_NAMESPACE
+}
+#endif
+
+#endif
@@ -29,6 +29,7 @@
 #include "Position.h"
 #include "SplitVector.h"
 #include "Partitioning.h"
+#include "ChunkedVector.h"
 #include "RunStyles.h"
 #include "CellBuffer.h"
 #include "PerLine.h"
@@ -49,6 +50,7 @@ static inline bool IsPunctuation(char ch) {
 }
 
 void LexInterface::Colourise(int start, int end) {
+	FinishBackground();
 	if (pdoc && instance && !performingStyle) {
 		// Protect against reentrance, which may occur, for example, when
 		// fold points are discovered while performing styling and the folding
@@ -68,7 +70,8 @@ void LexInterface::Colourise(int start, int end) {
 			styleStart = pdoc->StyleAt(start - 1);
 
 		if (len > 0) {
-			instance->Lex(start, len, styleStart, pdoc);
+			if (!LexInParallel(start, end, styleStart))
+				instance->Lex(start, len, styleStart, pdoc);
 			instance->Fold(start, len, styleStart, pdoc);
 		}
 
@@ -87,7 +90,703 @@ int LexInterface::LineEndTypesSupported() {
 	return 0;
 }
 
-Document::Document() {
+static int NextTab(int pos, int tabSize) {
+	return ((pos / tabSize) + 1) * tabSize;
+}
+
+#ifdef SCI_NAMESPACE
+namespace Scintilla {
+#endif
+
+/**
+ * Copy of the text, styles and line data around a range of a document so that a lexer can
+ * run on a background thread. The lexer's changes are collected and committed to the document
+ * on the GUI thread. Lexers that reach outside the copy set strayed and their results are
+ * discarded. Only single byte and UTF-8 documents are copied.
+ */
+class LexSnapshot : public IDocumentWithContiguousRange {
+	struct DecorationFill {
+		int indicator;
+		int position;
+		int value;
+		int fillLength;
+		DecorationFill(int indicator_, int position_, int value_, int fillLength_) :
+			indicator(indicator_), position(position_), value(value_), fillLength(fillLength_) {
+		}
+	};
+	int dbcsCodePage;
+	int tabInChars;
+	int lengthDocument;
+	int linesTotal;
+	int start;
+	int end;
+	int initStyle;
+	int endStyledDocument;	///< Document's end styled when copied, may be within the line of start
+	int textStart;
+	int lineFirst;
+	int styleFloor;	///< Styles before here are not known
+	int lineStateFloor;	///< Line states before this line are not known
+	std::vector<char> text;
+	std::vector<char> styles;
+	std::vector<int> lineStarts;	///< One more than lines so the end of the last line is known
+	std::vector<int> lineEnds;
+	std::vector<int> lineStates;
+	std::vector<int> levels;
+
+	// Written by the lexer
+	mutable bool strayed;
+	int endStyled;
+	int styledStart;
+	int lineStateFirst;
+	int lineStateLast;
+	int levelFirst;
+	int levelLast;
+	int currentIndicator;
+	std::vector<DecorationFill> fills;
+	int lexerStateStart;
+	int lexerStateEnd;
+	std::vector<int> errors;
+
+	// Only used on the GUI thread
+	int validEnd;
+
+	int TextEnd() const {
+		return textStart + static_cast<int>(text.size());
+	}
+	int Lines() const {
+		return static_cast<int>(lineEnds.size());
+	}
+	bool InLines(int line) const {
+		return (line >= lineFirst) && (line < lineFirst + Lines());
+	}
+	char CharAt(int position) const {
+		if ((position < 0) || (position >= lengthDocument))
+			return 0;
+		if ((position < textStart) || (position >= TextEnd())) {
+			strayed = true;
+			return 0;
+		}
+		return text[position - textStart];
+	}
+	int NextPosition(int pos, int moveDir) const;
+	// Private so LexSnapshot objects can not be copied
+	LexSnapshot(const LexSnapshot &);
+public:
+	LexSnapshot(Document *pdoc, int start_, int end_);
+	virtual ~LexSnapshot() {
+	}
+	void Lex(ILexer *instance, bool fold=true);
+	void AssumeCleanStart(int lineState);
+	bool CleanStart(const Document *pdoc) const;
+	void Invalidate(const Document *pdoc, int position);
+	bool Commit(Document *pdoc) const;
+	bool Strayed() const {
+		return strayed;
+	}
+
+	int SCI_METHOD Version() const {
+		return dvContiguousRange;
+	}
+	void SCI_METHOD SetErrorStatus(int status) {
+		errors.push_back(status);
+	}
+	Sci_Position SCI_METHOD Length() const {
+		return lengthDocument;
+	}
+	void SCI_METHOD GetCharRange(char *buffer, Sci_Position position, Sci_Position lengthRetrieve) const;
+	char SCI_METHOD StyleAt(Sci_Position position) const;
+	Sci_Position SCI_METHOD LineFromPosition(Sci_Position position) const;
+	Sci_Position SCI_METHOD LineStart(Sci_Position line) const;
+	int SCI_METHOD GetLevel(Sci_Position line) const;
+	int SCI_METHOD SetLevel(Sci_Position line, int level);
+	int SCI_METHOD GetLineState(Sci_Position line) const;
+	int SCI_METHOD SetLineState(Sci_Position line, int state);
+	void SCI_METHOD StartStyling(Sci_Position position, char mask);
+	bool SCI_METHOD SetStyleFor(Sci_Position length, char style);
+	bool SCI_METHOD SetStyles(Sci_Position length, const char *styles);
+	void SCI_METHOD DecorationSetCurrentIndicator(int indicator) {
+		currentIndicator = indicator;
+	}
+	void SCI_METHOD DecorationFillRange(Sci_Position position, int value, Sci_Position fillLength) {
+		fills.push_back(DecorationFill(currentIndicator, position, value, fillLength));
+	}
+	void SCI_METHOD ChangeLexerState(Sci_Position start_, Sci_Position end_);
+	int SCI_METHOD CodePage() const {
+		return dbcsCodePage;
+	}
+	bool SCI_METHOD IsDBCSLeadByte(char) const {
+		return false;
+	}
+	const char * SCI_METHOD BufferPointer();
+	int SCI_METHOD GetLineIndentation(Sci_Position line);
+	Sci_Position SCI_METHOD LineEnd(Sci_Position line) const;
+	Sci_Position SCI_METHOD GetRelativePosition(Sci_Position positionStart, Sci_Position characterOffset) const;
+	int SCI_METHOD GetCharacterAndWidth(Sci_Position position, Sci_Position *pWidth) const;
+	const char * SCI_METHOD ContiguousRange(Sci_Position position, Sci_Position *rangeLength) const {
+		// Text outside the copy is left to GetCharRange which notices the lexer straying
+		if ((position < textStart) || (position >= TextEnd())) {
+			*rangeLength = 0;
+			return 0;
+		}
+		*rangeLength = TextEnd() - position;
+		return &text[position - textStart];
+	}
+};
+
+/**
+ * A range of a document being lexed on its own thread while others are lexed.
+ */
+struct LexChunk {
+	LexSnapshot *snapshot;
+	ILexer *instance;
+	BackgroundThread *thread;
+	LexChunk() : snapshot(0), instance(0), thread(0) {
+	}
+};
+
+#ifdef SCI_NAMESPACE
+}
+#endif
+
+LexSnapshot::LexSnapshot(Document *pdoc, int start_, int end_) :
+	dbcsCodePage(pdoc->dbcsCodePage), tabInChars(pdoc->tabInChars),
+	lengthDocument(pdoc->Length()), linesTotal(pdoc->LinesTotal()),
+	start(start_), end(end_), initStyle(0), endStyledDocument(pdoc->GetEndStyled()), textStart(0), lineFirst(0),
+	styleFloor(0), lineStateFloor(0),
+	strayed(false), endStyled(start_), styledStart(start_),
+	lineStateFirst(INVALID_POSITION), lineStateLast(INVALID_POSITION),
+	levelFirst(INVALID_POSITION), levelLast(INVALID_POSITION), currentIndicator(0),
+	lexerStateStart(INVALID_POSITION), lexerStateEnd(INVALID_POSITION), validEnd(0) {
+	if (start > 0)
+		initStyle = pdoc->StyleAt(start - 1);
+	// Lexers may back up to a safe restart point or read ahead so copy some context
+	// on each side of the range being lexed.
+	lineFirst = pdoc->LineFromPosition(std::max(0, start - LexInterface::contextBytes));
+	textStart = pdoc->LineStart(lineFirst);
+	const int textEnd = std::min(end + LexInterface::contextBytes, lengthDocument);
+	text.resize(textEnd - textStart);
+	styles.resize(textEnd - textStart);
+	if (!text.empty()) {
+		pdoc->GetCharRange(&text[0], textStart, textEnd - textStart);
+		pdoc->GetStyleRange(reinterpret_cast<unsigned char *>(&styles[0]), textStart, textEnd - textStart);
+	}
+	const int lineLast = pdoc->LineFromPosition(textEnd);
+	for (int line = lineFirst; line <= lineLast; line++) {
+		lineStarts.push_back(pdoc->LineStart(line));
+		lineEnds.push_back(pdoc->LineEnd(line));
+		lineStates.push_back(pdoc->GetLineState(line));
+		levels.push_back(pdoc->GetLevel(line));
+	}
+	lineStarts.push_back(pdoc->LineStart(lineLast + 1));
+	styleFloor = textStart;
+	lineStateFloor = lineFirst;
+	validEnd = textEnd;
+}
+
+void LexSnapshot::Lex(ILexer *instance, bool fold) {
+	const int len = end - start;
+	instance->Lex(start, len, initStyle, this);
+	if (fold)
+		instance->Fold(start, len, initStyle, this);
+}
+
+// Lex as if the previous line ended in the default state with the given line state, as is
+// common after a blank line, without knowing what came before. Lexers that look further back stray.
+void LexSnapshot::AssumeCleanStart(int lineState) {
+	const int lineBefore = static_cast<int>(LineFromPosition(start)) - 1;
+	styleFloor = lineStarts[lineBefore - lineFirst];
+	lineStateFloor = lineBefore;
+	std::fill(styles.begin() + (styleFloor - textStart), styles.begin() + (start - textStart), 0);
+	lineStates[lineBefore - lineFirst] = lineState;
+	initStyle = 0;
+	// The preceding range is styled before this is committed
+	endStyledDocument = start;
+}
+
+// Once the document is styled up to start, check that AssumeCleanStart guessed right.
+bool LexSnapshot::CleanStart(const Document *pdoc) const {
+	if (pdoc->GetLineState(lineStateFloor) != lineStates[lineStateFloor - lineFirst])
+		return false;
+	for (int position = styleFloor; position < start; position++) {
+		if (pdoc->StyleAt(position) != 0)
+			return false;
+	}
+	return true;
+}
+
+void LexSnapshot::Invalidate(const Document *pdoc, int position) {
+	// The first line changed and all after it may now lex differently
+	if (position < validEnd) {
+		validEnd = std::min(validEnd, static_cast<int>(pdoc->LineStart(pdoc->LineFromPosition(position))));
+	}
+}
+
+bool LexSnapshot::Commit(Document *pdoc) const {
+	// Any other styling since the copy was made means the results may no longer fit
+	if (strayed || (pdoc->GetEndStyled() != endStyledDocument))
+		return false;
+	const int styledEnd = std::min(endStyled, validEnd);
+	if (styledEnd <= start)
+		return false;
+	// Lines starting at or after validEnd may have been changed or moved
+	const int lineLimit = (validEnd >= TextEnd()) ? (lineFirst + Lines()) :
+		static_cast<int>(LineFromPosition(validEnd));
+
+	pdoc->StartStyling(styledStart, '\377');
+	pdoc->SetStyles(styledEnd - styledStart, &styles[styledStart - textStart]);
+	if (lineStateFirst >= 0) {
+		for (int line = lineStateFirst; (line <= lineStateLast) && (line < lineLimit); line++)
+			pdoc->SetLineState(line, lineStates[line - lineFirst]);
+	}
+	if (levelFirst >= 0) {
+		for (int line = levelFirst; (line <= levelLast) && (line < lineLimit); line++)
+			pdoc->SetLevel(line, levels[line - lineFirst]);
+	}
+	for (std::vector<DecorationFill>::const_iterator it = fills.begin(); it != fills.end(); ++it) {
+		if (it->position < validEnd) {
+			pdoc->DecorationSetCurrentIndicator(it->indicator);
+			pdoc->DecorationFillRange(it->position, it->value, std::min(it->fillLength, validEnd - it->position));
+		}
+	}
+	if ((lexerStateStart >= 0) && (lexerStateStart < validEnd)) {
+		pdoc->ChangeLexerState(lexerStateStart, std::min(lexerStateEnd, validEnd));
+	}
+	for (std::vector<int>::const_iterator itError = errors.begin(); itError != errors.end(); ++itError) {
+		pdoc->SetErrorStatus(*itError);
+	}
+	return true;
+}
+
+void SCI_METHOD LexSnapshot::GetCharRange(char *buffer, Sci_Position position, Sci_Position lengthRetrieve) const {
+	if ((position >= textStart) && (position + lengthRetrieve <= TextEnd())) {
+		if (lengthRetrieve > 0)
+			memcpy(buffer, &text[position - textStart], lengthRetrieve);
+	} else {
+		for (Sci_Position i = 0; i < lengthRetrieve; i++)
+			buffer[i] = CharAt(static_cast<int>(position + i));
+	}
+}
+
+char SCI_METHOD LexSnapshot::StyleAt(Sci_Position position) const {
+	if ((position < 0) || (position >= lengthDocument))
+		return 0;
+	if ((position < styleFloor) || (position >= TextEnd())) {
+		strayed = true;
+		return 0;
+	}
+	return styles[position - textStart];
+}
+
+Sci_Position SCI_METHOD LexSnapshot::LineFromPosition(Sci_Position position) const {
+	if (position < textStart) {
+		strayed = true;
+		return (position <= 0) ? 0 : lineFirst;
+	}
+	if (position >= lengthDocument) {
+		// StyleContext finds the last line of the document this way
+		return linesTotal - 1;
+	}
+	if (position >= lineStarts.back()) {
+		strayed = true;
+		return lineFirst + Lines() - 1;
+	}
+	std::vector<int>::const_iterator it = std::upper_bound(lineStarts.begin(), lineStarts.end(), position);
+	return lineFirst + static_cast<int>(it - lineStarts.begin()) - 1;
+}
+
+Sci_Position SCI_METHOD LexSnapshot::LineStart(Sci_Position line) const {
+	if (line < 0)
+		return 0;
+	if (line >= linesTotal)
+		return lengthDocument;
+	if ((line < lineFirst) || (line > lineFirst + Lines())) {
+		strayed = true;
+		return textStart;
+	}
+	return lineStarts[line - lineFirst];
+}
+
+Sci_Position SCI_METHOD LexSnapshot::LineEnd(Sci_Position line) const {
+	if (line >= linesTotal - 1)
+		return LineStart(line + 1);
+	if (!InLines(static_cast<int>(line))) {
+		strayed = true;
+		return textStart;
+	}
+	return lineEnds[line - lineFirst];
+}
+
+int SCI_METHOD LexSnapshot::GetLevel(Sci_Position line) const {
+	if ((line < 0) || (line >= linesTotal))
+		return SC_FOLDLEVELBASE;
+	if (!InLines(static_cast<int>(line))) {
+		strayed = true;
+		return SC_FOLDLEVELBASE;
+	}
+	return levels[line - lineFirst];
+}
+
+int SCI_METHOD LexSnapshot::SetLevel(Sci_Position line, int level) {
+	if ((line < 0) || (line >= linesTotal))
+		return SC_FOLDLEVELBASE;
+	if (!InLines(static_cast<int>(line))) {
+		strayed = true;
+		return SC_FOLDLEVELBASE;
+	}
+	const int lineSet = static_cast<int>(line);
+	if (levelFirst < 0) {
+		levelFirst = lineSet;
+		levelLast = lineSet;
+	}
+	levelFirst = std::min(levelFirst, lineSet);
+	levelLast = std::max(levelLast, lineSet);
+	const int prev = levels[lineSet - lineFirst];
+	levels[lineSet - lineFirst] = level;
+	return prev;
+}
+
+int SCI_METHOD LexSnapshot::GetLineState(Sci_Position line) const {
+	if ((line < 0) || (line >= linesTotal))
+		return 0;
+	if (!InLines(static_cast<int>(line)) || (line < lineStateFloor)) {
+		strayed = true;
+		return 0;
+	}
+	return lineStates[line - lineFirst];
+}
+
+int SCI_METHOD LexSnapshot::SetLineState(Sci_Position line, int state) {
+	if ((line < 0) || (line >= linesTotal))
+		return 0;
+	if (!InLines(static_cast<int>(line))) {
+		strayed = true;
+		return 0;
+	}
+	const int lineSet = static_cast<int>(line);
+	if (lineStateFirst < 0) {
+		lineStateFirst = lineSet;
+		lineStateLast = lineSet;
+	}
+	lineStateFirst = std::min(lineStateFirst, lineSet);
+	lineStateLast = std::max(lineStateLast, lineSet);
+	const int statePrevious = lineStates[lineSet - lineFirst];
+	lineStates[lineSet - lineFirst] = state;
+	return statePrevious;
+}
+
+void SCI_METHOD LexSnapshot::StartStyling(Sci_Position position, char) {
+	if ((position < textStart) || (position > TextEnd())) {
+		strayed = true;
+		endStyled = textStart;
+	} else {
+		endStyled = static_cast<int>(position);
+		styledStart = std::min(styledStart, endStyled);
+	}
+}
+
+bool SCI_METHOD LexSnapshot::SetStyleFor(Sci_Position length, char style) {
+	if ((length < 0) || (endStyled + length > TextEnd())) {
+		strayed = true;
+		return false;
+	}
+	std::fill(styles.begin() + (endStyled - textStart), styles.begin() + (endStyled - textStart + length), style);
+	endStyled += static_cast<int>(length);
+	return true;
+}
+
+bool SCI_METHOD LexSnapshot::SetStyles(Sci_Position length, const char *styles_) {
+	if ((length < 0) || (endStyled + length > TextEnd())) {
+		strayed = true;
+		return false;
+	}
+	std::copy(styles_, styles_ + length, styles.begin() + (endStyled - textStart));
+	endStyled += static_cast<int>(length);
+	return true;
+}
+
+void SCI_METHOD LexSnapshot::ChangeLexerState(Sci_Position start_, Sci_Position end_) {
+	if (lexerStateStart < 0) {
+		lexerStateStart = static_cast<int>(start_);
+		lexerStateEnd = static_cast<int>(end_);
+	}
+	lexerStateStart = std::min(lexerStateStart, static_cast<int>(start_));
+	lexerStateEnd = std::max(lexerStateEnd, static_cast<int>(end_));
+}
+
+const char * SCI_METHOD LexSnapshot::BufferPointer() {
+	// Only the whole document is a valid buffer
+	if ((textStart == 0) && (TextEnd() == lengthDocument) && !text.empty())
+		return &text[0];
+	strayed = true;
+	return 0;
+}
+
+int SCI_METHOD LexSnapshot::GetLineIndentation(Sci_Position line) {
+	int indent = 0;
+	if ((line >= 0) && (line < linesTotal)) {
+		for (int i = static_cast<int>(LineStart(line)); i < lengthDocument; i++) {
+			const char ch = CharAt(i);
+			if (ch == ' ')
+				indent++;
+			else if (ch == '\t')
+				indent = NextTab(indent, tabInChars);
+			else
+				return indent;
+		}
+	}
+	return indent;
+}
+
+int LexSnapshot::NextPosition(int pos, int moveDir) const {
+	// Same as Document::NextPosition for single byte and UTF-8 documents
+	const int increment = (moveDir > 0) ? 1 : -1;
+	if (pos + increment <= 0)
+		return 0;
+	if (pos + increment >= lengthDocument)
+		return lengthDocument;
+	if (SC_CP_UTF8 != dbcsCodePage)
+		return pos + increment;
+	if (increment == 1) {
+		const unsigned char leadByte = static_cast<unsigned char>(CharAt(pos));
+		if (UTF8IsAscii(leadByte))
+			return pos + 1;
+		const int widthCharBytes = UTF8BytesOfLead[leadByte];
+		unsigned char charBytes[UTF8MaxBytes] = {leadByte,0,0,0};
+		for (int b=1; b<widthCharBytes; b++)
+			charBytes[b] = static_cast<unsigned char>(CharAt(pos+b));
+		const int utf8status = UTF8Classify(charBytes, widthCharBytes);
+		return pos + ((utf8status & UTF8MaskInvalid) ? 1 : (utf8status & UTF8MaskWidth));
+	}
+	pos--;
+	if (UTF8IsTrailByte(static_cast<unsigned char>(CharAt(pos)))) {
+		// Move to the lead byte if pos is inside a valid character
+		int lead = pos;
+		while ((lead > 0) && (pos - lead < UTF8MaxBytes) && UTF8IsTrailByte(static_cast<unsigned char>(CharAt(lead-1))))
+			lead--;
+		lead = (lead > 0) ? lead - 1 : lead;
+		const unsigned char leadByte = static_cast<unsigned char>(CharAt(lead));
+		const int widthCharBytes = UTF8BytesOfLead[leadByte];
+		if ((widthCharBytes > 1) && (pos - lead < widthCharBytes)) {
+			unsigned char charBytes[UTF8MaxBytes] = {leadByte,0,0,0};
+			for (int b=1; b<widthCharBytes && ((lead+b) < lengthDocument); b++)
+				charBytes[b] = static_cast<unsigned char>(CharAt(lead+b));
+			if (!(UTF8Classify(charBytes, widthCharBytes) & UTF8MaskInvalid))
+				pos = lead;
+		}
+	}
+	return pos;
+}
+
+Sci_Position SCI_METHOD LexSnapshot::GetRelativePosition(Sci_Position positionStart, Sci_Position characterOffset) const {
+	int pos = static_cast<int>(positionStart);
+	if (dbcsCodePage) {
+		const int increment = (characterOffset > 0) ? 1 : -1;
+		while (characterOffset != 0) {
+			const int posNext = NextPosition(pos, increment);
+			if (posNext == pos)
+				return INVALID_POSITION;
+			pos = posNext;
+			characterOffset -= increment;
+		}
+	} else {
+		pos = static_cast<int>(positionStart + characterOffset);
+		if ((pos < 0) || (pos > lengthDocument))
+			return INVALID_POSITION;
+	}
+	return pos;
+}
+
+int SCI_METHOD LexSnapshot::GetCharacterAndWidth(Sci_Position position, Sci_Position *pWidth) const {
+	int character;
+	int bytesInCharacter = 1;
+	const unsigned char leadByte = static_cast<unsigned char>(CharAt(static_cast<int>(position)));
+	if ((SC_CP_UTF8 == dbcsCodePage) && !UTF8IsAscii(leadByte)) {
+		const int widthCharBytes = UTF8BytesOfLead[leadByte];
+		unsigned char charBytes[UTF8MaxBytes] = {leadByte,0,0,0};
+		for (int b=1; b<widthCharBytes; b++)
+			charBytes[b] = static_cast<unsigned char>(CharAt(static_cast<int>(position+b)));
+		const int utf8status = UTF8Classify(charBytes, widthCharBytes);
+		if (utf8status & UTF8MaskInvalid) {
+			// Report as singleton surrogate values which are invalid Unicode
+			character =  0xDC80 + leadByte;
+		} else {
+			bytesInCharacter = utf8status & UTF8MaskWidth;
+			character = UnicodeFromUTF8(charBytes);
+		}
+	} else if (dbcsCodePage) {
+		character = leadByte;
+	} else {
+		character = CharAt(static_cast<int>(position));
+	}
+	if (pWidth) {
+		*pWidth = bytesInCharacter;
+	}
+	return character;
+}
+
+LexInterface::~LexInterface() {
+	AbandonBackground();
+	delete lexed;
+	lexed = 0;
+}
+
+void LexInterface::LexProcedure(void *argument) {
+	LexInterface *li = static_cast<LexInterface *>(argument);
+	li->snapshot->Lex(li->instance);
+	li->lexed->Set();
+}
+
+// Wait for the background thread to finish with the lexer then discard what it found.
+// Called before the lexer is changed, released or has its properties set so a lexer that
+// strayed before is given another try.
+void LexInterface::AbandonBackground() {
+	delete thread;
+	thread = 0;
+	if (lexed)
+		lexed->Wait(0);
+	delete snapshot;
+	snapshot = 0;
+	strays = false;
+}
+
+// Wait for any lexing on the background thread then commit what is still valid.
+// Returns false if results were discarded.
+bool LexInterface::FinishBackground() {
+	bool committed = true;
+	if (snapshot && !performingStyle) {
+		delete thread;
+		thread = 0;
+		lexed->Wait(0);
+		LexSnapshot *snapshotLexed = snapshot;
+		snapshot = 0;
+		// Committing notifies watchers which may ask for more styling
+		performingStyle = true;
+		committed = snapshotLexed->Commit(pdoc);
+		performingStyle = false;
+		if (snapshotLexed->Strayed())
+			strays = true;
+		delete snapshotLexed;
+	}
+	return committed;
+}
+
+// Continue lexing towards pos on a background thread, committing results as each range
+// finishes. Returns false when nothing is being lexed in the background so the caller
+// should style any remainder itself.
+bool LexInterface::StyleInBackground(int pos) {
+	if (!pdoc || !instance || performingStyle)
+		return false;
+	if (snapshot) {
+		// Briefly wait so idle processing does not spin while the thread works
+		if (!lexed->Wait(5))
+			return true;
+		const int endStyledBefore = pdoc->GetEndStyled();
+		// Rather than lex again from where results were just discarded, let the caller style
+		if (!FinishBackground() && (pdoc->GetEndStyled() == endStyledBefore))
+			return false;
+	}
+	const int endStyled = pdoc->GetEndStyled();
+	if (!threadsAvailable || strays || (endStyled >= pos) ||
+		(pdoc->dbcsCodePage && (pdoc->dbcsCodePage != SC_CP_UTF8))) {
+		return false;
+	}
+	const int start = pdoc->LineStart(pdoc->LineFromPosition(endStyled));
+	const int end = std::min(pos, static_cast<int>(pdoc->LineStart(pdoc->LineFromPosition(start + backgroundBytes) + 1)));
+	if (!lexed)
+		lexed = BackgroundEvent::Allocate();
+	snapshot = new LexSnapshot(pdoc, start, end);
+	thread = BackgroundThread::Start(LexProcedure, this);
+	if (!thread) {
+		threadsAvailable = false;
+		delete snapshot;
+		snapshot = 0;
+		return false;
+	}
+	return true;
+}
+
+// Text at pos has changed so background results from its line onwards are stale.
+void LexInterface::InvalidateBackground(int pos) {
+	if (snapshot)
+		snapshot->Invalidate(pdoc, pos);
+}
+
+static void LexChunkProcedure(void *argument) {
+	LexChunk *chunk = static_cast<LexChunk *>(argument);
+	chunk->snapshot->Lex(chunk->instance, false);
+}
+
+// Find the start of a line following a blank line soon after pos as a likely place
+// for the lexer to be in its default state. Returns -1 if there is none.
+int LexInterface::CleanLineStart(int pos, int limit) const {
+	limit = std::min(limit, pos + contextBytes);
+	for (int line = pdoc->LineFromPosition(pos) + 1; pdoc->LineStart(line + 1) < limit; line++) {
+		if (pdoc->GetLineIndentPosition(line) == pdoc->LineEnd(line))
+			return pdoc->LineStart(line + 1);
+	}
+	return -1;
+}
+
+// Lex a large range as several chunks on separate threads. The first chunk continues from the
+// document's styles while the others start after blank lines and assume the lexer is in its
+// default state there, with the line state seen after the first blank line of the range.
+// Chunks are committed in order and any whose assumption was wrong is lexed again once the
+// preceding text is styled. Folding is left to the caller.
+bool LexInterface::LexInParallel(int start, int end, int styleStart) {
+	if (!parallel || !instanceReentrant || !threadsAvailable ||
+		(pdoc->dbcsCodePage && (pdoc->dbcsCodePage != SC_CP_UTF8))) {
+		return false;
+	}
+	const int chunksWanted = std::min((end - start) / parallelBytes, BackgroundThread::Processors());
+	if (chunksWanted < 2)
+		return false;
+	std::vector<int> bounds(1, start);
+	for (int chunk = 1; chunk < chunksWanted; chunk++) {
+		const int boundary = CleanLineStart(start + (end - start) / chunksWanted * chunk, end);
+		if (boundary > bounds.back())
+			bounds.push_back(boundary);
+	}
+	if (bounds.size() < 2)
+		return false;
+	bounds.push_back(end);
+
+	// Some lexers set a line state other than 0 even in their default state
+	int lineStateClean = 0;
+	const int headEnd = CleanLineStart(start, bounds[1]);
+	if (headEnd > start) {
+		instance->Lex(start, headEnd - start, styleStart, pdoc);
+		if (pdoc->StyleAt(headEnd - 1) == 0)
+			lineStateClean = pdoc->GetLineState(pdoc->LineFromPosition(headEnd) - 1);
+		start = headEnd;
+		styleStart = pdoc->StyleAt(headEnd - 1);
+	}
+
+	std::vector<LexChunk> chunks(bounds.size() - 1);
+	for (size_t chunk = 1; chunk < chunks.size(); chunk++) {
+		chunks[chunk].snapshot = new LexSnapshot(pdoc, bounds[chunk], bounds[chunk + 1]);
+		chunks[chunk].snapshot->AssumeCleanStart(lineStateClean);
+		chunks[chunk].instance = instance;
+		chunks[chunk].thread = BackgroundThread::Start(LexChunkProcedure, &chunks[chunk]);
+		if (!chunks[chunk].thread)
+			threadsAvailable = false;
+	}
+	instance->Lex(start, bounds[1] - start, styleStart, pdoc);
+	for (size_t chunk = 1; chunk < chunks.size(); chunk++) {
+		bool committed = false;
+		if (chunks[chunk].thread) {
+			delete chunks[chunk].thread;
+			committed = chunks[chunk].snapshot->CleanStart(pdoc) && chunks[chunk].snapshot->Commit(pdoc);
+		}
+		if (!committed) {
+			const int chunkStart = bounds[chunk];
+			instance->Lex(chunkStart, bounds[chunk + 1] - chunkStart, pdoc->StyleAt(chunkStart - 1), pdoc);
+		}
+		delete chunks[chunk].snapshot;
+	}
+	return true;
+}
+
+Document::Document(int options) : cb((options & SC_DOCUMENTOPTION_TEXT_CHUNKED) != 0) {
 	refCount = 0;
 	pcf = NULL;
 #ifdef _WIN32
@@ -99,6 +798,7 @@ Document::Document() {
 	lineEndBitSet = SC_LINE_END_TYPE_DEFAULT;
 	endStyled = 0;
 	styleClock = 0;
+	changeStamp = 0;
 	enteredModification = 0;
 	enteredStyling = 0;
 	enteredReadOnlyCount = 0;
@@ -852,6 +1552,13 @@ int SCI_METHOD Document::GetCharacterAndWidth(Sci_Position position, Sci_Positio
 	return character;
 }
 
+const char * SCI_METHOD Document::ContiguousRange(Sci_Position position, Sci_Position *rangeLength) const {
+	int lengthContiguous = 0;
+	const char *range = cb.ContiguousRange(static_cast<int>(position), lengthContiguous);
+	*rangeLength = lengthContiguous;
+	return range;
+}
+
 int SCI_METHOD Document::CodePage() const {
 	return dbcsCodePage;
 }
@@ -945,6 +1652,8 @@ EncodingFamily Document::CodePageFamily() const {
 void Document::ModifiedAt(int pos) {
 	if (endStyled > pos)
 		endStyled = pos;
+	if (pli)
+		pli->InvalidateBackground(pos);
 }
 
 void Document::CheckReadOnly() {
@@ -1230,10 +1939,6 @@ void Document::DelCharBack(int pos) {
 	}
 }
 
-static int NextTab(int pos, int tabSize) {
-	return ((pos / tabSize) + 1) * tabSize;
-}
-
 static std::string CreateIndentation(int indent, int tabSize, bool insertSpaces) {
 	std::string indentation;
 	if (!insertSpaces) {
@@ -1619,6 +2324,7 @@ bool Document::HasCaseFolder(void) const {
 void Document::SetCaseFolder(CaseFolder *pcf_) {
 	delete pcf;
 	pcf = pcf_;
+	foldTable.clear();
 }
 
 Document::CharacterExtracted Document::ExtractCharacter(int position) const {
@@ -1640,6 +2346,161 @@ Document::CharacterExtracted Document::ExtractCharacter(int position) const {
 	}
 }
 
+namespace {
+
+/**
+ * Reads the text of a document into a block so that literal searches compare bytes
+ * directly instead of calling CharAt for each one. The text is copied, which works
+ * whether it is gap buffered, chunked or mapped. Blocks start small and double as a
+ * search continues so that finding a nearby match, as Mark All does repeatedly,
+ * only copies a little text.
+ * Matches are found with Boyer-Moore-Horspool over bytes folded through a table.
+ */
+class BlockSearch {
+	enum { blockInitial = 0x400, blockMaximum = 0x40000 };
+	const Document *pdoc;
+	unsigned char fold[256];
+	std::vector<unsigned char> needle;
+	int shiftForward[256];
+	int shiftBackward[256];
+	std::vector<unsigned char> block;
+	int blockStart;
+	int blockEnd;
+	int blockSize;
+
+	/// Ensure the block holds [start, end) by reading from start when moving forward
+	/// or ending at end when moving backward, up to extent.
+	void Read(int start, int end, int extent, bool forward) {
+		if ((start < blockStart) || (end > blockEnd)) {
+			if (forward) {
+				blockStart = start;
+				blockEnd = std::min(std::max(end, start + blockSize), extent);
+			} else {
+				blockEnd = end;
+				blockStart = std::max(std::min(start, end - blockSize), extent);
+			}
+			block.resize(blockEnd - blockStart);
+			pdoc->GetCharRange(reinterpret_cast<char *>(&block[0]), blockStart, blockEnd - blockStart);
+			blockSize = std::min(blockSize * 2, static_cast<int>(blockMaximum));
+		}
+	}
+	bool MatchesAt(const unsigned char *text) const {
+		const size_t lengthNeedle = needle.size();
+		for (size_t i = 0; i < lengthNeedle; i++) {
+			if (fold[text[i]] != needle[i])
+				return false;
+		}
+		return true;
+	}
+
+public:
+	/// foldTable maps each byte to its folded form or is 0 to match exactly.
+	/// search must already be folded.
+	BlockSearch(const Document *pdoc_, const unsigned char *foldTable, const char *search, int lengthSearch) :
+		pdoc(pdoc_), needle(lengthSearch), blockStart(0), blockEnd(0), blockSize(blockInitial) {
+		for (int ch = 0; ch < 256; ch++)
+			fold[ch] = foldTable ? foldTable[ch] : static_cast<unsigned char>(ch);
+		for (int i = 0; i < lengthSearch; i++)
+			needle[i] = static_cast<unsigned char>(search[i]);
+		for (int ch = 0; ch < 256; ch++) {
+			shiftForward[ch] = lengthSearch;
+			shiftBackward[ch] = lengthSearch;
+		}
+		for (int i = 0; i < lengthSearch - 1; i++)
+			shiftForward[needle[i]] = lengthSearch - 1 - i;
+		for (int i = lengthSearch - 1; i > 0; i--)
+			shiftBackward[needle[i]] = i;
+	}
+
+	/// The first match starting in [start, startLast] or -1.
+	int Forward(int start, int startLast) {
+		const int lengthNeedle = static_cast<int>(needle.size());
+		const unsigned char last = needle[lengthNeedle - 1];
+		int pos = start;
+		while (pos <= startLast) {
+			Read(pos, pos + lengthNeedle, startLast + lengthNeedle, true);
+			const unsigned char *text = &block[0];
+			const int posEnd = std::min(startLast, blockEnd - lengthNeedle);
+			while (pos <= posEnd) {
+				const unsigned char ch = fold[text[pos - blockStart + lengthNeedle - 1]];
+				if ((ch == last) && MatchesAt(text + pos - blockStart))
+					return pos;
+				pos += shiftForward[ch];
+			}
+		}
+		return -1;
+	}
+
+	/// The last match starting in [startFirst, start] or -1.
+	int Backward(int start, int startFirst) {
+		const int lengthNeedle = static_cast<int>(needle.size());
+		const unsigned char first = needle[0];
+		int pos = start;
+		while (pos >= startFirst) {
+			Read(pos, pos + lengthNeedle, startFirst, false);
+			const unsigned char *text = &block[0];
+			const int posEnd = std::max(startFirst, blockStart);
+			while (pos >= posEnd) {
+				const unsigned char ch = fold[text[pos - blockStart]];
+				if ((ch == first) && MatchesAt(text + pos - blockStart))
+					return pos;
+				pos -= shiftBackward[ch];
+			}
+		}
+		return -1;
+	}
+
+	/// The first position in [start, end) that is not an ASCII byte which differs from
+	/// the start of the needle. Other characters may fold to anything so must be checked.
+	int ForwardCandidate(int start, int end) {
+		const unsigned char first = needle[0];
+		int pos = start;
+		while (pos < end) {
+			Read(pos, pos + 1, end, true);
+			const unsigned char *text = &block[0];
+			const int posEnd = std::min(end, blockEnd);
+			for (; pos < posEnd; pos++) {
+				const unsigned char ch = text[pos - blockStart];
+				if (!UTF8IsAscii(ch) || (fold[ch] == first))
+					return pos;
+			}
+		}
+		return -1;
+	}
+
+	/// Like ForwardCandidate but the last position in [startFirst, start].
+	int BackwardCandidate(int start, int startFirst) {
+		const unsigned char first = needle[0];
+		int pos = start;
+		while (pos >= startFirst) {
+			Read(pos, pos + 1, startFirst, false);
+			const unsigned char *text = &block[0];
+			const int posEnd = std::max(startFirst, blockStart);
+			for (; pos >= posEnd; pos--) {
+				const unsigned char ch = text[pos - blockStart];
+				if (!UTF8IsAscii(ch) || (fold[ch] == first))
+					return pos;
+			}
+		}
+		return -1;
+	}
+};
+
+}
+
+const unsigned char *Document::FoldTable() {
+	if (foldTable.empty()) {
+		foldTable.resize(256);
+		for (int ch = 0; ch < 256; ch++) {
+			const char mixed = static_cast<char>(ch);
+			char folded[UTF8MaxBytes * 4 + 1];
+			const size_t lenFlat = pcf->Fold(folded, sizeof(folded), &mixed, 1);
+			foldTable[ch] = static_cast<unsigned char>((lenFlat == 1) ? folded[0] : mixed);
+		}
+	}
+	return &foldTable[0];
+}
+
 /**
  * Find text in document, supporting both forward and backward
  * searches (just pass minPos > maxPos to do a backward search)
@@ -1676,7 +2537,22 @@ long Document::FindText(int minPos, int maxPos, const char *search,
 			// Back all of a character
 			pos = NextPosition(pos, increment);
 		}
-		if (caseSensitive) {
+		if (caseSensitive && ((dbcsCodePage == 0) ||
+			((SC_CP_UTF8 == dbcsCodePage) && !UTF8IsTrailByte(static_cast<unsigned char>(search[0]))))) {
+			// A match can not start inside a character so every byte position is tried
+			const int endSearch = (startPos <= endPos) ? endPos - lengthFind + 1 : endPos;
+			BlockSearch blockSearch(this, 0, search, lengthFind);
+			for (;;) {
+				pos = forward ? blockSearch.Forward(pos, endSearch - 1) :
+					blockSearch.Backward(std::min(pos, limitPos - lengthFind), endSearch);
+				if (pos < 0)
+					break;
+				if (MatchesWordOptions(word, wordStart, pos, lengthFind)) {
+					return pos;
+				}
+				pos += increment;
+			}
+		} else if (caseSensitive) {
 			const int endSearch = (startPos <= endPos) ? endPos - lengthFind + 1 : endPos;
 			const char charStartSearch =  search[0];
 			while (forward ? (pos < endSearch) : (pos >= endSearch)) {
@@ -1697,9 +2573,24 @@ long Document::FindText(int minPos, int maxPos, const char *search,
 			std::vector<char> searchThing(lengthFind * UTF8MaxBytes * maxFoldingExpansion + 1);
 			const int lenSearch = static_cast<int>(
 				pcf->Fold(&searchThing[0], searchThing.size(), search, lengthFind));
+			const unsigned char *foldTable = FoldTable();
+			BlockSearch blockSearch(this, foldTable, &searchThing[0], lenSearch);
 			char bytes[UTF8MaxBytes + 1];
 			char folded[UTF8MaxBytes * maxFoldingExpansion + 1];
 			while (forward ? (pos < endPos) : (pos >= endPos)) {
+				// Skip over ASCII characters that can not start a match
+				const int posCandidate = forward ? blockSearch.ForwardCandidate(pos, endPos) :
+					blockSearch.BackwardCandidate(pos, endPos);
+				if (posCandidate < 0)
+					break;
+				if (!forward && (posCandidate != pos) && !UTF8IsAscii(static_cast<unsigned char>(cb.CharAt(posCandidate)))) {
+					// Moving backwards stopped on the last byte of a character
+					pos = NextPosition(posCandidate + 1, -1);
+					if (pos < endPos)
+						break;
+				} else {
+					pos = posCandidate;
+				}
 				int widthFirstCharacter = 0;
 				int posIndexDocument = pos;
 				int indexSearch = 0;
@@ -1719,7 +2610,11 @@ long Document::FindText(int minPos, int maxPos, const char *search,
 						widthFirstCharacter = widthChar;
 					if ((posIndexDocument + widthChar) > limitPos)
 						break;
-					const int lenFlat = static_cast<int>(pcf->Fold(folded, sizeof(folded), bytes, widthChar));
+					int lenFlat = 1;
+					if (UTF8IsAscii(leadByte))
+						folded[0] = static_cast<char>(foldTable[leadByte]);
+					else
+						lenFlat = static_cast<int>(pcf->Fold(folded, sizeof(folded), bytes, widthChar));
 					folded[lenFlat] = 0;
 					// Does folded match the buffer
 					characterMatches = 0 == memcmp(folded, &searchThing[0] + indexSearch, lenFlat);
@@ -1784,19 +2679,16 @@ long Document::FindText(int minPos, int maxPos, const char *search,
 			const int endSearch = (startPos <= endPos) ? endPos - lengthFind + 1 : endPos;
 			std::vector<char> searchThing(lengthFind + 1);
 			pcf->Fold(&searchThing[0], searchThing.size(), search, lengthFind);
-			while (forward ? (pos < endSearch) : (pos >= endSearch)) {
-				bool found = (pos + lengthFind) <= limitPos;
-				for (int indexSearch = 0; (indexSearch < lengthFind) && found; indexSearch++) {
-					char ch = CharAt(pos + indexSearch);
-					char folded[2];
-					pcf->Fold(folded, sizeof(folded), &ch, 1);
-					found = folded[0] == searchThing[indexSearch];
-				}
-				if (found && MatchesWordOptions(word, wordStart, pos, lengthFind)) {
+			BlockSearch blockSearch(this, FoldTable(), &searchThing[0], lengthFind);
+			for (;;) {
+				pos = forward ? blockSearch.Forward(pos, endSearch - 1) :
+					blockSearch.Backward(std::min(pos, limitPos - lengthFind), endSearch);
+				if (pos < 0)
+					break;
+				if (MatchesWordOptions(word, wordStart, pos, lengthFind)) {
 					return pos;
 				}
-				if (!NextCharacter(pos, increment))
-					break;
+				pos += increment;
 			}
 		}
 	}
@@ -1853,19 +2745,12 @@ bool SCI_METHOD Document::SetStyles(Sci_Position length, const char *styles) {
 		return false;
 	} else {
 		enteredStyling++;
-		bool didChange = false;
+		PLATFORM_ASSERT(endStyled + length <= Length());
 		int startMod = 0;
 		int endMod = 0;
-		for (int iPos = 0; iPos < length; iPos++, endStyled++) {
-			PLATFORM_ASSERT(endStyled < Length());
-			if (cb.SetStyleAt(endStyled, styles[iPos])) {
-				if (!didChange) {
-					startMod = endStyled;
-				}
-				didChange = true;
-				endMod = endStyled;
-			}
-		}
+		const int lengthInDocument = std::max(std::min(static_cast<int>(length), Length() - endStyled), 0);
+		const bool didChange = cb.SetStyles(endStyled, lengthInDocument, styles, startMod, endMod);
+		endStyled += static_cast<int>(length);
 		if (didChange) {
 			DocModification mh(SC_MOD_CHANGESTYLE | SC_PERFORMED_USER,
 			                   startMod, endMod - startMod + 1);
@@ -1880,9 +2765,13 @@ void Document::EnsureStyledTo(int pos) {
 	if ((enteredStyling == 0) && (pos > GetEndStyled())) {
 		IncrementStyleClock();
 		if (pli && !pli->UseContainerLexing()) {
-			int lineEndStyled = LineFromPosition(GetEndStyled());
-			int endStyledTo = LineStart(lineEndStyled);
-			pli->Colourise(endStyledTo, pos);
+			// The background thread may be lexing the text wanted
+			pli->FinishBackground();
+			if (pos > GetEndStyled()) {
+				int lineEndStyled = LineFromPosition(GetEndStyled());
+				int endStyledTo = LineStart(lineEndStyled);
+				pli->Colourise(endStyledTo, pos);
+			}
 		} else {
 			// Ask the watchers to style, and stop as soon as one responds.
 			for (std::vector<WatcherWithUserData>::iterator it = watchers.begin();
@@ -1893,6 +2782,10 @@ void Document::EnsureStyledTo(int pos) {
 	}
 }
 
+bool Document::StyleInBackground(int pos) {
+	return pli && !pli->UseContainerLexing() && (enteredStyling == 0) && pli->StyleInBackground(pos);
+}
+
 void Document::StyleToAdjustingLineDuration(int pos) {
 	// Place bounds on the duration used to avoid glitches spiking it
 	// and so causing slow styling or non-responsive scrolling
@@ -2067,8 +2960,10 @@ void Document::NotifySavePoint(bool atSavePoint) {
 void Document::NotifyModified(DocModification mh) {
 	if (mh.modificationType & SC_MOD_INSERTTEXT) {
 		decorations.InsertSpace(mh.position, mh.length);
+		changeStamp = (changeStamp + 1) & 0x7fffffff;
 	} else if (mh.modificationType & SC_MOD_DELETETEXT) {
 		decorations.DeleteRange(mh.position, mh.length);
+		changeStamp = (changeStamp + 1) & 0x7fffffff;
 	}
 	for (std::vector<WatcherWithUserData>::iterator it = watchers.begin(); it != watchers.end(); ++it) {
 		it->watcher->NotifyModified(this, mh, it->userData);
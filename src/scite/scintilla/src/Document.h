@@ -175,21 +175,50 @@ inline int LevelNumber(int level) {
 	return level & SC_FOLDLEVELNUMBERMASK;
 }
 
+class LexSnapshot;
+
+/**
+ * Runs the lexer for the document, either directly or on a background thread
+ * against a LexSnapshot whose results are then committed to the document.
+ */
 class LexInterface {
+	LexSnapshot *snapshot;	///< Being lexed on thread
+	BackgroundThread *thread;
+	BackgroundEvent *lexed;
+	bool threadsAvailable;
+	bool strays;	///< Lexer read outside its snapshot so lexes on the main thread
+	bool parallel;
+	static void LexProcedure(void *argument);
+	int CleanLineStart(int pos, int limit) const;
+	bool LexInParallel(int start, int end, int styleStart);
+	// Private so LexInterface objects can not be copied
+	LexInterface(const LexInterface &);
 protected:
 	Document *pdoc;
 	ILexer *instance;
+	bool instanceReentrant;	///< Lex may be called on several ranges at once
 	bool performingStyle;	///< Prevent reentrance
+	void AbandonBackground();
 public:
-	explicit LexInterface(Document *pdoc_) : pdoc(pdoc_), instance(0), performingStyle(false) {
-	}
-	virtual ~LexInterface() {
+	enum { backgroundBytes = 0x20000, contextBytes = 0x10000, parallelBytes = 0x40000 };
+	explicit LexInterface(Document *pdoc_) : snapshot(0), thread(0), lexed(0), threadsAvailable(true),
+		strays(false), parallel(false), pdoc(pdoc_), instance(0), instanceReentrant(false), performingStyle(false) {
 	}
+	virtual ~LexInterface();
 	void Colourise(int start, int end);
 	int LineEndTypesSupported();
 	bool UseContainerLexing() const {
 		return instance == 0;
 	}
+	bool StyleInBackground(int pos);
+	bool FinishBackground();
+	void InvalidateBackground(int pos);
+	void SetParallel(bool parallel_) {
+		parallel = parallel_;
+	}
+	bool GetParallel() const {
+		return parallel;
+	}
 };
 
 struct RegexError : public std::runtime_error {
@@ -198,7 +227,7 @@ struct RegexError : public std::runtime_error {
 
 /**
  */
-class Document : PerLine, public IDocumentWithLineEnd, public ILoader {
+class Document : PerLine, public IDocumentWithContiguousRange, public ILoader {
 
 public:
 	/** Used to pair watcher pointer with user data. */
@@ -218,8 +247,11 @@ private:
 	CellBuffer cb;
 	CharClassify charClass;
 	CaseFolder *pcf;
+	/// Each byte folded on its own by pcf, built when first needed by FindText.
+	std::vector<unsigned char> foldTable;
 	int endStyled;
 	int styleClock;
+	int changeStamp;	///< Counts text insertions and deletions
 	int enteredModification;
 	int enteredStyling;
 	int enteredReadOnlyCount;
@@ -254,7 +286,7 @@ public:
 
 	DecorationList decorations;
 
-	Document();
+	explicit Document(int options=SC_DOCUMENTOPTION_DEFAULT);
 	virtual ~Document();
 
 	int AddRef();
@@ -270,7 +302,7 @@ public:
 	virtual void RemoveLine(int line);
 
 	int SCI_METHOD Version() const {
-		return dvLineEnd;
+		return dvContiguousRange;
 	}
 
 	void SCI_METHOD SetErrorStatus(int status);
@@ -312,6 +344,9 @@ public:
 	void BeginUndoAction() { cb.BeginUndoAction(); }
 	void EndUndoAction() { cb.EndUndoAction(); }
 	void AddUndoAction(int token, bool mayCoalesce) { cb.AddUndoAction(token, mayCoalesce); }
+	int UndoMemory() const { return cb.UndoMemory(); }
+	void SetUndoMemoryLimit(int memoryLimit) { cb.SetUndoMemoryLimit(memoryLimit); }
+	int GetUndoMemoryLimit() const { return cb.GetUndoMemoryLimit(); }
 	void SetSavePoint();
 	bool IsSavePoint() const { return cb.IsSavePoint(); }
 
@@ -323,6 +358,8 @@ public:
 	const char * SCI_METHOD BufferPointer() { return cb.BufferPointer(); }
 	const char *RangePointer(int position, int rangeLength) { return cb.RangePointer(position, rangeLength); }
 	int GapPosition() const { return cb.GapPosition(); }
+	int GetChangeStamp() const { return changeStamp; }
+	const char * SCI_METHOD ContiguousRange(Sci_Position position, Sci_Position *rangeLength) const;
 
 	int SCI_METHOD GetLineIndentation(Sci_Position line);
 	int SetLineIndentation(int line, int indent);
@@ -378,6 +415,8 @@ public:
 	int NextWordEnd(int pos, int delta);
 	Sci_Position SCI_METHOD Length() const { return cb.Length(); }
 	void Allocate(int newSize) { cb.Allocate(newSize); }
+	void SetMappedText(IMappedText *mappedText) { cb.SetMapped(mappedText); }
+	int Options() const { return cb.IsChunked() ? SC_DOCUMENTOPTION_TEXT_CHUNKED : SC_DOCUMENTOPTION_DEFAULT; }
 
 	struct CharacterExtracted {
 		unsigned int character;
@@ -407,6 +446,7 @@ public:
 	bool SCI_METHOD SetStyles(Sci_Position length, const char *styles);
 	int GetEndStyled() const { return endStyled; }
 	void EnsureStyledTo(int pos);
+	bool StyleInBackground(int pos);
 	void StyleToAdjustingLineDuration(int pos);
 	void LexerChanged();
 	int GetStyleClock() const { return styleClock; }
@@ -449,6 +489,7 @@ public:
 	int BraceMatch(int position, int maxReStyle);
 
 private:
+	const unsigned char *FoldTable();
 	void NotifyModifyAttempt();
 	void NotifySavePoint(bool atSavePoint);
 	void NotifyModified(DocModification mh);
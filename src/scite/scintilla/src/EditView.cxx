@@ -28,6 +28,7 @@
 #include "Position.h"
 #include "SplitVector.h"
 #include "Partitioning.h"
+#include "ChunkedVector.h"
 #include "RunStyles.h"
 #include "ContractionState.h"
 #include "CellBuffer.h"
@@ -58,6 +59,14 @@ static inline bool IsControlCharacter(int ch) {
 	return ch >= 0 && ch < ' ';
 }
 
+static bool AllGraphicASCII(const char *s, int len) {
+	for (int i=0; i<len; i++) {
+		if ((s[i] < ' ') || (s[i] > '~'))
+			return false;
+	}
+	return true;
+}
+
 PrintParameters::PrintParameters() {
 	magnification = 0;
 	colourMode = SC_PRINT_NORMAL;
@@ -461,53 +470,61 @@ void EditView::LayoutLine(const EditModel &model, int line, Surface *surface, co
 		// Layout the line, determining the position of each character,
 		// with an extra element at the end for the end of the line.
 		ll->positions[0] = 0;
-		bool lastSegItalics = false;
-
-		BreakFinder bfLayout(ll, NULL, Range(0, numCharsInLine), posLineStart, 0, false, model.pdoc, &model.reprs, NULL);
-		while (bfLayout.More()) {
-
-			const TextSegment ts = bfLayout.Next();
+		ll->numCharsInLine = numCharsInLine;
 
-			std::fill(&ll->positions[ts.start + 1], &ll->positions[ts.end() + 1], 0.0f);
-			if (vstyle.styles[ll->styles[ts.start]].visible) {
-				if (ts.representation) {
-					XYPOSITION representationWidth = vstyle.controlCharWidth;
-					if (ll->chars[ts.start] == '\t') {
-						// Tab is a special case of representation, taking a variable amount of space
-						const XYPOSITION x = ll->positions[ts.start];
-						representationWidth = NextTabstopPos(line, x, vstyle.tabWidth) - ll->positions[ts.start];
-					} else {
-						if (representationWidth <= 0.0) {
-							XYPOSITION positionsRepr[256];	// Should expand when needed
-							posCache.MeasureWidths(surface, vstyle, STYLE_CONTROLCHAR, ts.representation->stringRep.c_str(),
-								static_cast<unsigned int>(ts.representation->stringRep.length()), positionsRepr, model.pdoc);
-							representationWidth = positionsRepr[ts.representation->stringRep.length() - 1] + vstyle.ctrlCharPadding;
+		const FixedPitchSettings fps(vstyle, model.reprs, tabWidthMinimumPixels, ldTabstops == 0);
+		if (!ll->LayoutFixedPitch(fps)) {
+			bool lastSegItalics = false;
+			BreakFinder bfLayout(ll, NULL, Range(0, numCharsInLine), posLineStart, 0, false, model.pdoc, &model.reprs, NULL);
+			while (bfLayout.More()) {
+
+				const TextSegment ts = bfLayout.Next();
+
+				std::fill(&ll->positions[ts.start + 1], &ll->positions[ts.end() + 1], 0.0f);
+				if (vstyle.styles[ll->styles[ts.start]].visible) {
+					if (ts.representation) {
+						XYPOSITION representationWidth = vstyle.controlCharWidth;
+						if (ll->chars[ts.start] == '\t') {
+							// Tab is a special case of representation, taking a variable amount of space
+							const XYPOSITION x = ll->positions[ts.start];
+							representationWidth = NextTabstopPos(line, x, vstyle.tabWidth) - ll->positions[ts.start];
+						} else {
+							if (representationWidth <= 0.0) {
+								XYPOSITION positionsRepr[256];	// Should expand when needed
+								posCache.MeasureWidths(surface, vstyle, STYLE_CONTROLCHAR, ts.representation->stringRep.c_str(),
+									static_cast<unsigned int>(ts.representation->stringRep.length()), positionsRepr, model.pdoc);
+								representationWidth = positionsRepr[ts.representation->stringRep.length() - 1] + vstyle.ctrlCharPadding;
+							}
 						}
-					}
-					for (int ii = 0; ii < ts.length; ii++)
-						ll->positions[ts.start + 1 + ii] = representationWidth;
-				} else {
-					if ((ts.length == 1) && (' ' == ll->chars[ts.start])) {
-						// Over half the segments are single characters and of these about half are space characters.
-						ll->positions[ts.start + 1] = vstyle.styles[ll->styles[ts.start]].spaceWidth;
+						for (int ii = 0; ii < ts.length; ii++)
+							ll->positions[ts.start + 1 + ii] = representationWidth;
 					} else {
-						posCache.MeasureWidths(surface, vstyle, ll->styles[ts.start], ll->chars + ts.start,
-							ts.length, ll->positions + ts.start + 1, model.pdoc);
+						const Style &styleSegment = vstyle.styles[ll->styles[ts.start]];
+						if ((ts.length == 1) && (' ' == ll->chars[ts.start])) {
+							// Over half the segments are single characters and of these about half are space characters.
+							ll->positions[ts.start + 1] = styleSegment.spaceWidth;
+						} else if (styleSegment.monospaceASCII && AllGraphicASCII(ll->chars + ts.start, ts.length)) {
+							// Fixed pitch font so no need to ask the platform
+							for (int ii = 0; ii < ts.length; ii++)
+								ll->positions[ts.start + 1 + ii] = styleSegment.monospaceCharacterWidth * (ii + 1);
+						} else {
+							posCache.MeasureWidths(surface, vstyle, ll->styles[ts.start], ll->chars + ts.start,
+								ts.length, ll->positions + ts.start + 1, model.pdoc);
+						}
 					}
+					lastSegItalics = (!ts.representation) && ((ll->chars[ts.end() - 1] != ' ') && vstyle.styles[ll->styles[ts.start]].italic);
 				}
-				lastSegItalics = (!ts.representation) && ((ll->chars[ts.end() - 1] != ' ') && vstyle.styles[ll->styles[ts.start]].italic);
-			}
 
-			for (int posToIncrease = ts.start + 1; posToIncrease <= ts.end(); posToIncrease++) {
-				ll->positions[posToIncrease] += ll->positions[ts.start];
+				for (int posToIncrease = ts.start + 1; posToIncrease <= ts.end(); posToIncrease++) {
+					ll->positions[posToIncrease] += ll->positions[ts.start];
+				}
 			}
-		}
 
-		// Small hack to make lines that end with italics not cut off the edge of the last character
-		if (lastSegItalics) {
-			ll->positions[numCharsInLine] += vstyle.lastSegItalicsOffset;
+			// Small hack to make lines that end with italics not cut off the edge of the last character
+			if (lastSegItalics) {
+				ll->positions[numCharsInLine] += vstyle.lastSegItalicsOffset;
+			}
 		}
-		ll->numCharsInLine = numCharsInLine;
 		ll->numCharsBeforeEOL = numCharsBeforeEOL;
 		ll->validity = LineLayout::llPositions;
 	}
@@ -516,82 +533,7 @@ void EditView::LayoutLine(const EditModel &model, int line, Surface *surface, co
 		width = 20;
 	}
 	if ((ll->validity == LineLayout::llPositions) || (ll->widthLine != width)) {
-		ll->widthLine = width;
-		if (width == LineLayout::wrapWidthInfinite) {
-			ll->lines = 1;
-		} else if (width > ll->positions[ll->numCharsInLine]) {
-			// Simple common case where line does not need wrapping.
-			ll->lines = 1;
-		} else {
-			if (vstyle.wrapVisualFlags & SC_WRAPVISUALFLAG_END) {
-				width -= static_cast<int>(vstyle.aveCharWidth); // take into account the space for end wrap mark
-			}
-			XYPOSITION wrapAddIndent = 0; // This will be added to initial indent of line
-			if (vstyle.wrapIndentMode == SC_WRAPINDENT_INDENT) {
-				wrapAddIndent = model.pdoc->IndentSize() * vstyle.spaceWidth;
-			} else if (vstyle.wrapIndentMode == SC_WRAPINDENT_FIXED) {
-				wrapAddIndent = vstyle.wrapVisualStartIndent * vstyle.aveCharWidth;
-			}
-			ll->wrapIndent = wrapAddIndent;
-			if (vstyle.wrapIndentMode != SC_WRAPINDENT_FIXED)
-			for (int i = 0; i < ll->numCharsInLine; i++) {
-				if (!IsSpaceOrTab(ll->chars[i])) {
-					ll->wrapIndent += ll->positions[i]; // Add line indent
-					break;
-				}
-			}
-			// Check for text width minimum
-			if (ll->wrapIndent > width - static_cast<int>(vstyle.aveCharWidth) * 15)
-				ll->wrapIndent = wrapAddIndent;
-			// Check for wrapIndent minimum
-			if ((vstyle.wrapVisualFlags & SC_WRAPVISUALFLAG_START) && (ll->wrapIndent < vstyle.aveCharWidth))
-				ll->wrapIndent = vstyle.aveCharWidth; // Indent to show start visual
-			ll->lines = 0;
-			// Calculate line start positions based upon width.
-			int lastGoodBreak = 0;
-			int lastLineStart = 0;
-			XYACCUMULATOR startOffset = 0;
-			int p = 0;
-			while (p < ll->numCharsInLine) {
-				if ((ll->positions[p + 1] - startOffset) >= width) {
-					if (lastGoodBreak == lastLineStart) {
-						// Try moving to start of last character
-						if (p > 0) {
-							lastGoodBreak = model.pdoc->MovePositionOutsideChar(p + posLineStart, -1)
-								- posLineStart;
-						}
-						if (lastGoodBreak == lastLineStart) {
-							// Ensure at least one character on line.
-							lastGoodBreak = model.pdoc->MovePositionOutsideChar(lastGoodBreak + posLineStart + 1, 1)
-								- posLineStart;
-						}
-					}
-					lastLineStart = lastGoodBreak;
-					ll->lines++;
-					ll->SetLineStart(ll->lines, lastGoodBreak);
-					startOffset = ll->positions[lastGoodBreak];
-					// take into account the space for start wrap mark and indent
-					startOffset -= ll->wrapIndent;
-					p = lastGoodBreak + 1;
-					continue;
-				}
-				if (p > 0) {
-					if (vstyle.wrapState == eWrapChar) {
-						lastGoodBreak = model.pdoc->MovePositionOutsideChar(p + posLineStart, -1)
-							- posLineStart;
-						p = model.pdoc->MovePositionOutsideChar(p + 1 + posLineStart, 1) - posLineStart;
-						continue;
-					} else if ((vstyle.wrapState == eWrapWord) && (ll->styles[p] != ll->styles[p - 1])) {
-						lastGoodBreak = p;
-					} else if (IsSpaceOrTab(ll->chars[p - 1]) && !IsSpaceOrTab(ll->chars[p])) {
-						lastGoodBreak = p;
-					}
-				}
-				p++;
-			}
-			ll->lines++;
-		}
-		ll->validity = LineLayout::llLines;
+		ll->WrapToWidth(WrapParameters(vstyle, model.pdoc->IndentSize()), width, model.pdoc, posLineStart);
 	}
 }
 
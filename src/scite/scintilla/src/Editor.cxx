@@ -28,6 +28,7 @@
 #include "Position.h"
 #include "SplitVector.h"
 #include "Partitioning.h"
+#include "ChunkedVector.h"
 #include "RunStyles.h"
 #include "ContractionState.h"
 #include "CellBuffer.h"
@@ -173,8 +174,10 @@ Editor::Editor() {
 	paintAbandonedByStyling = false;
 	paintingAllText = false;
 	willRedrawAll = false;
+	replacingAll = false;
 	idleStyling = SC_IDLESTYLING_NONE;
 	needIdleStyling = false;
+	backgroundLexing = false;
 
 	modEventMask = SC_MODEVENTMASKALL;
 
@@ -1453,6 +1456,7 @@ void Editor::NeedWrapping(int docLineStart, int docLineEnd) {
 	if (wrapPending.AddRange(docLineStart, docLineEnd)) {
 		view.llc.Invalidate(LineLayout::llPositions);
 	}
+	backgroundWrap.Invalidate(docLineStart, docLineEnd);
 	// Wrap lines during idle.
 	if (Wrapping() && wrapPending.NeedsWrap()) {
 		SetIdle(true);
@@ -1470,6 +1474,69 @@ bool Editor::WrapOneLine(Surface *surface, int lineToWrap) {
 		(vs.annotationVisible ? pdoc->AnnotationLines(lineToWrap) : 0));
 }
 
+// Lines of ASCII text in fixed pitch fonts can be wrapped without measuring so are wrapped
+// by background threads.
+bool Editor::WrappingInBackground() const {
+	return Wrapping() && !vs.viewEOL && vs.styles[STYLE_DEFAULT].monospaceASCII;
+}
+
+// Apply the sublines found by background threads in document order, wrapping lines they
+// could not on this thread. At most linesMeasured lines are wrapped here.
+bool Editor::MergeBackgroundWrap(Surface *surface, int linesMeasured) {
+	bool wrapOccurred = false;
+	while (WrapBatch *batch = backgroundWrap.First()) {
+		for (; batch->merged < batch->Lines(); batch->merged++) {
+			const int lineDoc = batch->docLines[batch->merged];
+			if ((lineDoc != wrapPending.start) || (lineDoc >= pdoc->LinesTotal())) {
+				// An edit has invalidated this line or moved the start of pending wrapping
+				// so queue again from the start.
+				backgroundWrap.Clear();
+				return wrapOccurred;
+			}
+			const int sublines = batch->sublines[batch->merged];
+			if (sublines > 0) {
+				if (cs.SetHeight(lineDoc, sublines +
+					(vs.annotationVisible ? pdoc->AnnotationLines(lineDoc) : 0))) {
+					wrapOccurred = true;
+				}
+			} else {
+				if (linesMeasured <= 0)
+					return wrapOccurred;
+				linesMeasured--;
+				if (WrapOneLine(surface, lineDoc)) {
+					wrapOccurred = true;
+				}
+			}
+			wrapPending.Wrapped(lineDoc);
+		}
+		backgroundWrap.RemoveFirst();
+	}
+	return wrapOccurred;
+}
+
+// Queue a batch of the lines needing wrapping, help wrap queued batches, then merge those
+// that are finished.
+bool Editor::WrapInBackground(Surface *surface, int linesMeasured) {
+	const int lineEndNeedWrap = std::min(wrapPending.end, pdoc->LinesTotal());
+	if (backgroundWrap.Batches() < backgroundWrap.BatchesMaximum()) {
+		const int lineFirst = (backgroundWrap.Batches() > 0) ?
+			std::max(backgroundWrap.LineQueuedEnd(), wrapPending.start) : wrapPending.start;
+		const int posFirst = pdoc->LineStart(lineFirst);
+		int lineLast = lineFirst;
+		while ((lineLast < lineEndNeedWrap) && (lineLast - lineFirst < BackgroundWrap::batchLines) &&
+			(pdoc->LineStart(lineLast) - posFirst < BackgroundWrap::batchBytes)) {
+			lineLast++;
+		}
+		if (lineLast > lineFirst) {
+			pdoc->EnsureStyledTo(pdoc->LineStart(lineLast));
+			backgroundWrap.Add(new WrapBatch(vs, reprs, view.tabWidthMinimumPixels, view.ldTabstops == 0,
+				pdoc->IndentSize(), wrapWidth, pdoc, lineFirst, lineLast), lineLast);
+		}
+	}
+	backgroundWrap.WrapOne();
+	return MergeBackgroundWrap(surface, linesMeasured);
+}
+
 // Perform  wrapping for a subset of the lines needing wrapping.
 // wsAll: wrap all lines which need wrapping in this single call
 // wsVisible: wrap currently visible lines
@@ -1488,6 +1555,7 @@ bool Editor::WrapLines(enum wrapScope ws) {
 			wrapOccurred = true;
 		}
 		wrapPending.Reset();
+		backgroundWrap.Clear();
 
 	} else if (wrapPending.NeedsWrap()) {
 		wrapPending.start = std::min(wrapPending.start, pdoc->LinesTotal());
@@ -1522,9 +1590,11 @@ bool Editor::WrapLines(enum wrapScope ws) {
 		}
 		const int lineEndNeedWrap = std::min(wrapPending.end, pdoc->LinesTotal());
 		lineToWrapEnd = std::min(lineToWrapEnd, lineEndNeedWrap);
+		const bool background = (ws == wsIdle) && WrappingInBackground();
 
 		// Ensure all lines being wrapped are styled.
-		pdoc->EnsureStyledTo(pdoc->LineStart(lineToWrapEnd));
+		if (!background)
+			pdoc->EnsureStyledTo(pdoc->LineStart(lineToWrapEnd));
 
 		if (lineToWrap < lineToWrapEnd) {
 
@@ -1537,12 +1607,16 @@ bool Editor::WrapLines(enum wrapScope ws) {
 			if (surface) {
 //Platform::DebugPrintf("Wraplines: scope=%0d need=%0d..%0d perform=%0d..%0d\n", ws, wrapPending.start, wrapPending.end, lineToWrap, lineToWrapEnd);
 
-				while (lineToWrap < lineToWrapEnd) {
-					if (WrapOneLine(surface, lineToWrap)) {
-						wrapOccurred = true;
+				if (background) {
+					wrapOccurred = WrapInBackground(surface, lineToWrapEnd - lineToWrap);
+				} else {
+					while (lineToWrap < lineToWrapEnd) {
+						if (WrapOneLine(surface, lineToWrap)) {
+							wrapOccurred = true;
+						}
+						wrapPending.Wrapped(lineToWrap);
+						lineToWrap++;
 					}
-					wrapPending.Wrapped(lineToWrap);
-					lineToWrap++;
 				}
 
 				goodTopLine = cs.DisplayFromDoc(lineDocTop) + std::min(subLineTop, cs.GetHeight(lineDocTop)-1);
@@ -2499,6 +2573,7 @@ void Editor::CheckModificationForWrap(DocModification mh) {
 		view.llc.Invalidate(LineLayout::llCheckTextAndStyle);
 		int lineDoc = pdoc->LineFromPosition(mh.position);
 		int lines = Platform::Maximum(0, mh.linesAdded);
+		backgroundWrap.LinesInserted(lineDoc, mh.linesAdded);
 		if (Wrapping()) {
 			NeedWrapping(lineDoc, lineDoc + lines + 1);
 		}
@@ -2634,19 +2709,19 @@ void Editor::NotifyModified(Document *, DocModification mh, void *) {
 				}
 			}
 
-			if (paintState == notPainting && !CanDeferToLastStep(mh)) {
+			if (paintState == notPainting && !CanDeferToLastStep(mh) && !replacingAll) {
 				QueueIdleWork(WorkNeeded::workStyle, pdoc->Length());
 				Redraw();
 			}
 		} else {
-			if (paintState == notPainting && mh.length && !CanEliminate(mh)) {
+			if (paintState == notPainting && mh.length && !CanEliminate(mh) && !replacingAll) {
 				QueueIdleWork(WorkNeeded::workStyle, mh.position + mh.length);
 				InvalidateRange(mh.position, mh.position + mh.length);
 			}
 		}
 	}
 
-	if (mh.linesAdded != 0 && !CanDeferToLastStep(mh)) {
+	if (mh.linesAdded != 0 && !CanDeferToLastStep(mh) && !replacingAll) {
 		SetScrollBars();
 	}
 
@@ -2670,6 +2745,10 @@ void Editor::NotifyModified(Document *, DocModification mh, void *) {
 		Redraw();
 	}
 
+	// Replace all sends one notification for the whole span when it finishes
+	if (replacingAll && (mh.modificationType & (SC_MOD_INSERTTEXT | SC_MOD_DELETETEXT | SC_MOD_BEFOREINSERT | SC_MOD_BEFOREDELETE)))
+		return;
+
 	// If client wants to see this modification
 	if (mh.modificationType & modEventMask) {
 		if ((mh.modificationType & (SC_MOD_CHANGESTYLE | SC_MOD_CHANGEINDICATOR)) == 0) {
@@ -5029,7 +5108,7 @@ int Editor::PositionAfterMaxStyling(int posMax, bool scrolling) const {
 }
 
 void Editor::StartIdleStyling(bool truncatedLastStyling) {
-	if ((idleStyling == SC_IDLESTYLING_ALL) || (idleStyling == SC_IDLESTYLING_AFTERVISIBLE)) {
+	if (backgroundLexing || (idleStyling == SC_IDLESTYLING_ALL) || (idleStyling == SC_IDLESTYLING_AFTERVISIBLE)) {
 		if (pdoc->GetEndStyled() < pdoc->Length()) {
 			// Style remainder of document in idle time
 			needIdleStyling = true;
@@ -5060,10 +5139,16 @@ void Editor::StyleAreaBounded(PRectangle rcArea, bool scrolling) {
 
 void Editor::IdleStyling() {
 	const int posAfterArea = PositionAfterArea(GetClientRectangle());
-	const int endGoal = (idleStyling >= SC_IDLESTYLING_AFTERVISIBLE) ?
+	const int endGoal = (backgroundLexing || (idleStyling >= SC_IDLESTYLING_AFTERVISIBLE)) ?
 		pdoc->Length() : posAfterArea;
-	const int posAfterMax = PositionAfterMaxStyling(endGoal, false);
-	pdoc->StyleToAdjustingLineDuration(posAfterMax);
+	if (backgroundLexing && pdoc->StyleInBackground(endGoal)) {
+		// Lexing continues on another thread
+		return;
+	}
+	if (pdoc->GetEndStyled() < endGoal) {
+		const int posAfterMax = PositionAfterMaxStyling(endGoal, false);
+		pdoc->StyleToAdjustingLineDuration(posAfterMax);
+	}
 	if (pdoc->GetEndStyled() >= endGoal) {
 		needIdleStyling = false;
 	}
@@ -5515,6 +5600,104 @@ int Editor::ReplaceTarget(bool replacePatterns, const char *text, int length) {
 	return length;
 }
 
+/**
+ * Replace every match of text in the target range. Each match is deleted and inserted
+ * in one undo group. The container receives one SCN_MODIFIED with SC_MOD_REPLACEALL
+ * covering the replaced span instead of a notification for each change.
+ * Regular expression replacements substitute tagged text when the search flags
+ * include SCFIND_REGEXP. After an empty match, searching continues from the next character.
+ * The target is set to the replaced span.
+ * @return The number of replacements or -1 if the regular expression is invalid.
+ */
+int Editor::ReplaceAllInTarget(const char *text, const char *replacement) {
+	const int length = istrlen(text);
+	const int lengthReplacement = istrlen(replacement);
+	const bool replacePatterns = (searchFlags & SCFIND_REGEXP) != 0;
+	if (!pdoc->HasCaseFolder())
+		pdoc->SetCaseFolder(CaseFolderForEncoding());
+	// Each match is replaced in place so markers, annotations, indicators and folding
+	// on the lines between matches are kept and undo only holds the replaced text.
+	UndoGroup ug(pdoc);
+	int replacements = 0;
+	bool failed = false;
+	int linesAdded = 0;
+	int searchFrom = targetStart;
+	int searchEnd = targetEnd;
+	int firstReplaced = targetStart;
+	int lastReplaced = targetStart;
+	replacingAll = true;
+	try {
+		while (searchFrom <= searchEnd) {
+			int lengthFound = length;
+			const int pos = static_cast<int>(pdoc->FindText(searchFrom, searchEnd, text, searchFlags, &lengthFound));
+			if (pos == -1)
+				break;
+			std::string substituted(replacement, lengthReplacement);
+			if (replacePatterns) {
+				// Substitute before modifying as the match positions refer to the current text
+				int lengthSubstituted = lengthReplacement;
+				const char *substitutedText = pdoc->SubstituteByPosition(replacement, &lengthSubstituted);
+				if (substitutedText)
+					substituted.assign(substitutedText, lengthSubstituted);
+				else
+					substituted.clear();
+			}
+			const int linesBefore = pdoc->LinesTotal();
+			if (lengthFound > 0)
+				pdoc->DeleteChars(pos, lengthFound);
+			const int lengthInserted = pdoc->InsertString(pos, substituted.c_str(), static_cast<int>(substituted.length()));
+			linesAdded += pdoc->LinesTotal() - linesBefore;
+			searchEnd += lengthInserted - lengthFound;
+			lastReplaced = pos + lengthInserted;
+			if (replacements == 0)
+				firstReplaced = pos;
+			replacements++;
+			if (lengthFound > 0) {
+				searchFrom = lastReplaced;
+			} else if (lastReplaced < searchEnd) {
+				searchFrom = pdoc->MovePositionOutsideChar(lastReplaced + 1, 1, true);
+			} else {
+				break;
+			}
+		}
+	} catch (RegexError &) {
+		errorStatus = SC_STATUS_WARN_REGEX;
+		failed = true;
+	} catch (...) {
+		replacingAll = false;
+		if (replacements > 0)
+			NotifyReplacedAll(firstReplaced, lastReplaced, linesAdded);
+		throw;
+	}
+	replacingAll = false;
+	if (replacements > 0) {
+		NotifyReplacedAll(firstReplaced, lastReplaced, linesAdded);
+		// The display updates left out while replacing
+		QueueIdleWork(WorkNeeded::workStyle, linesAdded ? pdoc->Length() : lastReplaced);
+		SetScrollBars();
+		Redraw();
+		targetStart = firstReplaced;
+		targetEnd = lastReplaced;
+	}
+	return failed ? -1 : replacements;
+}
+
+void Editor::NotifyReplacedAll(int firstReplaced, int lastReplaced, int linesAdded) {
+	const int modificationType = SC_MOD_INSERTTEXT | SC_MOD_DELETETEXT | SC_MOD_REPLACEALL | SC_PERFORMED_USER;
+	if (modificationType & modEventMask) {
+		NotifyChange();	// Send EN_CHANGE
+
+		SCNotification scn = {};
+		scn.nmhdr.code = SCN_MODIFIED;
+		scn.position = firstReplaced;
+		scn.modificationType = modificationType;
+		scn.length = lastReplaced - firstReplaced;
+		scn.linesAdded = linesAdded;
+		scn.line = pdoc->LineFromPosition(firstReplaced);
+		NotifyParent(scn);
+	}
+}
+
 bool Editor::IsUnicodeMode() const {
 	return pdoc && (SC_CP_UTF8 == pdoc->dbcsCodePage);
 }
@@ -5924,6 +6107,10 @@ sptr_t Editor::WndProc(unsigned int iMessage, uptr_t wParam, sptr_t lParam) {
 		PLATFORM_ASSERT(lParam);
 		return SearchInTarget(CharPtrFromSPtr(lParam), static_cast<int>(wParam));
 
+	case SCI_REPLACEALLINTARGET:
+		PLATFORM_ASSERT(wParam && lParam);
+		return ReplaceAllInTarget(reinterpret_cast<const char *>(wParam), CharPtrFromSPtr(lParam));
+
 	case SCI_SETSEARCHFLAGS:
 		searchFlags = static_cast<int>(wParam);
 		break;
@@ -6103,6 +6290,16 @@ sptr_t Editor::WndProc(unsigned int iMessage, uptr_t wParam, sptr_t lParam) {
 		pdoc->EndUndoAction();
 		return 0;
 
+	case SCI_SETUNDOMEMORYLIMIT:
+		pdoc->SetUndoMemoryLimit(static_cast<int>(wParam));
+		return 0;
+
+	case SCI_GETUNDOMEMORYLIMIT:
+		return pdoc->GetUndoMemoryLimit();
+
+	case SCI_GETUNDOMEMORY:
+		return pdoc->UndoMemory();
+
 	case SCI_GETCARETPERIOD:
 		return caret.period;
 
@@ -6491,6 +6688,15 @@ sptr_t Editor::WndProc(unsigned int iMessage, uptr_t wParam, sptr_t lParam) {
 	case SCI_GETIDLESTYLING:
 		return idleStyling;
 
+	case SCI_SETBACKGROUNDLEXING:
+		backgroundLexing = wParam != 0;
+		if (backgroundLexing)
+			StartIdleStyling(false);
+		break;
+
+	case SCI_GETBACKGROUNDLEXING:
+		return backgroundLexing;
+
 	case SCI_SETWRAPMODE:
 		if (vs.SetWrapState(static_cast<int>(wParam))) {
 			xOffset = 0;
@@ -6549,6 +6755,22 @@ sptr_t Editor::WndProc(unsigned int iMessage, uptr_t wParam, sptr_t lParam) {
 	case SCI_GETLAYOUTCACHE:
 		return view.llc.GetLevel();
 
+	case SCI_SETLAYOUTCACHEBUDGET:
+		view.llc.SetBudget(wParam);
+		break;
+
+	case SCI_GETLAYOUTCACHEBUDGET:
+		return view.llc.GetBudget();
+
+	case SCI_GETLAYOUTCACHEMEMORY:
+		return view.llc.MemoryUsage();
+
+	case SCI_GETLAYOUTCACHEHITS:
+		return view.llc.Hits();
+
+	case SCI_GETLAYOUTCACHEMISSES:
+		return view.llc.Misses();
+
 	case SCI_SETPOSITIONCACHE:
 		view.posCache.SetSize(wParam);
 		break;
@@ -6556,6 +6778,9 @@ sptr_t Editor::WndProc(unsigned int iMessage, uptr_t wParam, sptr_t lParam) {
 	case SCI_GETPOSITIONCACHE:
 		return view.posCache.GetSize();
 
+	case SCI_GETPOSITIONCACHESTATISTIC:
+		return view.posCache.Statistic(wParam);
+
 	case SCI_SETSCROLLWIDTH:
 		PLATFORM_ASSERT(wParam > 0);
 		if ((wParam > 0) && (wParam != static_cast<unsigned int >(scrollWidth))) {
@@ -7452,11 +7677,14 @@ sptr_t Editor::WndProc(unsigned int iMessage, uptr_t wParam, sptr_t lParam) {
 		return 0;
 
 	case SCI_CREATEDOCUMENT: {
-			Document *doc = new Document();
+			Document *doc = new Document(static_cast<int>(lParam));
 			doc->AddRef();
 			return reinterpret_cast<sptr_t>(doc);
 		}
 
+	case SCI_GETDOCUMENTOPTIONS:
+		return pdoc->Options();
+
 	case SCI_ADDREFDOCUMENT:
 		(reinterpret_cast<Document *>(lParam))->AddRef();
 		break;
@@ -7466,13 +7694,20 @@ sptr_t Editor::WndProc(unsigned int iMessage, uptr_t wParam, sptr_t lParam) {
 		break;
 
 	case SCI_CREATELOADER: {
-			Document *doc = new Document();
+			Document *doc = new Document(static_cast<int>(lParam));
 			doc->AddRef();
 			doc->Allocate(static_cast<int>(wParam));
 			doc->SetUndoCollection(false);
 			return reinterpret_cast<sptr_t>(static_cast<ILoader *>(doc));
 		}
 
+	case SCI_CREATEMAPPEDDOCUMENT: {
+			Document *doc = new Document(static_cast<int>(wParam));
+			doc->AddRef();
+			doc->SetMappedText(reinterpret_cast<IMappedText *>(lParam));
+			return reinterpret_cast<sptr_t>(doc);
+		}
+
 	case SCI_SETMODEVENTMASK:
 		modEventMask = static_cast<int>(wParam);
 		return 0;
@@ -7674,6 +7909,9 @@ sptr_t Editor::WndProc(unsigned int iMessage, uptr_t wParam, sptr_t lParam) {
 	case SCI_GETGAPPOSITION:
 		return pdoc->GapPosition();
 
+	case SCI_GETCHANGESTAMP:
+		return pdoc->GetChangeStamp();
+
 	case SCI_SETEXTRAASCENT:
 		vs.extraAscent = static_cast<int>(wParam);
 		InvalidateStyleRedraw();
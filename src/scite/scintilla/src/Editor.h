@@ -231,9 +231,11 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 	PRectangle rcPaint;
 	bool paintingAllText;
 	bool willRedrawAll;
+	bool replacingAll;	///< Redraw once when a replace all finishes instead of for each replacement
 	WorkNeeded workNeeded;
 	int idleStyling;
 	bool needIdleStyling;
+	bool backgroundLexing;
 
 	int modEventMask;
 
@@ -256,6 +258,7 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 
 	// Wrapping support
 	WrapPending wrapPending;
+	BackgroundWrap backgroundWrap;
 
 	bool convertPastes;
 
@@ -371,6 +374,9 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 	bool Wrapping() const;
 	void NeedWrapping(int docLineStart=0, int docLineEnd=WrapPending::lineLarge);
 	bool WrapOneLine(Surface *surface, int lineToWrap);
+	bool WrappingInBackground() const;
+	bool MergeBackgroundWrap(Surface *surface, int linesMeasured);
+	bool WrapInBackground(Surface *surface, int linesMeasured);
 	enum wrapScope {wsAll, wsVisible, wsIdle};
 	bool WrapLines(enum wrapScope ws);
 	void LinesJoin();
@@ -555,6 +561,8 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 
 	int GetTag(char *tagValue, int tagNumber);
 	int ReplaceTarget(bool replacePatterns, const char *text, int length=-1);
+	int ReplaceAllInTarget(const char *text, const char *replacement);
+	void NotifyReplacedAll(int firstReplaced, int lastReplaced, int linesAdded);
 
 	bool PositionIsHotspot(int position) const;
 	bool PointIsHotspot(Point pt);
@@ -17,6 +17,7 @@
 #include "Position.h"
 #include "SplitVector.h"
 #include "Partitioning.h"
+#include "ChunkedVector.h"
 #include "CellBuffer.h"
 #include "PerLine.h"
 
@@ -24,6 +24,7 @@
 #include "Position.h"
 #include "SplitVector.h"
 #include "Partitioning.h"
+#include "ChunkedVector.h"
 #include "RunStyles.h"
 #include "ContractionState.h"
 #include "CellBuffer.h"
@@ -244,9 +245,256 @@ int LineLayout::EndLineStyle() const {
 	return styles[numCharsBeforeEOL > 0 ? numCharsBeforeEOL-1 : 0];
 }
 
+size_t LineLayout::MemoryUsage() const {
+	size_t bytes = sizeof(LineLayout) + lenLineStarts * sizeof(int);
+	if (maxLineLength >= 0)
+		bytes += (maxLineLength + 1) * 2 + (maxLineLength + 2) * sizeof(XYPOSITION);
+	return bytes;
+}
+
+FixedPitchSettings::FixedPitchSettings(const ViewStyle &vstyle, const SpecialRepresentations &reprs_,
+	int tabWidthMinimumPixels_, bool tabs_) :
+	styles(&vstyle.fixedPitch), reprs(&reprs_), tabWidth(vstyle.tabWidth),
+	lastSegItalicsOffset(vstyle.lastSegItalicsOffset), tabWidthMinimumPixels(tabWidthMinimumPixels_), tabs(tabs_) {
+}
+
+WrapParameters::WrapParameters(const ViewStyle &vstyle, int indentSize_) :
+	wrapState(vstyle.wrapState), visualFlags(vstyle.wrapVisualFlags), indentMode(vstyle.wrapIndentMode),
+	visualStartIndent(vstyle.wrapVisualStartIndent), indentSize(indentSize_),
+	aveCharWidth(vstyle.aveCharWidth), spaceWidth(vstyle.spaceWidth) {
+}
+
+// Set positions for lines which only contain graphic ASCII characters and tabs in fixed pitch
+// or invisible styles. Returns false, leaving positions unchanged, for other lines.
+bool LineLayout::LayoutFixedPitch(const FixedPitchSettings &fps) {
+	const std::vector<FixedPitchStyle> &fpStyles = *fps.styles;
+	for (int i = 0; i < numCharsInLine; i++) {
+		if (chars[i] == '\t') {
+			if (!fps.tabs || !fps.reprs->Contains(chars + i, 1))
+				return false;
+		} else if ((chars[i] < ' ') || (chars[i] > '~') || fps.reprs->Contains(chars + i, 1)) {
+			return false;
+		}
+		if ((styles[i] >= fpStyles.size()) || (fpStyles[styles[i]].visible && !fpStyles[styles[i]].fixed))
+			return false;
+	}
+	bool lastSegItalics = false;
+	int start = 0;
+	while (start < numCharsInLine) {
+		const FixedPitchStyle &fpStyle = fpStyles[styles[start]];
+		int end = start + 1;
+		if (chars[start] != '\t') {
+			while ((end < numCharsInLine) && (styles[end] == styles[start]) && (chars[end] != '\t'))
+				end++;
+		}
+		const XYPOSITION x = positions[start];
+		if (!fpStyle.visible) {
+			std::fill(positions + start + 1, positions + end + 1, x);
+		} else if (chars[start] == '\t') {
+			positions[end] = (static_cast<int>((x + fps.tabWidthMinimumPixels) / fps.tabWidth) + 1) * fps.tabWidth;
+			lastSegItalics = false;
+		} else if ((end == start + 1) && (chars[start] == ' ')) {
+			positions[end] = x + fpStyle.spaceWidth;
+			lastSegItalics = false;
+		} else {
+			for (int i = start + 1; i <= end; i++)
+				positions[i] = x + fpStyle.charWidth * (i - start);
+			lastSegItalics = (chars[end - 1] != ' ') && fpStyle.italic;
+		}
+		start = end;
+	}
+	// Same allowance as for measured lines so italics are not cut off
+	if (lastSegItalics) {
+		positions[numCharsInLine] += fps.lastSegItalicsOffset;
+	}
+	return true;
+}
+
+static int MovePositionOutsideChar(const Document *pdoc, int posLineStart, int pos, int moveDir) {
+	// Lines laid out without a document only contain single byte characters
+	if (pdoc)
+		return pdoc->MovePositionOutsideChar(pos + posLineStart, moveDir) - posLineStart;
+	return pos;
+}
+
+// Calculate line start positions based upon width.
+void LineLayout::WrapToWidth(const WrapParameters &wp, int width, const Document *pdoc, int posLineStart) {
+	widthLine = width;
+	if (width == wrapWidthInfinite) {
+		lines = 1;
+	} else if (width > positions[numCharsInLine]) {
+		// Simple common case where line does not need wrapping.
+		lines = 1;
+	} else {
+		if (wp.visualFlags & SC_WRAPVISUALFLAG_END) {
+			width -= static_cast<int>(wp.aveCharWidth); // take into account the space for end wrap mark
+		}
+		XYPOSITION wrapAddIndent = 0; // This will be added to initial indent of line
+		if (wp.indentMode == SC_WRAPINDENT_INDENT) {
+			wrapAddIndent = wp.indentSize * wp.spaceWidth;
+		} else if (wp.indentMode == SC_WRAPINDENT_FIXED) {
+			wrapAddIndent = wp.visualStartIndent * wp.aveCharWidth;
+		}
+		wrapIndent = wrapAddIndent;
+		if (wp.indentMode != SC_WRAPINDENT_FIXED)
+		for (int i = 0; i < numCharsInLine; i++) {
+			if (!IsSpaceOrTab(chars[i])) {
+				wrapIndent += positions[i]; // Add line indent
+				break;
+			}
+		}
+		// Check for text width minimum
+		if (wrapIndent > width - static_cast<int>(wp.aveCharWidth) * 15)
+			wrapIndent = wrapAddIndent;
+		// Check for wrapIndent minimum
+		if ((wp.visualFlags & SC_WRAPVISUALFLAG_START) && (wrapIndent < wp.aveCharWidth))
+			wrapIndent = wp.aveCharWidth; // Indent to show start visual
+		lines = 0;
+		int lastGoodBreak = 0;
+		int lastLineStart = 0;
+		XYACCUMULATOR startOffset = 0;
+		int p = 0;
+		while (p < numCharsInLine) {
+			if ((positions[p + 1] - startOffset) >= width) {
+				if (lastGoodBreak == lastLineStart) {
+					// Try moving to start of last character
+					if (p > 0) {
+						lastGoodBreak = MovePositionOutsideChar(pdoc, posLineStart, p, -1);
+					}
+					if (lastGoodBreak == lastLineStart) {
+						// Ensure at least one character on line.
+						lastGoodBreak = MovePositionOutsideChar(pdoc, posLineStart, lastGoodBreak + 1, 1);
+					}
+				}
+				lastLineStart = lastGoodBreak;
+				lines++;
+				SetLineStart(lines, lastGoodBreak);
+				startOffset = positions[lastGoodBreak];
+				// take into account the space for start wrap mark and indent
+				startOffset -= wrapIndent;
+				p = lastGoodBreak + 1;
+				continue;
+			}
+			if (p > 0) {
+				if (wp.wrapState == eWrapChar) {
+					lastGoodBreak = MovePositionOutsideChar(pdoc, posLineStart, p, -1);
+					p = MovePositionOutsideChar(pdoc, posLineStart, p + 1, 1);
+					continue;
+				} else if ((wp.wrapState == eWrapWord) && (styles[p] != styles[p - 1])) {
+					lastGoodBreak = p;
+				} else if (IsSpaceOrTab(chars[p - 1]) && !IsSpaceOrTab(chars[p])) {
+					lastGoodBreak = p;
+				}
+			}
+			p++;
+		}
+		lines++;
+	}
+	validity = llLines;
+}
+
+CompactLineLayout::CompactLineLayout(const LineLayout &ll) :
+	lineNumber(ll.lineNumber),
+	numCharsInLine(ll.numCharsInLine),
+	numCharsBeforeEOL(ll.numCharsBeforeEOL),
+	validity(ll.validity),
+	edgeColumn(ll.edgeColumn),
+	widthLine(ll.widthLine),
+	lines(ll.lines),
+	wrapIndent(ll.wrapIndent),
+	startPosition(ll.positions[0]),
+	chars(ll.chars, ll.chars + ll.numCharsInLine + 1) {
+	for (int i = 0; i <= numCharsInLine; i++) {
+		if (styleRuns.empty() || (styleRuns.back().style != ll.styles[i])) {
+			StyleRun run = { i + 1, ll.styles[i] };
+			styleRuns.push_back(run);
+		} else {
+			styleRuns.back().end = i + 1;
+		}
+	}
+	std::vector<StyleRun>(styleRuns).swap(styleRuns);
+
+	// A width is only stored when adding it to the previous position gives exactly the next position.
+	widths.reserve(numCharsInLine);
+	XYPOSITION x = startPosition;
+	for (int i = 0; i < numCharsInLine; i++) {
+		const XYPOSITION scaled = (ll.positions[i + 1] - x) * widthScale;
+		const unsigned short width = static_cast<unsigned short>(
+			((scaled >= 0) && (scaled < widthExact)) ? scaled : static_cast<XYPOSITION>(widthExact));
+		if ((width != widthExact) && (x + static_cast<XYPOSITION>(width) / widthScale == ll.positions[i + 1])) {
+			widths.push_back(width);
+		} else {
+			widths.push_back(widthExact);
+			exactPositions.push_back(ll.positions[i + 1]);
+		}
+		x = ll.positions[i + 1];
+	}
+	if (exactPositions.size() * 2 > widths.size()) {
+		// Mostly exact so just keep the positions.
+		widths.clear();
+		std::vector<unsigned short>().swap(widths);
+		exactPositions.assign(ll.positions + 1, ll.positions + numCharsInLine + 1);
+	}
+	std::vector<XYPOSITION>(exactPositions).swap(exactPositions);
+
+	if ((lines > 1) && ll.lineStarts) {
+		lineStarts.assign(ll.lineStarts, ll.lineStarts + std::min(lines + 1, ll.lenLineStarts));
+	}
+}
+
+LineLayout *CompactLineLayout::Expand(int maxChars) const {
+	LineLayout *ll = new LineLayout(std::max(maxChars, numCharsInLine));
+	ll->lineNumber = lineNumber;
+	ll->numCharsInLine = numCharsInLine;
+	ll->numCharsBeforeEOL = numCharsBeforeEOL;
+	ll->validity = validity;
+	ll->edgeColumn = edgeColumn;
+	ll->widthLine = widthLine;
+	ll->lines = lines;
+	ll->wrapIndent = wrapIndent;
+	std::copy(chars.begin(), chars.end(), ll->chars);
+	int start = 0;
+	for (std::vector<StyleRun>::const_iterator it = styleRuns.begin(); it != styleRuns.end(); ++it) {
+		std::fill(ll->styles + start, ll->styles + it->end, it->style);
+		start = it->end;
+	}
+	ll->positions[0] = startPosition;
+	if (widths.empty()) {
+		std::copy(exactPositions.begin(), exactPositions.end(), ll->positions + 1);
+	} else {
+		std::vector<XYPOSITION>::const_iterator exact = exactPositions.begin();
+		for (int i = 0; i < numCharsInLine; i++) {
+			if (widths[i] == widthExact) {
+				ll->positions[i + 1] = *exact;
+				++exact;
+			} else {
+				ll->positions[i + 1] = ll->positions[i] + static_cast<XYPOSITION>(widths[i]) / widthScale;
+			}
+		}
+	}
+	for (size_t line = 1; line < lineStarts.size(); line++) {
+		ll->SetLineStart(static_cast<int>(line), lineStarts[line]);
+	}
+	return ll;
+}
+
+void CompactLineLayout::Invalidate(LineLayout::validLevel validity_) {
+	if (validity > validity_)
+		validity = validity_;
+}
+
+size_t CompactLineLayout::MemoryUsage() const {
+	return sizeof(CompactLineLayout) + chars.capacity() +
+		styleRuns.capacity() * sizeof(StyleRun) +
+		widths.capacity() * sizeof(unsigned short) +
+		exactPositions.capacity() * sizeof(XYPOSITION) +
+		lineStarts.capacity() * sizeof(int);
+}
+
 LineLayoutCache::LineLayoutCache() :
 	level(0),
-	allInvalidated(false), styleClock(-1), useCount(0) {
+	allInvalidated(false), styleClock(-1), useCount(0),
+	budget(0), bytesCompact(0), clock(0), hotLimit(1), hits(0), misses(0) {
 	Allocate(0);
 }
 
@@ -258,6 +506,10 @@ void LineLayoutCache::Allocate(size_t length_) {
 	PLATFORM_ASSERT(cache.empty());
 	allInvalidated = false;
 	cache.resize(length_);
+	if (Budgeted()) {
+		compact.resize(length_);
+		lastUse.resize(length_);
+	}
 }
 
 void LineLayoutCache::AllocateForLevel(int linesOnScreen, int linesInDoc) {
@@ -270,7 +522,12 @@ void LineLayoutCache::AllocateForLevel(int linesOnScreen, int linesInDoc) {
 	} else if (level == llcDocument) {
 		lengthForLevel = linesInDoc;
 	}
-	if (lengthForLevel > cache.size()) {
+	if (Budgeted() && (lengthForLevel > cache.size())) {
+		// Keep the layouts as each is checked against its line before it is used.
+		cache.resize(lengthForLevel);
+		compact.resize(lengthForLevel);
+		lastUse.resize(lengthForLevel);
+	} else if (lengthForLevel > cache.size()) {
 		Deallocate();
 		Allocate(lengthForLevel);
 	} else {
@@ -279,8 +536,23 @@ void LineLayoutCache::AllocateForLevel(int linesOnScreen, int linesInDoc) {
 				delete cache[i];
 				cache[i] = 0;
 			}
+			for (size_t i = lengthForLevel; i < compact.size(); i++) {
+				if (compact[i]) {
+					bytesCompact -= compact[i]->MemoryUsage();
+					delete compact[i];
+					compact[i] = 0;
+				}
+			}
+			for (size_t i = hotLines.size(); i > 0; i--) {
+				if (hotLines[i - 1] >= static_cast<int>(lengthForLevel))
+					hotLines.erase(hotLines.begin() + i - 1);
+			}
 		}
 		cache.resize(lengthForLevel);
+		if (Budgeted()) {
+			compact.resize(lengthForLevel);
+			lastUse.resize(lengthForLevel);
+		}
 	}
 	PLATFORM_ASSERT(cache.size() == lengthForLevel);
 }
@@ -290,6 +562,18 @@ void LineLayoutCache::Deallocate() {
 	for (size_t i = 0; i < cache.size(); i++)
 		delete cache[i];
 	cache.clear();
+	DeallocateCompact();
+	compact.clear();
+	lastUse.clear();
+	hotLines.clear();
+}
+
+void LineLayoutCache::DeallocateCompact() {
+	for (size_t i = 0; i < compact.size(); i++) {
+		delete compact[i];
+		compact[i] = 0;
+	}
+	bytesCompact = 0;
 }
 
 void LineLayoutCache::Invalidate(LineLayout::validLevel validity_) {
@@ -299,6 +583,15 @@ void LineLayoutCache::Invalidate(LineLayout::validLevel validity_) {
 				cache[i]->Invalidate(validity_);
 			}
 		}
+		if (validity_ == LineLayout::llInvalid) {
+			DeallocateCompact();
+		} else {
+			for (size_t i = 0; i < compact.size(); i++) {
+				if (compact[i]) {
+					compact[i]->Invalidate(validity_);
+				}
+			}
+		}
 		if (validity_ == LineLayout::llInvalid) {
 			allInvalidated = true;
 		}
@@ -344,7 +637,24 @@ LineLayout *LineLayoutCache::Retrieve(int lineNumber, int lineCaret, int maxChar
 					cache[pos] = 0;
 				}
 			}
-			if (!cache[pos]) {
+			if (Budgeted()) {
+				if (!cache[pos] && compact[pos] && (compact[pos]->LineNumber() == lineNumber)) {
+					cache[pos] = compact[pos]->Expand(maxChars);
+				}
+				if (compact[pos]) {
+					bytesCompact -= compact[pos]->MemoryUsage();
+					delete compact[pos];
+					compact[pos] = 0;
+				}
+				if (std::find(hotLines.begin(), hotLines.end(), pos) == hotLines.end())
+					hotLines.push_back(pos);
+				lastUse[pos] = ++clock;
+				hotLimit = linesOnScreen + 1;
+			}
+			if (cache[pos]) {
+				hits++;
+			} else {
+				misses++;
 				cache[pos] = new LineLayout(maxChars);
 			}
 			cache[pos]->lineNumber = lineNumber;
@@ -355,6 +665,7 @@ LineLayout *LineLayoutCache::Retrieve(int lineNumber, int lineCaret, int maxChar
 	}
 
 	if (!ret) {
+		misses++;
 		ret = new LineLayout(maxChars);
 		ret->lineNumber = lineNumber;
 	}
@@ -369,8 +680,74 @@ void LineLayoutCache::Dispose(LineLayout *ll) {
 			delete ll;
 		} else {
 			useCount--;
+			if (Budgeted() && (useCount == 0)) {
+				EnforceBudget();
+			}
+		}
+	}
+}
+
+void LineLayoutCache::PackLine(int line) {
+	LineLayout *ll = cache[line];
+	if (ll && (ll->validity >= LineLayout::llPositions)) {
+		compact[line] = new CompactLineLayout(*ll);
+		bytesCompact += compact[line]->MemoryUsage();
+	}
+	delete ll;
+	cache[line] = 0;
+}
+
+void LineLayoutCache::EnforceBudget() {
+	// Pack the least recently used full layouts beyond about a page.
+	while (hotLines.size() > hotLimit) {
+		std::vector<int>::iterator oldest = hotLines.begin();
+		for (std::vector<int>::iterator it = hotLines.begin(); it != hotLines.end(); ++it) {
+			if (lastUse[*it] < lastUse[*oldest])
+				oldest = it;
 		}
+		PackLine(*oldest);
+		hotLines.erase(oldest);
+	}
+
+	size_t bytesHot = 0;
+	for (std::vector<int>::const_iterator it = hotLines.begin(); it != hotLines.end(); ++it) {
+		if (cache[*it])
+			bytesHot += cache[*it]->MemoryUsage();
+	}
+	if (bytesHot + bytesCompact <= budget)
+		return;
+
+	// Discard the least recently used packed layouts until a quarter below the budget
+	// so that this does not happen again for a while.
+	std::vector<std::pair<unsigned int, int> > packed;
+	for (size_t i = 0; i < compact.size(); i++) {
+		if (compact[i])
+			packed.push_back(std::pair<unsigned int, int>(lastUse[i], static_cast<int>(i)));
 	}
+	std::sort(packed.begin(), packed.end());
+	const size_t target = budget - budget / 4;
+	for (size_t i = 0; (i < packed.size()) && (bytesHot + bytesCompact > target); i++) {
+		const int line = packed[i].second;
+		bytesCompact -= compact[line]->MemoryUsage();
+		delete compact[line];
+		compact[line] = 0;
+	}
+}
+
+void LineLayoutCache::SetBudget(size_t budget_) {
+	if (budget != budget_) {
+		Deallocate();
+		budget = budget_;
+	}
+}
+
+size_t LineLayoutCache::MemoryUsage() const {
+	size_t bytes = bytesCompact;
+	for (size_t i = 0; i < cache.size(); i++) {
+		if (cache[i])
+			bytes += cache[i]->MemoryUsage();
+	}
+	return bytes;
 }
 
 // Simply pack the (maximum 4) character bytes into an int
@@ -555,14 +932,15 @@ bool BreakFinder::More() const {
 }
 
 PositionCacheEntry::PositionCacheEntry() :
-	styleNumber(0), len(0), clock(0), positions(0) {
+	styleNumber(0), len(0), hash(0), clock(0), positions(0) {
 }
 
 void PositionCacheEntry::Set(unsigned int styleNumber_, const char *s_,
-	unsigned int len_, XYPOSITION *positions_, unsigned int clock_) {
+	unsigned int len_, XYPOSITION *positions_, unsigned int hash_, unsigned int clock_) {
 	Clear();
 	styleNumber = styleNumber_;
 	len = len_;
+	hash = hash_;
 	clock = clock_;
 	if (s_ && positions_) {
 		positions = new XYPOSITION[len + (len / 4) + 1];
@@ -582,12 +960,24 @@ void PositionCacheEntry::Clear() {
 	positions = 0;
 	styleNumber = 0;
 	len = 0;
+	hash = 0;
 	clock = 0;
 }
 
+void PositionCacheEntry::Take(PositionCacheEntry &other) {
+	Clear();
+	styleNumber = other.styleNumber;
+	len = other.len;
+	hash = other.hash;
+	clock = other.clock;
+	positions = other.positions;
+	other.positions = 0;
+	other.Clear();
+}
+
 bool PositionCacheEntry::Retrieve(unsigned int styleNumber_, const char *s_,
-	unsigned int len_, XYPOSITION *positions_) const {
-	if ((styleNumber == styleNumber_) && (len == len_) &&
+	unsigned int len_, XYPOSITION *positions_, unsigned int hash_) const {
+	if (positions && (hash == hash_) && (styleNumber == styleNumber_) && (len == len_) &&
 		(memcmp(reinterpret_cast<char *>(reinterpret_cast<void *>(positions + len)), s_, len)== 0)) {
 		for (unsigned int i=0; i<len; i++) {
 			positions_[i] = positions[i];
@@ -621,10 +1011,11 @@ void PositionCacheEntry::ResetClock() {
 	}
 }
 
-PositionCache::PositionCache() {
-	clock = 1;
-	pces.resize(0x400);
-	allClear = true;
+PositionCache::PositionCache() :
+	seenLongCount(0), sizeRequested(0), clock(1), allClear(true),
+	hits(0), misses(0), evictions(0), longHits(0),
+	windowHits(0), windowMisses(0), windowEvictions(0) {
+	SetSize(0x400);
 }
 
 PositionCache::~PositionCache() {
@@ -636,6 +1027,8 @@ void PositionCache::Clear() {
 		for (size_t i=0; i<pces.size(); i++) {
 			pces[i].Clear();
 		}
+		seenLong.assign(seenLong.size(), false);
+		seenLongCount = 0;
 	}
 	clock = 1;
 	allClear = true;
@@ -643,41 +1036,144 @@ void PositionCache::Clear() {
 
 void PositionCache::SetSize(size_t size_) {
 	Clear();
-	pces.resize(size_);
+	std::vector<PositionCacheEntry>(size_).swap(pces);
+	seenLong.assign(size_ * 2, false);
+	seenLongCount = 0;
+	sizeRequested = size_;
 }
 
-void PositionCache::MeasureWidths(Surface *surface, const ViewStyle &vstyle, unsigned int styleNumber,
-	const char *s, unsigned int len, XYPOSITION *positions, Document *pdoc) {
+int PositionCache::Statistic(int statistic) const {
+	switch (statistic) {
+	case SC_POSITIONCACHE_HITS:
+		return hits;
+	case SC_POSITIONCACHE_MISSES:
+		return misses;
+	case SC_POSITIONCACHE_EVICTIONS:
+		return evictions;
+	case SC_POSITIONCACHE_LONGHITS:
+		return longHits;
+	default:
+		return 0;
+	}
+}
 
-	allClear = false;
-	size_t probe = pces.size();	// Out of bounds
-	if ((!pces.empty()) && (len < 30)) {
-		// Only store short strings in the cache so it doesn't churn with
-		// long comments with only a single comment.
+size_t PositionCache::Ways() const {
+	return std::min(static_cast<size_t>(ways), pces.size());
+}
 
-		// Two way associative: try two probe positions.
-		unsigned int hashValue = PositionCacheEntry::Hash(styleNumber, s, len);
-		probe = hashValue % pces.size();
-		if (pces[probe].Retrieve(styleNumber, s, len, positions)) {
-			return;
+unsigned int PositionCache::Tick() {
+	clock++;
+	if (clock > 0xf0000000u) {
+		// Wrap the clock round and reset all cache entries so none get stuck with a high clock.
+		for (size_t i=0; i<pces.size(); i++) {
+			pces[i].ResetClock();
 		}
-		unsigned int probe2 = (hashValue * 37) % pces.size();
-		if (pces[probe2].Retrieve(styleNumber, s, len, positions)) {
-			return;
+		clock = 2;
+	}
+	return clock;
+}
+
+PositionCacheEntry *PositionCache::Slot(unsigned int hashValue) {
+	const size_t sets = pces.size() / Ways();
+	return &pces[(hashValue % sets) * Ways()];
+}
+
+bool PositionCache::Admit(unsigned int hashValue, unsigned int len) {
+	if (len < lengthShort) {
+		return true;
+	}
+	// Long runs are only stored once they recur.
+	const size_t bit = hashValue % seenLong.size();
+	if (seenLong[bit]) {
+		return true;
+	}
+	seenLong[bit] = true;
+	seenLongCount++;
+	if (seenLongCount > seenLong.size() / 2) {
+		seenLong.assign(seenLong.size(), false);
+		seenLongCount = 0;
+	}
+	return false;
+}
+
+void PositionCache::Grow() {
+	std::vector<PositionCacheEntry> entries(pces.size() * 2);
+	entries.swap(pces);
+	seenLong.assign(pces.size() * 2, false);
+	seenLongCount = 0;
+	for (size_t i=0; i<entries.size(); i++) {
+		if (!entries[i].Empty()) {
+			PositionCacheEntry *set = Slot(entries[i].HashValue());
+			for (size_t way=0; way<Ways(); way++) {
+				if (set[way].Empty()) {
+					set[way].Take(entries[i]);
+					break;
+				}
+			}
 		}
-		// Not found. Choose the oldest of the two slots to replace
-		if (pces[probe].NewerThan(pces[probe2])) {
-			probe = probe2;
+	}
+}
+
+void PositionCache::MeasureSegment(Surface *surface, const ViewStyle &vstyle, unsigned int styleNumber,
+	const char *s, unsigned int len, XYPOSITION *positions) {
+
+	PositionCacheEntry *set = 0;
+	unsigned int hashValue = 0;
+	if (!pces.empty() && (len > 0)) {
+		hashValue = PositionCacheEntry::Hash(styleNumber, s, len);
+		set = Slot(hashValue);
+		for (size_t way=0; way<Ways(); way++) {
+			if (set[way].Retrieve(styleNumber, s, len, positions, hashValue)) {
+				set[way].Touch(Tick());
+				hits++;
+				windowHits++;
+				if (len >= lengthShort)
+					longHits++;
+				return;
+			}
+		}
+		misses++;
+		windowMisses++;
+	}
+	FontAlias fontStyle = vstyle.styles[styleNumber].font;
+	surface->MeasureWidths(fontStyle, s, len, positions);
+	if (set && Admit(hashValue, len)) {
+		// Store into an empty way of the set or else the least recently used
+		allClear = false;
+		PositionCacheEntry *victim = set;
+		for (size_t way=0; way<Ways() && !victim->Empty(); way++) {
+			if (set[way].Empty() || victim->NewerThan(set[way])) {
+				victim = &set[way];
+			}
+		}
+		if (!victim->Empty()) {
+			evictions++;
+			windowEvictions++;
+		}
+		victim->Set(styleNumber, s, len, positions, hashValue, Tick());
+	}
+	if (windowHits + windowMisses >= windowLookups) {
+		// Grow when lookups often miss because entries were evicted rather than because text was new.
+		if ((windowHits * 10 < (windowHits + windowMisses) * 9) && (windowEvictions * 4 > windowMisses) &&
+			(pces.size() * 2 <= sizeRequested * growthLimit)) {
+			Grow();
 		}
+		windowHits = 0;
+		windowMisses = 0;
+		windowEvictions = 0;
 	}
+}
+
+void PositionCache::MeasureWidths(Surface *surface, const ViewStyle &vstyle, unsigned int styleNumber,
+	const char *s, unsigned int len, XYPOSITION *positions, Document *pdoc) {
+
 	if (len > BreakFinder::lengthStartSubdivision) {
-		// Break up into segments
+		// Break up into segments, each of which can be cached
 		unsigned int startSegment = 0;
 		XYPOSITION xStartSegment = 0;
 		while (startSegment < len) {
 			unsigned int lenSegment = pdoc->SafeSegment(s + startSegment, len - startSegment, BreakFinder::lengthEachSubdivision);
-			FontAlias fontStyle = vstyle.styles[styleNumber].font;
-			surface->MeasureWidths(fontStyle, s + startSegment, lenSegment, positions + startSegment);
+			MeasureSegment(surface, vstyle, styleNumber, s + startSegment, lenSegment, positions + startSegment);
 			for (unsigned int inSeg = 0; inSeg < lenSegment; inSeg++) {
 				positions[startSegment + inSeg] += xStartSegment;
 			}
@@ -685,20 +1181,215 @@ void PositionCache::MeasureWidths(Surface *surface, const ViewStyle &vstyle, uns
 			startSegment += lenSegment;
 		}
 	} else {
-		FontAlias fontStyle = vstyle.styles[styleNumber].font;
-		surface->MeasureWidths(fontStyle, s, len, positions);
-	}
-	if (probe < pces.size()) {
-		// Store into cache
-		clock++;
-		if (clock > 60000) {
-			// Since there are only 16 bits for the clock, wrap it round and
-			// reset all cache entries so none get stuck with a high clock.
-			for (size_t i=0; i<pces.size(); i++) {
-				pces[i].ResetClock();
+		MeasureSegment(surface, vstyle, styleNumber, s, len, positions);
+	}
+}
+
+WrapBatch::WrapBatch(const ViewStyle &vstyle, const SpecialRepresentations &reprs_, int tabWidthMinimumPixels, bool tabs,
+	int indentSize, int width_, const Document *pdoc, int lineFirst, int lineLast) :
+	fixedPitchStyles(vstyle.fixedPitch), reprs(reprs_), fps(vstyle, reprs_, tabWidthMinimumPixels, tabs),
+	wp(vstyle, indentSize), width(std::max(width_, 20)), state(wbPending), abandoned(false), merged(0) {
+	// Point at this batch's copies so the view can change while it is being wrapped
+	fps.styles = &fixedPitchStyles;
+	fps.reprs = &reprs;
+	const int posFirst = pdoc->LineStart(lineFirst);
+	const int lengthText = pdoc->LineStart(lineLast) - posFirst;
+	chars.resize(lengthText + 1);
+	styles.resize(lengthText + 1);
+	pdoc->GetCharRange(&chars[0], posFirst, lengthText);
+	pdoc->GetStyleRange(&styles[0], posFirst, lengthText);
+	for (int line = lineFirst; line < lineLast; line++) {
+		const int posLineStart = pdoc->LineStart(line);
+		lineStarts.push_back(posLineStart - posFirst);
+		lineLengths.push_back(pdoc->LineEnd(line) - posLineStart);
+		docLines.push_back(line);
+	}
+}
+
+void WrapBatch::Wrap() {
+	const int lengthMaximum = lineLengths.empty() ? 0 : *std::max_element(lineLengths.begin(), lineLengths.end());
+	LineLayout ll(lengthMaximum + 1);
+	sublines.resize(lineLengths.size());
+	for (size_t i = 0; i < lineLengths.size(); i++) {
+		const int length = lineLengths[i];
+		std::copy(chars.begin() + lineStarts[i], chars.begin() + lineStarts[i] + length, ll.chars);
+		std::copy(styles.begin() + lineStarts[i], styles.begin() + lineStarts[i] + length, ll.styles);
+		ll.chars[length] = 0;
+		ll.styles[length] = styles[lineStarts[i] + length];
+		ll.positions[0] = 0;
+		ll.numCharsInLine = length;
+		ll.numCharsBeforeEOL = length;
+		if (ll.LayoutFixedPitch(fps)) {
+			ll.WrapToWidth(wp, width, 0, 0);
+			sublines[i] = ll.lines;
+		} else {
+			sublines[i] = 0;
+		}
+	}
+}
+
+BackgroundWrap::BackgroundWrap() :
+	mutex(BackgroundMutex::Allocate()), threadsRunning(0),
+	threadsMaximum(Platform::Clamp(BackgroundThread::Processors() - 1, 0, 8)), stopping(false),
+	lineQueuedEnd(0) {
+}
+
+BackgroundWrap::~BackgroundWrap() {
+	{
+		BackgroundLock lock(mutex);
+		stopping = true;
+	}
+	// Deleting a thread waits for it to finish its current batch
+	for (size_t i = 0; i < threads.size(); i++) {
+		delete threads[i];
+	}
+	threads.clear();
+	for (size_t j = 0; j < batches.size(); j++) {
+		delete batches[j];
+	}
+	batches.clear();
+	delete mutex;
+}
+
+void BackgroundWrap::ThreadProcedure(void *argument) {
+	BackgroundWrap *bw = static_cast<BackgroundWrap *>(argument);
+	while (WrapBatch *batch = bw->TakeBatch()) {
+		batch->Wrap();
+		bw->Finished(batch);
+	}
+}
+
+WrapBatch *BackgroundWrap::TakeBatch() {
+	BackgroundLock lock(mutex);
+	if (!stopping) {
+		for (size_t i = 0; i < batches.size(); i++) {
+			if (batches[i]->state == WrapBatch::wbPending) {
+				batches[i]->state = WrapBatch::wbWrapping;
+				return batches[i];
+			}
+		}
+	}
+	threadsRunning--;
+	return 0;
+}
+
+void BackgroundWrap::Finished(WrapBatch *batch) {
+	BackgroundLock lock(mutex);
+	batch->state = WrapBatch::wbWrapped;
+}
+
+void BackgroundWrap::Remove(size_t index) {
+	// Batches being wrapped are left for their thread and discarded once wrapped
+	BackgroundLock lock(mutex);
+	if (batches[index]->state == WrapBatch::wbWrapping) {
+		batches[index]->abandoned = true;
+	} else {
+		delete batches[index];
+		batches.erase(batches.begin() + index);
+	}
+}
+
+void BackgroundWrap::Add(WrapBatch *batch, int lineEnd) {
+	lineQueuedEnd = lineEnd;
+	BackgroundLock lock(mutex);
+	batches.push_back(batch);
+	if (threadsRunning == 0) {
+		// Threads that have run out of work have returned
+		for (size_t i = 0; i < threads.size(); i++) {
+			delete threads[i];
+		}
+		threads.clear();
+	}
+	if (static_cast<int>(threads.size()) < threadsMaximum) {
+		BackgroundThread *thread = BackgroundThread::Start(ThreadProcedure, this);
+		if (thread) {
+			threads.push_back(thread);
+			threadsRunning++;
+		} else {
+			threadsMaximum = 0;
+		}
+	}
+}
+
+bool BackgroundWrap::WrapOne() {
+	WrapBatch *batch = 0;
+	{
+		BackgroundLock lock(mutex);
+		for (size_t i = 0; i < batches.size() && !batch; i++) {
+			if (batches[i]->state == WrapBatch::wbPending) {
+				batch = batches[i];
+				batch->state = WrapBatch::wbWrapping;
+			}
+		}
+	}
+	if (batch) {
+		batch->Wrap();
+		Finished(batch);
+	}
+	return batch != 0;
+}
+
+WrapBatch *BackgroundWrap::First() {
+	BackgroundLock lock(mutex);
+	while (!batches.empty() && (batches[0]->state == WrapBatch::wbWrapped)) {
+		if (!batches[0]->abandoned)
+			return batches[0];
+		delete batches[0];
+		batches.erase(batches.begin());
+	}
+	return 0;
+}
+
+void BackgroundWrap::RemoveFirst() {
+	if (!batches.empty())
+		Remove(0);
+}
+
+void BackgroundWrap::Invalidate(int lineStart, int lineEnd) {
+	for (size_t i = batches.size(); i-- > 0;) {
+		WrapBatch *batch = batches[i];
+		if (!batch->abandoned) {
+			bool valid = false;
+			for (size_t line = 0; line < batch->Lines(); line++) {
+				if ((batch->docLines[line] >= lineStart) && (batch->docLines[line] < lineEnd))
+					batch->docLines[line] = -1;
+				valid = valid || (batch->docLines[line] >= 0);
+			}
+			if (!valid)
+				Remove(i);
+		}
+	}
+	if (batches.empty())
+		lineQueuedEnd = 0;
+}
+
+void BackgroundWrap::LinesInserted(int line, int linesAdded) {
+	if (linesAdded == 0)
+		return;
+	// Lines merged by a deletion are invalid while lines after the change move
+	const int lineChangeEnd = line + std::max(0, -linesAdded);
+	for (size_t i = 0; i < batches.size(); i++) {
+		WrapBatch *batch = batches[i];
+		for (size_t j = 0; j < batch->Lines(); j++) {
+			int &docLine = batch->docLines[j];
+			if (docLine >= line) {
+				if (docLine <= lineChangeEnd)
+					docLine = -1;
+				else
+					docLine += linesAdded;
 			}
-			clock = 2;
 		}
-		pces[probe].Set(styleNumber, s, len, positions, clock);
 	}
+	if (lineQueuedEnd > lineChangeEnd)
+		lineQueuedEnd += linesAdded;
+	else if (lineQueuedEnd > line)
+		lineQueuedEnd = line;
+}
+
+void BackgroundWrap::Clear() {
+	for (size_t i = batches.size(); i-- > 0;) {
+		if (!batches[i]->abandoned)
+			Remove(i);
+	}
+	lineQueuedEnd = 0;
 }
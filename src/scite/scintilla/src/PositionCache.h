@@ -16,11 +16,41 @@ static inline bool IsEOLChar(char ch) {
 	return (ch == '\r') || (ch == '\n');
 }
 
+class SpecialRepresentations;
+
+/**
+ * What is needed to lay out a line of graphic ASCII and tabs in fixed pitch styles without
+ * measuring. A background thread should point this at its own copies of the styles and
+ * representations.
+ */
+struct FixedPitchSettings {
+	const std::vector<FixedPitchStyle> *styles;
+	const SpecialRepresentations *reprs;
+	XYPOSITION tabWidth;
+	XYPOSITION lastSegItalicsOffset;
+	int tabWidthMinimumPixels;
+	bool tabs;	///< False when there are tab stops set so tabs have to be laid out normally
+	FixedPitchSettings(const ViewStyle &vstyle, const SpecialRepresentations &reprs_, int tabWidthMinimumPixels_, bool tabs_);
+};
+
+/// The settings that decide where lines wrap.
+struct WrapParameters {
+	int wrapState;
+	int visualFlags;
+	int indentMode;
+	int visualStartIndent;
+	int indentSize;
+	XYPOSITION aveCharWidth;
+	XYPOSITION spaceWidth;
+	WrapParameters(const ViewStyle &vstyle, int indentSize_);
+};
+
 /**
  */
 class LineLayout {
 private:
 	friend class LineLayoutCache;
+	friend class CompactLineLayout;
 	int *lineStarts;
 	int lenLineStarts;
 	/// Drawing is only performed for @a maxLineLength characters on each line.
@@ -66,9 +96,50 @@ public:
 	int FindPositionFromX(XYPOSITION x, Range range, bool charPosition) const;
 	Point PointFromPosition(int posInLine, int lineHeight) const;
 	int EndLineStyle() const;
+	size_t MemoryUsage() const;
+	bool LayoutFixedPitch(const FixedPitchSettings &fps);
+	void WrapToWidth(const WrapParameters &wp, int width, const Document *pdoc, int posLineStart);
+};
+
+/**
+ * A line layout packed so that many lines can be kept cheaply: the characters, runs of
+ * styles and the width of each character as a 16 bit count of 1/widthScale pixels.
+ * Widths that can not be stored exactly that way are kept as positions.
+ */
+class CompactLineLayout {
+	struct StyleRun {
+		int end;
+		unsigned char style;
+	};
+	enum { widthScale = 1024, widthExact = 0xffff };
+	int lineNumber;
+	int numCharsInLine;
+	int numCharsBeforeEOL;
+	LineLayout::validLevel validity;
+	int edgeColumn;
+	int widthLine;
+	int lines;
+	XYPOSITION wrapIndent;
+	XYPOSITION startPosition;
+	std::vector<char> chars;
+	std::vector<StyleRun> styleRuns;
+	std::vector<unsigned short> widths;	// Empty when all positions are exact
+	std::vector<XYPOSITION> exactPositions;
+	std::vector<int> lineStarts;
+	// Private so CompactLineLayout objects can not be copied
+	CompactLineLayout(const CompactLineLayout &);
+public:
+	explicit CompactLineLayout(const LineLayout &ll);
+	LineLayout *Expand(int maxChars) const;
+	void Invalidate(LineLayout::validLevel validity_);
+	int LineNumber() const { return lineNumber; }
+	size_t MemoryUsage() const;
 };
 
 /**
+ * With a budget, the document level keeps full layouts only for about a page of the most
+ * recently used lines and packs the others into CompactLineLayouts, discarding the least
+ * recently used when the budget is exceeded. Discarded lines are laid out again when needed.
  */
 class LineLayoutCache {
 	int level;
@@ -76,8 +147,21 @@ class LineLayoutCache {
 	bool allInvalidated;
 	int styleClock;
 	int useCount;
+	size_t budget;
+	size_t bytesCompact;
+	unsigned int clock;
+	size_t hotLimit;
+	std::vector<int> hotLines;
+	std::vector<CompactLineLayout *>compact;
+	std::vector<unsigned int> lastUse;
+	int hits;
+	int misses;
 	void Allocate(size_t length_);
 	void AllocateForLevel(int linesOnScreen, int linesInDoc);
+	bool Budgeted() const { return (budget > 0) && (level == llcDocument); }
+	void DeallocateCompact();
+	void PackLine(int line);
+	void EnforceBudget();
 public:
 	LineLayoutCache();
 	virtual ~LineLayoutCache();
@@ -94,21 +178,33 @@ public:
 	LineLayout *Retrieve(int lineNumber, int lineCaret, int maxChars, int styleClock_,
 		int linesOnScreen, int linesInDoc);
 	void Dispose(LineLayout *ll);
+	void SetBudget(size_t budget_);
+	size_t GetBudget() const { return budget; }
+	size_t MemoryUsage() const;
+	int Hits() const { return hits; }
+	int Misses() const { return misses; }
 };
 
 class PositionCacheEntry {
 	unsigned int styleNumber:8;
-	unsigned int len:8;
-	unsigned int clock:16;
+	unsigned int len:24;
+	unsigned int hash;
+	unsigned int clock;
 	XYPOSITION *positions;
 public:
 	PositionCacheEntry();
 	~PositionCacheEntry();
-	void Set(unsigned int styleNumber_, const char *s_, unsigned int len_, XYPOSITION *positions_, unsigned int clock_);
+	void Set(unsigned int styleNumber_, const char *s_, unsigned int len_, XYPOSITION *positions_,
+		unsigned int hash_, unsigned int clock_);
 	void Clear();
-	bool Retrieve(unsigned int styleNumber_, const char *s_, unsigned int len_, XYPOSITION *positions_) const;
+	void Take(PositionCacheEntry &other);
+	bool Retrieve(unsigned int styleNumber_, const char *s_, unsigned int len_, XYPOSITION *positions_,
+		unsigned int hash_) const;
 	static unsigned int Hash(unsigned int styleNumber_, const char *s, unsigned int len);
+	bool Empty() const { return positions == 0; }
+	unsigned int HashValue() const { return hash; }
 	bool NewerThan(const PositionCacheEntry &other) const;
+	void Touch(unsigned int clock_) { clock = clock_; }
 	void ResetClock();
 };
 
@@ -174,18 +270,43 @@ public:
 	bool More() const;
 };
 
+/**
+ * Caches the widths of runs of text in a set associative table with least recently used
+ * replacement. Runs longer than lengthShort are only stored the second time they are seen so
+ * that text which does not recur doesn't evict short runs. Runs too long to measure at once are
+ * cached as segments. The table grows when a window of lookups shows misses caused by evictions.
+ */
 class PositionCache {
+	enum { ways = 4, lengthShort = 30, windowLookups = 0x2000, growthLimit = 16 };
 	std::vector<PositionCacheEntry> pces;
+	std::vector<bool> seenLong;
+	size_t seenLongCount;
+	size_t sizeRequested;
 	unsigned int clock;
 	bool allClear;
+	unsigned int hits;
+	unsigned int misses;
+	unsigned int evictions;
+	unsigned int longHits;
+	unsigned int windowHits;
+	unsigned int windowMisses;
+	unsigned int windowEvictions;
 	// Private so PositionCache objects can not be copied
 	PositionCache(const PositionCache &);
+	size_t Ways() const;
+	unsigned int Tick();
+	PositionCacheEntry *Slot(unsigned int hashValue);
+	bool Admit(unsigned int hashValue, unsigned int len);
+	void Grow();
+	void MeasureSegment(Surface *surface, const ViewStyle &vstyle, unsigned int styleNumber,
+		const char *s, unsigned int len, XYPOSITION *positions);
 public:
 	PositionCache();
 	~PositionCache();
 	void Clear();
 	void SetSize(size_t size_);
 	size_t GetSize() const { return pces.size(); }
+	int Statistic(int statistic) const;
 	void MeasureWidths(Surface *surface, const ViewStyle &vstyle, unsigned int styleNumber,
 		const char *s, unsigned int len, XYPOSITION *positions, Document *pdoc);
 };
@@ -194,6 +315,70 @@ inline bool IsSpaceOrTab(int ch) {
 	return ch == ' ' || ch == '\t';
 }
 
+/**
+ * Copies of the text, styles and settings for a range of lines so they can be wrapped on a
+ * background thread, and the number of sublines found for each line. A line that needs its
+ * text measured by the platform gets 0 sublines and has to be wrapped on the GUI thread.
+ */
+class WrapBatch {
+	std::vector<FixedPitchStyle> fixedPitchStyles;
+	SpecialRepresentations reprs;
+	FixedPitchSettings fps;
+	WrapParameters wp;
+	int width;
+	std::vector<char> chars;
+	std::vector<unsigned char> styles;
+	std::vector<int> lineStarts;
+	std::vector<int> lineLengths;
+	// Private so WrapBatch objects can not be copied
+	WrapBatch(const WrapBatch &);
+public:
+	enum batchState { wbPending, wbWrapping, wbWrapped } state;
+	bool abandoned;
+	std::vector<int> sublines;	///< Written by the thread that wraps the batch
+	std::vector<int> docLines;	///< Kept up to date on the GUI thread as lines are inserted and deleted, -1 when invalid
+	size_t merged;	///< Lines already applied on the GUI thread
+
+	WrapBatch(const ViewStyle &vstyle, const SpecialRepresentations &reprs_, int tabWidthMinimumPixels, bool tabs,
+		int indentSize, int width_, const Document *pdoc, int lineFirst, int lineLast);
+	size_t Lines() const { return docLines.size(); }
+	void Wrap();
+};
+
+/**
+ * Wraps WrapBatches on background threads. Batches are added in document order and once
+ * wrapped are merged in that order on the GUI thread.
+ */
+class BackgroundWrap {
+	BackgroundMutex *mutex;
+	std::vector<BackgroundThread *> threads;
+	int threadsRunning;
+	int threadsMaximum;
+	bool stopping;
+	std::vector<WrapBatch *> batches;
+	int lineQueuedEnd;
+	static void ThreadProcedure(void *argument);
+	WrapBatch *TakeBatch();
+	void Finished(WrapBatch *batch);
+	void Remove(size_t index);
+	// Private so BackgroundWrap objects can not be copied
+	BackgroundWrap(const BackgroundWrap &);
+public:
+	enum { batchLines = 0x400, batchBytes = 0x40000 };
+	BackgroundWrap();
+	~BackgroundWrap();
+	size_t Batches() const { return batches.size(); }
+	size_t BatchesMaximum() const { return threadsMaximum + 1; }
+	int LineQueuedEnd() const { return lineQueuedEnd; }
+	void Add(WrapBatch *batch, int lineEnd);
+	bool WrapOne();
+	WrapBatch *First();
+	void RemoveFirst();
+	void Invalidate(int lineStart, int lineEnd);
+	void LinesInserted(int line, int linesAdded);
+	void Clear();
+};
+
 #ifdef SCI_NAMESPACE
 }
 #endif
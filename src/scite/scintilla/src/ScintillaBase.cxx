@@ -36,6 +36,7 @@
 #include "Position.h"
 #include "SplitVector.h"
 #include "Partitioning.h"
+#include "ChunkedVector.h"
 #include "RunStyles.h"
 #include "ContractionState.h"
 #include "CellBuffer.h"
@@ -564,6 +565,7 @@ LexState::LexState(Document *pdoc_) : LexInterface(pdoc_) {
 }
 
 LexState::~LexState() {
+	AbandonBackground();
 	if (instance) {
 		instance->Release();
 		instance = 0;
@@ -579,15 +581,18 @@ LexState *ScintillaBase::DocumentLexState() {
 
 void LexState::SetLexerModule(const LexerModule *lex) {
 	if (lex != lexCurrent) {
+		AbandonBackground();
 		if (instance) {
 			instance->Release();
 			instance = 0;
 		}
 		interfaceVersion = lvOriginal;
+		instanceReentrant = false;
 		lexCurrent = lex;
 		if (lexCurrent) {
 			instance = lexCurrent->Create();
 			interfaceVersion = instance->Version();
+			instanceReentrant = lexCurrent->Reentrant();
 		}
 		pdoc->LexerChanged();
 	}
@@ -624,6 +629,7 @@ const char *LexState::DescribeWordListSets() {
 
 void LexState::SetWordList(int n, const char *wl) {
 	if (instance) {
+		AbandonBackground();
 		int firstModification = instance->WordListSet(n, wl);
 		if (firstModification >= 0) {
 			pdoc->ModifiedAt(firstModification);
@@ -637,6 +643,7 @@ const char *LexState::GetName() const {
 
 void *LexState::PrivateCall(int operation, void *pointer) {
 	if (pdoc && instance) {
+		AbandonBackground();
 		return instance->PrivateCall(operation, pointer);
 	} else {
 		return 0;
@@ -670,6 +677,7 @@ const char *LexState::DescribeProperty(const char *name) {
 void LexState::PropSet(const char *key, const char *val) {
 	props.Set(key, val);
 	if (instance) {
+		AbandonBackground();
 		int firstModification = instance->PropertySet(key, val);
 		if (firstModification >= 0) {
 			pdoc->ModifiedAt(firstModification);
@@ -698,6 +706,7 @@ int LexState::LineEndTypesSupported() {
 
 int LexState::AllocateSubStyles(int styleBase, int numberStyles) {
 	if (instance && (interfaceVersion >= lvSubStyles)) {
+		AbandonBackground();
 		return static_cast<ILexerWithSubStyles *>(instance)->AllocateSubStyles(styleBase, numberStyles);
 	}
 	return -1;
@@ -733,12 +742,14 @@ int LexState::PrimaryStyleFromStyle(int style) {
 
 void LexState::FreeSubStyles() {
 	if (instance && (interfaceVersion >= lvSubStyles)) {
+		AbandonBackground();
 		static_cast<ILexerWithSubStyles *>(instance)->FreeSubStyles();
 	}
 }
 
 void LexState::SetIdentifiers(int style, const char *identifiers) {
 	if (instance && (interfaceVersion >= lvSubStyles)) {
+		AbandonBackground();
 		static_cast<ILexerWithSubStyles *>(instance)->SetIdentifiers(style, identifiers);
 		pdoc->ModifiedAt(0);
 	}
@@ -1069,6 +1080,13 @@ sptr_t ScintillaBase::WndProc(unsigned int iMessage, uptr_t wParam, sptr_t lPara
 
 	case SCI_GETSUBSTYLEBASES:
 		return StringResult(lParam, DocumentLexState()->GetSubStyleBases());
+
+	case SCI_SETPARALLELLEXING:
+		DocumentLexState()->SetParallel(wParam != 0);
+		break;
+
+	case SCI_GETPARALLELLEXING:
+		return DocumentLexState()->GetParallel();
 #endif
 
 	default:
@@ -27,7 +27,9 @@ protected:
 	/// deletion at that point will not require much copying and
 	/// hence be fast.
 	void GapTo(int position) {
-		if (position != part1Length) {
+		// part1Length is never negative but checking it lets compilers see that the moves stay
+		// inside body, avoiding spurious overflow warnings when a new vector is filled
+		if ((position != part1Length) && (part1Length >= 0)) {
 			if (position < part1Length) {
 				memmove(
 					body + position + gapLength,
@@ -285,6 +287,21 @@ public:
 	int GapPosition() const {
 		return part1Length;
 	}
+
+	/// Return the elements from position up to the gap or the end without moving the gap
+	/// and set rangeLength to how many there are.
+	T *ContiguousRange(int position, int &rangeLength) {
+		if (position < part1Length) {
+			rangeLength = part1Length - position;
+			return body + position;
+		}
+		rangeLength = lengthBody - position;
+		return body + position + gapLength;
+	}
+
+	const T *ContiguousRange(int position, int &rangeLength) const {
+		return const_cast<SplitVector<T> *>(this)->ContiguousRange(position, rangeLength);
+	}
 };
 
 #ifdef SCI_NAMESPACE
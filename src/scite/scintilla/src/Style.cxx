@@ -72,6 +72,8 @@ void FontMeasurements::Clear() {
 	descent = 1;
 	aveCharWidth = 1;
 	spaceWidth = 1;
+	monospaceASCII = false;
+	monospaceCharacterWidth = 1;
 	sizeZoomed = 2;
 }
 
@@ -48,6 +48,8 @@ struct FontMeasurements {
 	unsigned int descent;
 	XYPOSITION aveCharWidth;
 	XYPOSITION spaceWidth;
+	bool monospaceASCII;	///< Every graphic ASCII character is monospaceCharacterWidth wide
+	XYPOSITION monospaceCharacterWidth;
 	int sizeZoomed;
 	FontMeasurements();
 	void Clear();
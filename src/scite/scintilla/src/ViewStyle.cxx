@@ -11,6 +11,7 @@
 #include <stdexcept>
 #include <vector>
 #include <map>
+#include <algorithm>
 
 #include "Platform.h"
 
@@ -85,6 +86,23 @@ void FontRealised::Realise(Surface &surface, int zoomLevel, int technology, cons
 	descent = static_cast<unsigned int>(surface.Descent(font));
 	aveCharWidth = surface.AverageCharWidth(font);
 	spaceWidth = surface.WidthChar(font, ' ');
+
+	// Measure the graphic ASCII characters once so runs of them can be laid out arithmetically
+	// when the font is fixed pitch.
+	const char allGraphicASCII[] = " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~";
+	const int lengthGraphicASCII = static_cast<int>(sizeof(allGraphicASCII) - 1);
+	XYPOSITION positions[sizeof(allGraphicASCII)];
+	surface.MeasureWidths(font, allGraphicASCII, lengthGraphicASCII, positions);
+	XYPOSITION minWidth = positions[0];
+	XYPOSITION maxWidth = positions[0];
+	for (int i=1; i<lengthGraphicASCII; i++) {
+		const XYPOSITION width = positions[i] - positions[i-1];
+		minWidth = std::min(minWidth, width);
+		maxWidth = std::max(maxWidth, width);
+	}
+	monospaceCharacterWidth = positions[lengthGraphicASCII - 1] / lengthGraphicASCII;
+	// Allow for rounding when positions are accumulated but not for a difference of one Pango unit
+	monospaceASCII = (maxWidth > 0) && ((maxWidth - minWidth) < 1.0f / 2048);
 }
 
 ViewStyle::ViewStyle() {
@@ -371,7 +389,9 @@ void ViewStyle::Refresh(Surface &surface, int tabInChars) {
 
 	someStylesProtected = false;
 	someStylesForceCase = false;
+	fixedPitch.resize(styles.size());
 	for (unsigned int l=0; l<styles.size(); l++) {
+		fixedPitch[l] = FixedPitchStyle(styles[l]);
 		if (styles[l].IsProtected()) {
 			someStylesProtected = true;
 		}
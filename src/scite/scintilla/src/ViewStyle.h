@@ -72,6 +72,21 @@ struct ForeBackColours {
 	ColourOptional back;
 };
 
+/// Copy of the measurements of a style used to lay out ASCII text without a Surface.
+struct FixedPitchStyle {
+	bool fixed;
+	bool visible;
+	bool italic;
+	XYPOSITION charWidth;
+	XYPOSITION spaceWidth;
+	FixedPitchStyle() : fixed(false), visible(true), italic(false), charWidth(1), spaceWidth(1) {
+	}
+	explicit FixedPitchStyle(const Style &style) :
+		fixed(style.monospaceASCII), visible(style.visible), italic(style.italic),
+		charWidth(style.monospaceCharacterWidth), spaceWidth(style.spaceWidth) {
+	}
+};
+
 /**
  */
 class ViewStyle {
@@ -79,6 +94,7 @@ class ViewStyle {
 	FontMap fonts;
 public:
 	std::vector<Style> styles;
+	std::vector<FixedPitchStyle> fixedPitch;
 	size_t nextExtendedStyle;
 	LineMarker markers[MARKER_MAX + 1];
 	int largestMarkerHeight;
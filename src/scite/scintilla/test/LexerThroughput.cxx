@@ -0,0 +1,289 @@
+// Scintilla source code edit control
+/** @file LexerThroughput.cxx
+ ** Time lexers over generated documents full of keywords to measure the cost of
+ ** WordList lookups. Lexers run directly on a simple IDocument so no platform
+ ** layer is needed.
+ **
+ ** Build from this directory with:
+ **   g++ -O2 -std=c++11 -DSCI_LEXER -I../include -I../lexlib LexerThroughput.cxx
+ **     ../lexlib/[A-Z]*.cxx ../lexers/LexCPP.cxx ../lexers/LexSQL.cxx ../lexers/LexFortran.cxx
+ **     ../lexers/LexPython.cxx ../lexers/LexProgress.cxx ../lexers/LexVB.cxx
+ **     ../lexers/LexLua.cxx ../lexers/LexBash.cxx -o LexerThroughput
+ **
+ ** Usage: LexerThroughput [megabytes [words [runs]]]
+ ** Defaults are 4 MB documents, 3000 words in each keyword list and 3 runs.
+ ** Each lexer prints the best throughput over the runs and a checksum of the styles.
+ ** To compare WordList implementations, build against each version of
+ ** lexlib/WordList.cxx: the checksums should match and only the times differ.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+
+#include "ILexer.h"
+#include "Scintilla.h"
+#include "SciLexer.h"
+#include "LexerModule.h"
+
+#ifdef SCI_NAMESPACE
+using namespace Scintilla;
+#endif
+
+extern LexerModule lmCPP;
+extern LexerModule lmSQL;
+extern LexerModule lmFortran;
+extern LexerModule lmPython;
+extern LexerModule lmProgress;
+extern LexerModule lmVB;
+extern LexerModule lmLua;
+extern LexerModule lmBash;
+
+namespace {
+
+/**
+ * Text with styles, line states and fold levels held in plain vectors.
+ * Lines end with '\n'.
+ */
+class BenchDocument : public IDocumentWithContiguousRange {
+	std::string text;
+	std::vector<char> styles;
+	std::vector<int> lineStarts;	///< Ends with the document length so the end of the last line is known
+	std::vector<int> lineStates;
+	std::vector<int> levels;
+	int endStyled;
+	int Length_() const {
+		return static_cast<int>(text.length());
+	}
+	int Lines() const {
+		return static_cast<int>(lineStarts.size()) - 1;
+	}
+	int ClampLine(Sci_Position line) const {
+		return std::max(0, std::min(static_cast<int>(line), Lines()));
+	}
+public:
+	explicit BenchDocument(const std::string &text_) : text(text_), styles(text_.length()), endStyled(0) {
+		lineStarts.push_back(0);
+		for (int i = 0; i < Length_(); i++) {
+			if (text[i] == '\n')
+				lineStarts.push_back(i + 1);
+		}
+		lineStarts.push_back(Length_());
+		lineStates.resize(Lines());
+		levels.resize(Lines(), SC_FOLDLEVELBASE);
+	}
+	virtual ~BenchDocument() {
+	}
+	void Reset() {
+		std::fill(styles.begin(), styles.end(), 0);
+		std::fill(lineStates.begin(), lineStates.end(), 0);
+		std::fill(levels.begin(), levels.end(), SC_FOLDLEVELBASE);
+		endStyled = 0;
+	}
+	unsigned int StylesChecksum() const {
+		// FNV-1a
+		unsigned int hash = 2166136261u;
+		for (size_t i = 0; i < styles.size(); i++) {
+			hash ^= static_cast<unsigned char>(styles[i]);
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+
+	int SCI_METHOD Version() const {
+		return dvContiguousRange;
+	}
+	void SCI_METHOD SetErrorStatus(int) {
+	}
+	Sci_Position SCI_METHOD Length() const {
+		return Length_();
+	}
+	void SCI_METHOD GetCharRange(char *buffer, Sci_Position position, Sci_Position lengthRetrieve) const {
+		for (Sci_Position i = 0; i < lengthRetrieve; i++) {
+			const Sci_Position pos = position + i;
+			buffer[i] = ((pos >= 0) && (pos < Length_())) ? text[pos] : 0;
+		}
+	}
+	char SCI_METHOD StyleAt(Sci_Position position) const {
+		return ((position >= 0) && (position < Length_())) ? styles[position] : 0;
+	}
+	Sci_Position SCI_METHOD LineFromPosition(Sci_Position position) const {
+		const std::vector<int>::const_iterator it =
+			std::upper_bound(lineStarts.begin(), lineStarts.end() - 1, static_cast<int>(position));
+		return std::max(0, static_cast<int>(it - lineStarts.begin()) - 1);
+	}
+	Sci_Position SCI_METHOD LineStart(Sci_Position line) const {
+		return lineStarts[ClampLine(line)];
+	}
+	int SCI_METHOD GetLevel(Sci_Position line) const {
+		return ((line >= 0) && (line < Lines())) ? levels[line] : SC_FOLDLEVELBASE;
+	}
+	int SCI_METHOD SetLevel(Sci_Position line, int level) {
+		if ((line >= 0) && (line < Lines()))
+			levels[line] = level;
+		return level;
+	}
+	int SCI_METHOD GetLineState(Sci_Position line) const {
+		return ((line >= 0) && (line < Lines())) ? lineStates[line] : 0;
+	}
+	int SCI_METHOD SetLineState(Sci_Position line, int state) {
+		if ((line >= 0) && (line < Lines()))
+			lineStates[line] = state;
+		return state;
+	}
+	void SCI_METHOD StartStyling(Sci_Position position, char) {
+		endStyled = static_cast<int>(position);
+	}
+	bool SCI_METHOD SetStyleFor(Sci_Position length, char style) {
+		const int end = std::min(endStyled + static_cast<int>(length), Length_());
+		std::fill(styles.begin() + endStyled, styles.begin() + end, style);
+		endStyled = end;
+		return true;
+	}
+	bool SCI_METHOD SetStyles(Sci_Position length, const char *styles_) {
+		const int end = std::min(endStyled + static_cast<int>(length), Length_());
+		std::copy(styles_, styles_ + (end - endStyled), styles.begin() + endStyled);
+		endStyled = end;
+		return true;
+	}
+	void SCI_METHOD DecorationSetCurrentIndicator(int) {
+	}
+	void SCI_METHOD DecorationFillRange(Sci_Position, int, Sci_Position) {
+	}
+	void SCI_METHOD ChangeLexerState(Sci_Position, Sci_Position) {
+	}
+	int SCI_METHOD CodePage() const {
+		return 0;
+	}
+	bool SCI_METHOD IsDBCSLeadByte(char) const {
+		return false;
+	}
+	const char * SCI_METHOD BufferPointer() {
+		return text.c_str();
+	}
+	int SCI_METHOD GetLineIndentation(Sci_Position line) {
+		int indent = 0;
+		for (int pos = lineStarts[ClampLine(line)]; pos < Length_(); pos++) {
+			if (text[pos] == ' ')
+				indent++;
+			else if (text[pos] == '\t')
+				indent = indent / 8 * 8 + 8;
+			else
+				break;
+		}
+		return indent;
+	}
+	Sci_Position SCI_METHOD LineEnd(Sci_Position line) const {
+		const int lineClamped = ClampLine(line);
+		return (lineClamped < Lines() - 1) ? lineStarts[lineClamped + 1] - 1 : Length_();
+	}
+	Sci_Position SCI_METHOD GetRelativePosition(Sci_Position positionStart, Sci_Position characterOffset) const {
+		const Sci_Position pos = positionStart + characterOffset;
+		return ((pos < 0) || (pos > Length_())) ? INVALID_POSITION : pos;
+	}
+	int SCI_METHOD GetCharacterAndWidth(Sci_Position position, Sci_Position *pWidth) const {
+		if (pWidth)
+			*pWidth = 1;
+		return ((position >= 0) && (position < Length_())) ? static_cast<unsigned char>(text[position]) : 0;
+	}
+	const char * SCI_METHOD ContiguousRange(Sci_Position position, Sci_Position *rangeLength) const {
+		if ((position < 0) || (position >= Length_())) {
+			*rangeLength = 0;
+			return 0;
+		}
+		*rangeLength = Length_() - position;
+		return text.c_str() + position;
+	}
+};
+
+// Identifiers are made from pairs of stems and a number so that many share their first characters
+// as keywords in large lists do.
+std::string Identifier(int n) {
+	static const char *stems[] = {
+		"get", "set", "dbms", "sys", "xml", "date", "to", "str", "char", "alter", "table", "index"
+	};
+	const int nStems = sizeof(stems) / sizeof(stems[0]);
+	char number[20];
+	sprintf(number, "%d", n / (nStems * nStems));
+	return std::string(stems[n % nStems]) + stems[(n / nStems) % nStems] + number;
+}
+
+// Keyword list k holds every fourth identifier from the first words, starting at k.
+std::string KeywordList(int k, int words) {
+	std::string list;
+	for (int n = k; n < words; n += 4) {
+		list += Identifier(n);
+		list += " ";
+	}
+	return list;
+}
+
+// About a third of the identifiers are keywords and the rest miss all lists.
+std::string GenerateDocument(size_t length, int words) {
+	unsigned int seed = 1;
+	std::string text;
+	while (text.length() < length) {
+		seed = seed * 1103515245u + 12345u;
+		const unsigned int r = seed >> 8;
+		if (r % 3 == 0)
+			text += Identifier(static_cast<int>(r / 3 % words));
+		else
+			text += Identifier(words + static_cast<int>(r / 3 % (words * 3)));
+		if (r % 11 == 0)
+			text += ";\n";
+		else if (r % 5 == 0)
+			text += " (1, 'a') ";
+		else
+			text += " ";
+	}
+	return text;
+}
+
+double Seconds() {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}
+
+int main(int argc, char **argv) {
+	const double megabytes = (argc > 1) ? atof(argv[1]) : 4.0;
+	const int words = (argc > 2) ? atoi(argv[2]) : 3000;
+	const int runs = (argc > 3) ? std::max(1, atoi(argv[3])) : 3;
+	if ((megabytes <= 0) || (words <= 0)) {
+		fprintf(stderr, "Usage: LexerThroughput [megabytes [words [runs]]]\n");
+		return 1;
+	}
+
+	BenchDocument doc(GenerateDocument(static_cast<size_t>(megabytes * 1000000), words));
+	const LexerModule *modules[] = {
+		&lmCPP, &lmSQL, &lmFortran, &lmPython, &lmProgress, &lmVB, &lmLua, &lmBash
+	};
+	printf("%.1f MB, %d words in each keyword list, best of %d runs\n", doc.Length() / 1e6, words, runs);
+	double total = 0.0;
+	for (size_t m = 0; m < sizeof(modules) / sizeof(modules[0]); m++) {
+		ILexer *instance = modules[m]->Create();
+		for (int k = 0; k < 4; k++)
+			instance->WordListSet(k, KeywordList(k, words).c_str());
+		double best = 0.0;
+		for (int run = 0; run < runs; run++) {
+			doc.Reset();
+			const double start = Seconds();
+			instance->Lex(0, doc.Length(), 0, &doc);
+			const double duration = Seconds() - start;
+			if ((run == 0) || (duration < best))
+				best = duration;
+		}
+		total += best;
+		printf("%-10s %8.1f MB/s  styles %08x\n", modules[m]->languageName,
+			doc.Length() / 1e6 / best, doc.StylesChecksum());
+		instance->Release();
+	}
+	printf("total      %8.3f s\n", total);
+	return 0;
+}
@@ -3012,6 +3012,89 @@ DynamicLibrary *DynamicLibrary::Load(const char *modulePath) {
 	return static_cast<DynamicLibrary *>(new DynamicLibraryImpl(modulePath));
 }
 
+class BackgroundThreadImpl : public BackgroundThread {
+	HANDLE thread;
+	Procedure procedure;
+	void *argument;
+	static DWORD WINAPI Run(LPVOID data) {
+		BackgroundThreadImpl *bt = static_cast<BackgroundThreadImpl *>(data);
+		bt->procedure(bt->argument);
+		return 0;
+	}
+public:
+	BackgroundThreadImpl(Procedure procedure_, void *argument_) :
+		thread(0), procedure(procedure_), argument(argument_) {
+		thread = ::CreateThread(NULL, 0, Run, this, 0, NULL);
+	}
+	virtual ~BackgroundThreadImpl() {
+		if (thread) {
+			::WaitForSingleObject(thread, INFINITE);
+			::CloseHandle(thread);
+		}
+	}
+	bool IsValid() const {
+		return thread != 0;
+	}
+};
+
+BackgroundThread *BackgroundThread::Start(Procedure procedure, void *argument) {
+	BackgroundThreadImpl *bt = new BackgroundThreadImpl(procedure, argument);
+	if (!bt->IsValid()) {
+		delete bt;
+		return 0;
+	}
+	return bt;
+}
+
+int BackgroundThread::Processors() {
+	SYSTEM_INFO si;
+	::GetSystemInfo(&si);
+	return static_cast<int>(si.dwNumberOfProcessors);
+}
+
+class BackgroundMutexImpl : public BackgroundMutex {
+	CRITICAL_SECTION cs;
+public:
+	BackgroundMutexImpl() {
+		::InitializeCriticalSection(&cs);
+	}
+	virtual ~BackgroundMutexImpl() {
+		::DeleteCriticalSection(&cs);
+	}
+	virtual void Lock() {
+		::EnterCriticalSection(&cs);
+	}
+	virtual void Unlock() {
+		::LeaveCriticalSection(&cs);
+	}
+};
+
+BackgroundMutex *BackgroundMutex::Allocate() {
+	return new BackgroundMutexImpl();
+}
+
+class BackgroundEventImpl : public BackgroundEvent {
+	HANDLE event;
+public:
+	BackgroundEventImpl() {
+		// Auto reset so each Set releases one Wait
+		event = ::CreateEvent(NULL, FALSE, FALSE, NULL);
+	}
+	virtual ~BackgroundEventImpl() {
+		::CloseHandle(event);
+	}
+	virtual void Set() {
+		::SetEvent(event);
+	}
+	virtual bool Wait(int milliseconds) {
+		return ::WaitForSingleObject(event, milliseconds) == WAIT_OBJECT_0;
+	}
+};
+
+BackgroundEvent *BackgroundEvent::Allocate() {
+	return new BackgroundEventImpl();
+}
+
 ColourDesired Platform::Chrome() {
 	return ::GetSysColor(COLOR_3DFACE);
 }
@@ -330,9 +330,11 @@ $(DIR_O)\CellBuffer.obj: \
 	../include/Platform.h \
 	../include/Scintilla.h \
 	../include/Sci_Position.h \
+	../include/ILexer.h \
 	../src/Position.h \
 	../src/SplitVector.h \
 	../src/Partitioning.h \
+	../src/ChunkedVector.h \
 	../src/CellBuffer.h \
 	../src/UniConversion.h
 $(DIR_O)\CharacterCategory.obj: \
@@ -373,6 +375,7 @@ $(DIR_O)\Document.obj: \
 	../src/Position.h \
 	../src/SplitVector.h \
 	../src/Partitioning.h \
+	../src/ChunkedVector.h \
 	../src/RunStyles.h \
 	../src/CellBuffer.h \
 	../src/PerLine.h \
@@ -393,6 +396,7 @@ $(DIR_O)\EditModel.obj: \
 	../src/Position.h \
 	../src/SplitVector.h \
 	../src/Partitioning.h \
+	../src/ChunkedVector.h \
 	../src/RunStyles.h \
 	../src/ContractionState.h \
 	../src/CellBuffer.h \
@@ -420,6 +424,7 @@ $(DIR_O)\Editor.obj: \
 	../src/Position.h \
 	../src/SplitVector.h \
 	../src/Partitioning.h \
+	../src/ChunkedVector.h \
 	../src/RunStyles.h \
 	../src/ContractionState.h \
 	../src/CellBuffer.h \
@@ -451,6 +456,7 @@ $(DIR_O)\EditView.obj: \
 	../src/Position.h \
 	../src/SplitVector.h \
 	../src/Partitioning.h \
+	../src/ChunkedVector.h \
 	../src/RunStyles.h \
 	../src/ContractionState.h \
 	../src/CellBuffer.h \
@@ -776,6 +782,7 @@ $(DIR_O)\MarginView.obj: \
 	../src/Position.h \
 	../src/SplitVector.h \
 	../src/Partitioning.h \
+	../src/ChunkedVector.h \
 	../src/RunStyles.h \
 	../src/ContractionState.h \
 	../src/CellBuffer.h \
@@ -803,6 +810,7 @@ $(DIR_O)\PerLine.obj: \
 	../src/Position.h \
 	../src/SplitVector.h \
 	../src/Partitioning.h \
+	../src/ChunkedVector.h \
 	../src/CellBuffer.h \
 	../src/PerLine.h
 $(DIR_O)\PlatWin.obj: \
@@ -821,6 +829,7 @@ $(DIR_O)\PositionCache.obj: \
 	../src/Position.h \
 	../src/SplitVector.h \
 	../src/Partitioning.h \
+	../src/ChunkedVector.h \
 	../src/RunStyles.h \
 	../src/ContractionState.h \
 	../src/CellBuffer.h \
@@ -864,6 +873,7 @@ $(DIR_O)\ScintillaBase.obj: \
 	../src/Position.h \
 	../src/SplitVector.h \
 	../src/Partitioning.h \
+	../src/ChunkedVector.h \
 	../src/RunStyles.h \
 	../src/ContractionState.h \
 	../src/CellBuffer.h \
@@ -896,6 +906,7 @@ $(DIR_O)\ScintillaBaseL.obj: \
 	../src/Position.h \
 	../src/SplitVector.h \
 	../src/Partitioning.h \
+	../src/ChunkedVector.h \
 	../src/RunStyles.h \
 	../src/ContractionState.h \
 	../src/CellBuffer.h \
@@ -928,6 +939,7 @@ $(DIR_O)\ScintillaWin.obj: \
 	../src/Position.h \
 	../src/SplitVector.h \
 	../src/Partitioning.h \
+	../src/ChunkedVector.h \
 	../src/RunStyles.h \
 	../src/ContractionState.h \
 	../src/CellBuffer.h \
@@ -964,6 +976,7 @@ $(DIR_O)\ScintillaWinL.obj: \
 	../src/Position.h \
 	../src/SplitVector.h \
 	../src/Partitioning.h \
+	../src/ChunkedVector.h \
 	../src/RunStyles.h \
 	../src/ContractionState.h \
 	../src/CellBuffer.h \
@@ -1000,6 +1013,7 @@ $(DIR_O)\ScintillaWinS.obj: \
 	../src/Position.h \
 	../src/SplitVector.h \
 	../src/Partitioning.h \
+	../src/ChunkedVector.h \
 	../src/RunStyles.h \
 	../src/ContractionState.h \
 	../src/CellBuffer.h \
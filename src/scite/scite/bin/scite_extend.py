@@ -4,6 +4,7 @@
 # See documentation at https://moltenform.com/page/scite-with-python/doc/writingplugin.html
 
 import SciTEModule
+from timeit import default_timer
 
 debugTracing = False
 
@@ -19,6 +20,7 @@ class ScAppClass(object):
     def __init__(self):
         self.registeredCallbacks = dict()
         self.cachedCallbackModules = dict()
+        self.disabledCallbacks = set()
     
     def Trace(self, s):
         '''write to ScOutput, doesn't include newline'''
@@ -55,6 +57,44 @@ class ScAppClass(object):
         '''Enables notifcation (doesn't need to be called by plugins)'''
         return SciTEModule.app_EnableNotification(eventName, 1 if enabled else 0)
     
+    TaskCancelled = SciTEModule.TaskCancelled
+    
+    def RunInBackground(self, fn, args=(), callback=None, timeout=None):
+        '''Run fn(*args) on a background thread, so that slow work like a linter doesn't freeze SciTE.
+        When it finishes, callback(result, exception) is called on the main thread, exception is None on success.
+        The task can't use ScEditor, ScOutput or ScApp, and what it prints is shown when it finishes.
+        If it runs for more than timeout seconds, ScApp.TaskCancelled is raised in it and passed to callback.
+        Up to ext.python.worker.threads tasks (default 2) run at once, the rest wait.
+        Returns an id for CancelBackgroundTask.'''
+        return SciTEModule.app_SubmitTask(fn, tuple(args), callback, float(timeout or 0))
+    
+    def CancelBackgroundTask(self, taskId):
+        '''Cancel a task from RunInBackground, its callback won't be called. A running task is stopped by
+        raising ScApp.TaskCancelled in it, which waits for any blocking call to return.
+        Returns False if the task had already finished.'''
+        return SciTEModule.app_CancelTask(taskId)
+    
+    def GetCallbackTimings(self):
+        '''Returns a list of (name, count, total, p50, p99, max, overBudgetCount) with times in seconds,
+        for each event, each plugin's event handler, and each Python command, slowest total first.'''
+        timings = SciTEModule.app_GetCallbackTimings()
+        timings.sort(key=lambda item: item[2], reverse=True)
+        return timings
+    
+    def ShowCallbackTimings(self):
+        '''Print the time taken by event handlers and commands to the output pane.
+        Set ext.python.event.budget to a number of milliseconds to be told when an event takes longer,
+        and ext.python.event.budget.disable to a count to disable a handler that goes over budget that often.'''
+        print('%-48s %8s %10s %8s %8s %8s %6s' % ('name', 'count', 'total ms', 'p50 ms', 'p99 ms', 'max ms', 'over'))
+        for name, count, total, p50, p99, slowest, over in self.GetCallbackTimings():
+            print('%-48s %8d %10.1f %8.2f %8.2f %8.2f %6d' % (name[0:48], count,
+                total * 1000, p50 * 1000, p99 * 1000, slowest * 1000, over))
+    
+    def ResetCallbackTimings(self):
+        '''Clear the timings shown by ShowCallbackTimings, and enable handlers that were disabled for going over budget'''
+        self.disabledCallbacks.clear()
+        return SciTEModule.app_ResetCallbackTimings()
+    
     def LocationNext(self):
         '''Go to next location'''
         return SciTEModule.app_GetNextOrPreviousLocation(1)
@@ -294,6 +334,13 @@ class ScPaneClass(object):
     def PaneGetText(self, n1, n2):
         '''Get text between these positions'''
         return SciTEModule.pane_Textrange(self.paneNumber, n1, n2)
+
+    def PaneGetBuffer(self, n1=0, n2=-1):
+        '''Get a read-only view of the text between these positions. Indexing and slicing copy
+        only the characters asked for, so scan a large document one slice at a time. It is not a
+        buffer for re or buffer(). It becomes stale, and reading it raises an exception, once the
+        pane shows another document or any text is inserted or deleted.'''
+        return SciTEModule.pane_GetBuffer(self.paneNumber, n1, n2)
     
     def PaneFindText(self, s, pos1=0, pos2=-1, wholeWord=False, matchCase=False, regExp=False, flags=0):
         '''Find text'''
@@ -306,6 +353,17 @@ class ScPaneClass(object):
             
         return SciTEModule.pane_FindText(self.paneNumber, s, flags, pos1, pos2)
     
+    def PaneBatch(self, calls):
+        '''Make many Scintilla calls in one trip, as a single undo step with a single repaint.
+        calls is a list of tuples like ('SetIndicatorCurrent', 8) or (message, wParam, lParam),
+        and the list of results is returned. calls can instead be an array.array('i') of
+        (message, wParam, lParam) triples, which returns None.'''
+        return SciTEModule.pane_SendScintillaBatch(self.paneNumber, calls)
+    
+    def PaneGetMessage(self, name):
+        '''Get the message number of a function or property, e.g. 'IndicatorFillRange' or 'GetLength', for use in PaneBatch'''
+        return SciTEModule.pane_GetMessage(name)
+    
     # helpers where the Scintilla version is less convenient to use
     def GetLineText(self, line):
         '''Returns text of specified line'''
@@ -325,7 +383,11 @@ class ScPaneClass(object):
         if sprop.startswith('_'):
             raise AttributeError()
         else:
-            return (lambda *args: SciTEModule.pane_SendScintilla(self.paneNumber, sprop, *args))
+            # cache the bound call on this pane, so later lookups are a dictionary hit
+            import functools
+            method = functools.partial(SciTEModule.pane_SendScintilla, self.paneNumber, sprop)
+            setattr(self, sprop, method)
+            return method
     
     def GetMultiSelect(self):
         '''Support multiple selections. Return a list of (start, end) tuples for each selection'''
@@ -360,9 +422,18 @@ def OnEvent(eventName, args):
     callbacks = ScApp.registeredCallbacks.get(eventName, None)
     if callbacks:
         for command, path in callbacks:
+            # each handler is timed and disabled on its own so one slow plugin doesn't stop the others
+            timingName = eventName + ':' + command
+            if timingName in ScApp.disabledCallbacks:
+                continue
             try:
                 module = findCallbackModuleFromPath(command, path)
-                val = callCallbackModule(module, command, eventName, args)
+                start = default_timer()
+                try:
+                    val = callCallbackModule(module, command, eventName, args)
+                finally:
+                    if SciTEModule.app_RecordTiming(timingName, default_timer() - start):
+                        ScApp.disabledCallbacks.add(timingName)
                 if val == ScConst.StopEventPropagation:
                     # the user has asked that we not process any other callbacks
                     return val
@@ -22,6 +22,9 @@ import sys
 
 # After pressing Ctrl+Shift+F1, instructions will be shown in the output pane to describe what to do.
 
+# to measure the overhead of a scripted call, run
+# import scite_extend_tests; scite_extend_tests.BenchmarkScriptedCalls()
+
 # For python 2 compatibility
 def printfn(s):
     print(s)
@@ -32,6 +35,7 @@ testForAppFunctions = [
     ('Make selection lowercase', lambda: ScApp.CmdLowerCase()),
     ('Duplicate current line', lambda: ScApp.CmdDuplicate()),
     ('Select all', lambda: ScApp.CmdSelectAll()),
+    ('Sum 1, 2, 3 in the background', lambda: ScApp.RunInBackground(sum, ([1, 2, 3],), lambda result, error: printfn((result, error)))),
 ]
 
 # test all permutations of data types
@@ -163,12 +167,72 @@ def nonInteractiveTests():
     
     # this will trigger the case where stringResultLen is 0. we should handle that case.
     assertEq('', ScEditor.GetProperty('nonexistent'))
-    
+
+    # buffers copy the slices read and become stale when text is inserted or deleted
+    length = ScEditor.GetLength()
+    buf = ScEditor.PaneGetBuffer()
+    assertEq(length, len(buf))
+    assertEq(ScEditor.PaneGetText(0, length), buf[:])
+    assertException(lambda: buffer(buf), TypeError)
+    outputBuf = ScOutput.PaneGetBuffer()
+    ScOutput.PaneAppend('.')
+    assertException(lambda: outputBuf[:], RuntimeError, 'stale')
+    outputLength = ScOutput.GetLength()
+    outputBuf = ScOutput.PaneGetBuffer()
+    ScOutput.PaneRemoveText(outputLength - 1, outputLength)
+    ScOutput.PaneAppend('.')
+    assertException(lambda: outputBuf[:], RuntimeError, 'stale')
+
+    # batches resolve names once and return each call's result
+    assertEq(2006, ScEditor.PaneGetMessage('GetLength'))
+    length = ScOutput.GetLength()
+    assertEq([length, length], ScOutput.PaneBatch([('GetLength',), (ScEditor.PaneGetMessage('GetLength'),)]))
+    assertException(lambda: ScOutput.PaneBatch([('NotAFunction',)]), RuntimeError, 'not found')
+    assertException(lambda: ScOutput.PaneBatch([(ScConst.SCI_GETTEXT, 4, 'abc')]), RuntimeError, 'reads a string')
+
+    # handlers report timings that are kept per name
+    import SciTEModule
+    ScApp.ResetCallbackTimings()
+    assertEq(False, SciTEModule.app_RecordTiming('OnTest:test', 0.001))
+    SciTEModule.app_RecordTiming('OnTest:test', 0.003)
+    timings = [item for item in ScApp.GetCallbackTimings() if item[0] == 'OnTest:test']
+    assertEq(1, len(timings))
+    assertEq((2, 0.004, 0.003), (timings[0][1], round(timings[0][2], 6), timings[0][5]))
+
     # are modules loaded from the .zip
     import os, traceback, re
     for module in [os, traceback, re]:
         assertTrue('python27.zip' in module.__file__)
 
+def BenchmarkScriptedCalls(count=100000):
+    import time
+    import SciTEModule
+    def measure(description, fn, calls=count):
+        start = time.time()
+        fn()
+        elapsed = time.time() - start
+        print('%s: %.3f microseconds per call' % (description, 1e6 * elapsed / calls))
+    
+    def attributeCalls():
+        for i in xrange(count):
+            ScEditor.GetLength()
+    
+    def lookupCalls():
+        for i in xrange(count):
+            SciTEModule.pane_SendScintilla(0, 'GetLength')
+    
+    def propertyCalls():
+        for i in xrange(count):
+            ScEditor.GetCurrentPos()
+    
+    batch = [('GetLength',)] * count
+    messageBatch = [(ScEditor.PaneGetMessage('GetLength'),)] * count
+    measure('function through cached attribute', attributeCalls)
+    measure('function looked up by name', lookupCalls)
+    measure('property through cached attribute', propertyCalls)
+    measure('function in a batch', lambda: ScEditor.PaneBatch(batch))
+    measure('message number in a batch', lambda: ScEditor.PaneBatch(messageBatch))
+
 def First():
     global currentFnSet, currentFnIndex
     if currentFnSet is None:
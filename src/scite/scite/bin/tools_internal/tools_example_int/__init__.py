@@ -16,6 +16,12 @@ def OnClose(filename):
     if debugTracing:
         print('plugin saw OnClose' + filename)
 
+def OnCharBatch(chars, ranges):
+    # called once SciTE is idle with the characters typed since the last call,
+    # and the (start, end) ranges they were typed into. OnKeyBatch(keys) works the same way.
+    if debugTracing:
+        print('plugin saw OnCharBatch %r %r' % (chars, ranges))
+
 def CallSubmodule():
     import ExampleSubmodule
     ExampleSubmodule.CallSubmodule()
@@ -79,6 +79,20 @@ FileWorker.o: ../src/FileWorker.cxx ../../scintilla/include/Scintilla.h \
  ../../scintilla/include/Sci_Position.h ../../scintilla/include/ILexer.h \
  ../src/Mutex.h ../src/GUI.h ../src/FilePath.h ../src/Cookie.h \
  ../src/Worker.h ../src/FileWorker.h ../src/Utf8_16.h
+GrepIndex.o: ../src/GrepIndex.cxx ../../scintilla/include/Scintilla.h \
+ ../../scintilla/include/Sci_Position.h ../../scintilla/include/ILexer.h \
+ ../src/GUI.h ../src/FilePath.h ../src/Mutex.h ../src/Cookie.h \
+ ../src/Worker.h ../src/FileWorker.h ../src/GrepWorker.h \
+ ../src/GrepIndex.h
+GrepRegex.o: ../src/GrepRegex.cxx ../src/GrepRegex.h
+GrepWorker.o: ../src/GrepWorker.cxx ../../scintilla/include/Scintilla.h \
+ ../../scintilla/include/Sci_Position.h ../../scintilla/include/ILexer.h \
+ ../src/GUI.h ../src/StringList.h ../src/StringHelpers.h \
+ ../src/FilePath.h ../src/StyleDefinition.h ../src/PropSetFile.h \
+ ../src/StyleWriter.h ../src/Extender.h ../src/SciTE.h ../src/Mutex.h \
+ ../src/JobQueue.h ../src/Cookie.h ../src/Worker.h ../src/FileWorker.h \
+ ../src/MatchMarker.h ../src/SciTEBase.h ../src/GrepRegex.h \
+ ../src/GrepWorker.h
 IFaceTable.o: ../src/IFaceTable.cxx ../src/IFaceTable.h
 JobQueue.o: ../src/JobQueue.cxx ../../scintilla/include/Scintilla.h \
  ../../scintilla/include/Sci_Position.h ../src/GUI.h \
@@ -123,7 +137,8 @@ SciTEIO.o: ../src/SciTEIO.cxx ../../scintilla/include/Scintilla.h \
  ../src/FilePath.h ../src/StyleDefinition.h ../src/PropSetFile.h \
  ../src/StyleWriter.h ../src/Extender.h ../src/SciTE.h ../src/Mutex.h \
  ../src/JobQueue.h ../src/Cookie.h ../src/Worker.h ../src/FileWorker.h \
- ../src/MatchMarker.h ../src/SciTEBase.h ../src/Utf8_16.h
+ ../src/MatchMarker.h ../src/SciTEBase.h ../src/GrepWorker.h \
+ ../src/Utf8_16.h
 SciTEProps.o: ../src/SciTEProps.cxx ../../scintilla/include/Scintilla.h \
  ../../scintilla/include/Sci_Position.h \
  ../../scintilla/include/SciLexer.h ../../scintilla/include/ILexer.h \
@@ -176,6 +176,60 @@ properties - a sorted list of (name, property), where property is a
 	return (constants, funclist, proplist)
 
 
+def HashName(seed, name):
+	"""32 bit FNV-1a, seeded by the displacement. Must match HashName in IFaceTable.cxx."""
+	h = seed or 0x811C9DC5
+	for c in name:
+		h = ((h ^ ord(c)) * 0x01000193) & 0xFFFFFFFF
+	return h
+
+def PerfectHash(names):
+	"""Returns (displacements, slots), a minimal perfect hash of names built by hash and
+displace. A name first hashes with seed 0 to a bucket. A positive displacement d for
+that bucket means the name is in slot HashName(d, name) % n, a negative one means
+the bucket's single name is directly in slot -1-d. slots holds the index of the
+name in the table, so a lookup costs at most two hashes and one comparison."""
+	n = len(names)
+	if n == 0:
+		return ([0], [0])
+	buckets = [[] for i in range(n)]
+	for index, name in enumerate(names):
+		buckets[HashName(0, name) % n].append(index)
+	displacements = [0] * n
+	slots = [None] * n
+	order = sorted(range(n), key=lambda b: (-len(buckets[b]), b))
+	for b in order:
+		bucket = buckets[b]
+		if len(bucket) <= 1:
+			break
+		d = 1
+		while True:
+			placed = [HashName(d, names[index]) % n for index in bucket]
+			if len(set(placed)) == len(placed) and all(slots[slot] is None for slot in placed):
+				break
+			d += 1
+		displacements[b] = d
+		for index, slot in zip(bucket, placed):
+			slots[slot] = index
+	free = [slot for slot in range(n) if slots[slot] is None]
+	for b in order:
+		if len(buckets[b]) == 1:
+			slot = free.pop()
+			displacements[b] = -1 - slot
+			slots[slot] = buckets[b][0]
+	return (displacements, slots)
+
+def printHashTable(out, name, names):
+	displacements, slots = PerfectHash(names)
+	for suffix, values in (("Displacements", displacements), ("Slots", slots)):
+		out.append("")
+		out.append("static const int %s%s[] = {" % (name, suffix))
+		for start in range(0, len(values), 16):
+			line = ",".join(str(v) for v in values[start:start+16])
+			comma = "," if start + 16 < len(values) else ""
+			out.append("\t" + line + comma)
+		out.append("};")
+
 def printIFaceTableCXXFile(faceAndIDs):
 	out = []
 	f, ids = faceAndIDs
@@ -251,6 +305,14 @@ def printIFaceTableCXXFile(faceAndIDs):
 	else:
 		out.append('{"", 0, iface_void, iface_void} };')
 
+	# Perfect hashes to find names without searching. The function constant names
+	# are "SCI_" followed by the function name in upper case.
+	printHashTable(out, "ifaceConstant", [name for name, features in constants])
+	printHashTable(out, "ifaceFunction", [name for name, features in functions])
+	printHashTable(out, "ifaceProperty", [name for name, property in properties])
+	printHashTable(out, "ifaceFunctionConstant", ["SCI_" + name.upper() for name, features in functions])
+	out.append("")
+
 	out.append("enum {")
 	out.append("\tifaceFunctionCount = %d," % len(functions))
 	out.append("\tifaceConstantCount = %d," % len(constants))
@@ -11,6 +11,7 @@
 #include "Scintilla.h"
 
 class StyleWriter;
+struct Worker;
 
 inline sptr_t SptrFromPointer(void *p) {
 	return reinterpret_cast<sptr_t>(p);
@@ -46,6 +47,12 @@ public:
 	virtual void UserStripSet(int control, const char *value)=0;
 	virtual void UserStripSetList(int control, const char *value)=0;
 	virtual const char *UserStripValue(int control)=0;
+	/// Extensions may run workers in the background. A worker that posts WORK_EXTENSION
+	/// must be an ExtensionWorker, which then finishes on the main thread.
+	virtual bool PerformOnNewThread(Worker *pWorker)=0;
+	virtual void PostOnMainThread(int cmd, Worker *pWorker)=0;
+	/// Extensions may ask for OnIdle to be called once there are no more events to handle.
+	virtual void RequestIdle()=0;
 };
 
 /**
@@ -89,6 +96,8 @@ public:
 	virtual bool OnClose(const char *) { return false; }
 	virtual bool OnUserStrip(int /* control */, int /* change */) { return false; }
 	virtual bool NeedsOnClose() { return true; }
+	/// Return true if there is more idle work to do.
+	virtual bool OnIdle() { return false; }
 };
 
 #endif
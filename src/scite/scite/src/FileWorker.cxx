@@ -52,11 +52,29 @@ double FileWorker::Duration() {
 }
 
 FileLoader::FileLoader(WorkerListener *pListener_, ILoader *pLoader_, FilePath path_, long size_, FILE *fp_) :
-	FileWorker(pListener_, path_, size_, fp_), pLoader(pLoader_), readSoFar(0), unicodeMode(uni8Bit) {
+	FileWorker(pListener_, path_, size_, fp_), progressive(pLoader_ == 0), mutexPending(Mutex::Create()), unicodeModeStart(uni8Bit),
+	pLoader(pLoader_), readSoFar(0), unicodeMode(uni8Bit), sizeFirstShow(0) {
 	SetSizeJob(static_cast<int>(size));
 }
 
 FileLoader::~FileLoader() {
+	delete mutexPending;
+}
+
+void FileLoader::AddText(char *text, size_t length) {
+	if (!progressive) {
+		err = pLoader->AddData(text, static_cast<int>(length));
+	} else {
+		Lock lock(mutexPending);
+		pending.append(text, length);
+	}
+}
+
+UniMode FileLoader::TakePending(std::string &text) {
+	Lock lock(mutexPending);
+	text.clear();
+	text.swap(pending);
+	return unicodeModeStart;
 }
 
 void FileLoader::Execute() {
@@ -65,6 +83,8 @@ void FileLoader::Execute() {
 		std::vector<char> data(blockSize);
 		size_t lenFile = fread(&data[0], 1, blockSize, fp);
 		UniMode umCodingCookie = CodingCookieValue(&data[0], lenFile);
+		bool firstBlock = true;
+		bool shownFirst = false;
 		while ((lenFile > 0) && (err == 0) && (!Cancelling())) {
 #ifdef __unix__
 			usleep(sleepTime * 1000);
@@ -72,10 +92,21 @@ void FileLoader::Execute() {
 			::Sleep(sleepTime);
 #endif
 			lenFile = convert.convert(&data[0], lenFile);
+			if (progressive && firstBlock) {
+				// The byte order mark has been examined so the encoding is known.
+				Lock lock(mutexPending);
+				unicodeModeStart = static_cast<UniMode>(static_cast<int>(convert.getEncoding()));
+				if (unicodeModeStart == uni8Bit)
+					unicodeModeStart = umCodingCookie;
+			}
+			firstBlock = false;
 			char *dataBlock = convert.getNewBuf();
-			err = pLoader->AddData(dataBlock, static_cast<int>(lenFile));
+			AddText(dataBlock, lenFile);
 			IncrementProgress(static_cast<int>(lenFile));
-			if (et.Duration() > nextProgress) {
+			// Progressive loads show the start of the file as soon as it is available.
+			const bool showFirst = progressive && !shownFirst && (ProgressMade() >= sizeFirstShow);
+			if (showFirst || (et.Duration() > nextProgress)) {
+				shownFirst = shownFirst || showFirst;
 				nextProgress = et.Duration() + timeBetweenProgress;
 				pListener->PostOnMainThread(WORK_FILEPROGRESS, this);
 			}
@@ -85,7 +116,7 @@ void FileLoader::Execute() {
 				size_t lenFileTrail = convert.convert(NULL, lenFile);
 				if (lenFileTrail) {
 					char *dataTrail = convert.getNewBuf();
-					err = pLoader->AddData(dataTrail, static_cast<int>(lenFileTrail));
+					AddText(dataTrail, lenFileTrail);
 				}
 			}
 		}
@@ -104,8 +135,10 @@ void FileLoader::Execute() {
 
 void FileLoader::Cancel() {
 	FileWorker::Cancel();
-	pLoader->Release();
-	pLoader = 0;
+	if (pLoader) {
+		pLoader->Release();
+		pLoader = 0;
+	}
 }
 
 FileStorer::FileStorer(WorkerListener *pListener_, const char *documentBytes_, FilePath path_,
@@ -31,16 +31,32 @@ struct FileWorker : public Worker {
 using Scintilla::ILoader;
 #endif
 
+/// Reads a file on a background thread. Normally the text goes into a separate
+/// document through pLoader. When pLoader is NULL, the load is progressive:
+/// converted text is held in pending for the main thread to append to the
+/// visible document as each WORK_FILEPROGRESS arrives.
 class FileLoader : public FileWorker {
+	bool progressive;
+	Mutex *mutexPending;
+	std::string pending;
+	UniMode unicodeModeStart;
+	void AddText(char *text, size_t length);
 public:
 	ILoader *pLoader;
 	long readSoFar;
 	UniMode unicodeMode;
+	/// Progressive loading posts progress as soon as this much has been read.
+	long sizeFirstShow;
 
 	FileLoader(WorkerListener *pListener_, ILoader *pLoader_, FilePath path_, long size_, FILE *fp_);
 	virtual ~FileLoader();
 	virtual void Execute();
 	virtual void Cancel();
+	bool Progressive() const {
+		return progressive;
+	}
+	/// Move text read so far into text and return the encoding detected at the start of the file.
+	UniMode TakePending(std::string &text);
 	virtual bool IsLoading() const {
 		return true;
 	}
@@ -62,10 +78,3 @@ public:
 		return false;
 	}
 };
-
-enum {
-	WORK_FILEREAD = 1,
-	WORK_FILEWRITTEN = 2,
-	WORK_FILEPROGRESS = 3,
-	WORK_PLATFORM = 100
-};
@@ -158,6 +158,7 @@ public:
 		switch (msg) {
 		case SCI_CREATEDOCUMENT:
 		case SCI_CREATELOADER:
+		case SCI_CREATEMAPPEDDOCUMENT:
 		case SCI_PRIVATELEXERCALL:
 		case SCI_GETDIRECTFUNCTION:
 		case SCI_GETDIRECTPOINTER:
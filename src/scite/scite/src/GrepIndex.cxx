@@ -0,0 +1,572 @@
+// SciTE - Scintilla based Text Editor
+/** @file GrepIndex.cxx
+ ** Implementation of the trigram index used to limit the files read by find in files.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <set>
+#include <map>
+#include <algorithm>
+#include <iterator>
+
+#if !defined(__unix__)
+
+#undef _WIN32_WINNT
+#define _WIN32_WINNT  0x0602
+#include <windows.h>
+
+#endif
+
+#include "Scintilla.h"
+#include "ILexer.h"
+
+#include "GUI.h"
+
+#include "FilePath.h"
+#include "Mutex.h"
+#include "Cookie.h"
+#include "Worker.h"
+#include "FileWorker.h"
+#include "GrepWorker.h"
+#include "GrepIndex.h"
+
+/*
+Index file layout. Integers are little endian.
+	char[4] "SGIX"
+	uint32 version
+	uint32 number of files
+	uint32 number of trigrams
+	uint32 length of root, root as UTF-8
+	files, each:
+		uint32 length of path relative to root, path as UTF-8
+		int64 modification time
+		int64 size
+		uint32 1 if indexed, 0 if too large or binary
+	trigrams sorted, each:
+		uint32 trigram
+		uint32 number of files
+		uint64 offset of postings
+	postings: file ids in increasing order, each the difference from the
+	previous id as a variable length integer with 7 bits per byte.
+*/
+
+namespace {
+
+const char indexMagic[] = "SGIX";
+const size_t trigramRecordSize = 16;
+
+unsigned int ReadUInt32(const char *p) {
+	const unsigned char *u = reinterpret_cast<const unsigned char *>(p);
+	return u[0] | (u[1] << 8) | (u[2] << 16) | (static_cast<unsigned int>(u[3]) << 24);
+}
+
+unsigned long long ReadUInt64(const char *p) {
+	return ReadUInt32(p) | (static_cast<unsigned long long>(ReadUInt32(p + 4)) << 32);
+}
+
+void AppendUInt32(std::string &s, unsigned int value) {
+	for (int i = 0; i < 4; i++) {
+		s.push_back(static_cast<char>(value & 0xff));
+		value >>= 8;
+	}
+}
+
+void AppendUInt64(std::string &s, unsigned long long value) {
+	AppendUInt32(s, static_cast<unsigned int>(value & 0xffffffffU));
+	AppendUInt32(s, static_cast<unsigned int>(value >> 32));
+}
+
+void AppendVarInt(std::string &s, unsigned int value) {
+	while (value >= 0x80) {
+		s.push_back(static_cast<char>((value & 0x7f) | 0x80));
+		value >>= 7;
+	}
+	s.push_back(static_cast<char>(value));
+}
+
+unsigned int ReadVarInt(const char *&p, const char *end) {
+	unsigned int value = 0;
+	int shift = 0;
+	while (p < end) {
+		const unsigned char byte = static_cast<unsigned char>(*p++);
+		value |= static_cast<unsigned int>(byte & 0x7f) << shift;
+		if (!(byte & 0x80))
+			break;
+		shift += 7;
+	}
+	return value;
+}
+
+inline unsigned char FoldByte(unsigned char ch) {
+	return ((ch >= 'A') && (ch <= 'Z')) ? static_cast<unsigned char>(ch - 'A' + 'a') : ch;
+}
+
+inline bool IsLineEndByte(unsigned char ch) {
+	return (ch == '\r') || (ch == '\n');
+}
+
+/// Calls add for each case folded trigram that does not cross a line end.
+template <typename T>
+void ForEachTrigram(const char *text, size_t length, T &add) {
+	if (length < 3)
+		return;
+	unsigned int trigram = (FoldByte(text[0]) << 8) | FoldByte(text[1]);
+	for (size_t i = 2; i < length; i++) {
+		trigram = ((trigram << 8) | FoldByte(text[i])) & 0xffffff;
+		if (!IsLineEndByte(text[i]) && !IsLineEndByte(text[i-1]) && !IsLineEndByte(text[i-2]))
+			add(trigram);
+	}
+}
+
+/// Collects each trigram of a file once.
+class TrigramSet {
+	std::vector<unsigned char> bits;
+public:
+	std::vector<unsigned int> trigrams;
+	TrigramSet() : bits(1 << 21) {
+	}
+	void operator()(unsigned int trigram) {
+		unsigned char &byte = bits[trigram >> 3];
+		const unsigned char mask = static_cast<unsigned char>(1 << (trigram & 7));
+		if (!(byte & mask)) {
+			byte |= mask;
+			trigrams.push_back(trigram);
+		}
+	}
+	void Clear() {
+		for (size_t i = 0; i < trigrams.size(); i++)
+			bits[trigrams[i] >> 3] = 0;
+		trigrams.clear();
+	}
+};
+
+std::string RelativePath(const std::string &rootPrefix, const FilePath &fPath) {
+	std::string path = fPath.AsUTF8();
+	if (path.compare(0, rootPrefix.length(), rootPrefix) == 0)
+		return path.substr(rootPrefix.length());
+	return path;
+}
+
+std::string RootPrefix(const FilePath &root) {
+	std::string prefix = root.AsUTF8();
+	const std::string separator = GUI::UTF8FromString(pathSepString);
+	if ((prefix.length() < separator.length()) ||
+		(prefix.compare(prefix.length() - separator.length(), separator.length(), separator) != 0))
+		prefix += separator;
+	return prefix;
+}
+
+bool ReplaceFile(const FilePath &from, const FilePath &to) {
+#if defined(__unix__)
+	return rename(from.AsInternal(), to.AsInternal()) == 0;
+#else
+	return ::MoveFileExW(from.AsInternal(), to.AsInternal(), MOVEFILE_REPLACE_EXISTING) != 0;
+#endif
+}
+
+}
+
+/// Modification times have sub-second resolution so that a file changed twice
+/// in one second is still seen as changed: nanoseconds on Unix and 100
+/// nanosecond FILETIME units on Windows.
+bool GrepFileStatus(const FilePath &fPath, long long &modified, long long &size) {
+#if defined(__unix__)
+	struct stat statusFile;
+	if (stat(fPath.AsInternal(), &statusFile) != 0)
+		return false;
+	modified = static_cast<long long>(statusFile.st_mtim.tv_sec) * 1000000000LL + statusFile.st_mtim.tv_nsec;
+	size = statusFile.st_size;
+#else
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+	if (!::GetFileAttributesExW(fPath.AsInternal(), GetFileExInfoStandard, &attributes))
+		return false;
+	modified = (static_cast<long long>(attributes.ftLastWriteTime.dwHighDateTime) << 32) |
+		attributes.ftLastWriteTime.dwLowDateTime;
+	size = (static_cast<long long>(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
+#endif
+	return true;
+}
+
+GrepIndex::GrepIndex() : contents(0), trigramTable(0), trigramCount(0), postings(0), postingsLength(0),
+	selected(false), filesChanged(0) {
+}
+
+GrepIndex::~GrepIndex() {
+	Close();
+}
+
+void GrepIndex::Close() {
+	delete contents;
+	contents = 0;
+	fileIds.clear();
+	modifieds.clear();
+	sizes.clear();
+	indexed.clear();
+	candidates.clear();
+	trigramTable = 0;
+	trigramCount = 0;
+	postings = 0;
+	postingsLength = 0;
+	selected = false;
+}
+
+bool GrepIndex::Load(const FilePath &indexPath, const FilePath &root) {
+	Close();
+	contents = new FileContents(indexPath);
+	const char *p = contents->Data();
+	const char *end = p + contents->Length();
+	rootPrefix = RootPrefix(root);
+	bool valid = p && (end - p >= 20) && (memcmp(p, indexMagic, 4) == 0) &&
+		(ReadUInt32(p + 4) == grepIndexVersion);
+	if (valid) {
+		const size_t fileCount = ReadUInt32(p + 8);
+		trigramCount = ReadUInt32(p + 12);
+		const size_t rootLength = ReadUInt32(p + 16);
+		p += 20;
+		valid = (static_cast<size_t>(end - p) >= rootLength) && (std::string(p, rootLength) == rootPrefix);
+		p += rootLength;
+		for (size_t id = 0; valid && (id < fileCount); id++) {
+			if (end - p < 4) {
+				valid = false;
+				break;
+			}
+			const size_t pathLength = ReadUInt32(p);
+			p += 4;
+			if (static_cast<size_t>(end - p) < pathLength + 20) {
+				valid = false;
+				break;
+			}
+			fileIds[std::string(p, pathLength)] = id;
+			p += pathLength;
+			modifieds.push_back(static_cast<long long>(ReadUInt64(p)));
+			sizes.push_back(static_cast<long long>(ReadUInt64(p + 8)));
+			indexed.push_back(ReadUInt32(p + 16) != 0);
+			p += 20;
+		}
+		if (valid && (static_cast<size_t>(end - p) >= trigramCount * trigramRecordSize)) {
+			trigramTable = p;
+			postings = p + trigramCount * trigramRecordSize;
+			postingsLength = end - postings;
+		} else {
+			valid = false;
+		}
+	}
+	if (!valid) {
+		Close();
+		return false;
+	}
+	return true;
+}
+
+bool GrepIndex::Lookup(const FilePath &fPath, size_t &id) const {
+	std::map<std::string, size_t>::const_iterator it = fileIds.find(RelativePath(rootPrefix, fPath));
+	if (it == fileIds.end())
+		return false;
+	id = it->second;
+	return true;
+}
+
+bool GrepIndex::Matches(size_t id, long long modified, long long size) const {
+	return (modifieds[id] == modified) && (sizes[id] == size);
+}
+
+unsigned int GrepIndex::Trigram(size_t position) const {
+	return ReadUInt32(trigramTable + position * trigramRecordSize);
+}
+
+void GrepIndex::Postings(size_t position, std::vector<unsigned int> &ids) const {
+	const char *record = trigramTable + position * trigramRecordSize;
+	const size_t count = ReadUInt32(record + 4);
+	const unsigned long long offset = ReadUInt64(record + 8);
+	ids.clear();
+	if (offset > postingsLength)
+		return;
+	const char *p = postings + offset;
+	const char *end = postings + postingsLength;
+	unsigned int id = 0;
+	for (size_t i = 0; (i < count) && (p < end); i++) {
+		id += ReadVarInt(p, end);
+		if (id < modifieds.size())
+			ids.push_back(id);
+	}
+}
+
+namespace {
+
+struct TrigramLister {
+	std::vector<unsigned int> trigrams;
+	void operator()(unsigned int trigram) {
+		trigrams.push_back(trigram);
+	}
+};
+
+}
+
+void GrepIndex::SelectCandidates(const std::string &literal) {
+	TrigramLister lister;
+	ForEachTrigram(literal.c_str(), literal.length(), lister);
+	if (lister.trigrams.empty())
+		return;
+	std::sort(lister.trigrams.begin(), lister.trigrams.end());
+	lister.trigrams.erase(std::unique(lister.trigrams.begin(), lister.trigrams.end()), lister.trigrams.end());
+
+	// Find each trigram in the sorted table, starting the intersection from the shortest list.
+	std::vector<std::pair<size_t, size_t> > lists;
+	for (size_t t = 0; t < lister.trigrams.size(); t++) {
+		size_t low = 0;
+		size_t high = trigramCount;
+		while (low < high) {
+			const size_t middle = (low + high) / 2;
+			if (Trigram(middle) < lister.trigrams[t])
+				low = middle + 1;
+			else
+				high = middle;
+		}
+		if ((low >= trigramCount) || (Trigram(low) != lister.trigrams[t])) {
+			// No indexed file contains this trigram.
+			lists.clear();
+			candidates.assign(FileCount(), false);
+			selected = true;
+			return;
+		}
+		lists.push_back(std::pair<size_t, size_t>(ReadUInt32(trigramTable + low * trigramRecordSize + 4), low));
+	}
+	std::sort(lists.begin(), lists.end());
+	std::vector<unsigned int> ids;
+	std::vector<unsigned int> other;
+	std::vector<unsigned int> both;
+	Postings(lists[0].second, ids);
+	for (size_t l = 1; (l < lists.size()) && !ids.empty(); l++) {
+		Postings(lists[l].second, other);
+		both.clear();
+		std::set_intersection(ids.begin(), ids.end(), other.begin(), other.end(), std::back_inserter(both));
+		ids.swap(both);
+	}
+	candidates.assign(FileCount(), false);
+	for (size_t i = 0; i < ids.size(); i++)
+		candidates[ids[i]] = true;
+	selected = true;
+}
+
+bool GrepIndex::Excludes(const FilePath &fPath) {
+	size_t id = 0;
+	if (!Lookup(fPath, id)) {
+		filesChanged++;
+		return false;
+	}
+	long long modified = 0;
+	long long size = 0;
+	if (!GrepFileStatus(fPath, modified, size) || !Matches(id, modified, size)) {
+		filesChanged++;
+		return false;
+	}
+	return selected && indexed[id] && !candidates[id];
+}
+
+bool GrepIndex::Stale() const {
+	return filesChanged > 0;
+}
+
+namespace {
+
+/// Postings for one trigram built from the previous index and from files read now.
+/// Both lists are in increasing order of new file id and are merged when written.
+struct PostingBuilder {
+	std::string reused;
+	std::string added;
+	unsigned int lastReused;
+	unsigned int lastAdded;
+	unsigned int count;
+	PostingBuilder() : lastReused(0), lastAdded(0), count(0) {
+	}
+	void AddReused(unsigned int id) {
+		AppendVarInt(reused, id - lastReused);
+		lastReused = id;
+		count++;
+	}
+	void AddAdded(unsigned int id) {
+		AppendVarInt(added, id - lastAdded);
+		lastAdded = id;
+		count++;
+	}
+	void Write(std::string &out) const {
+		const char *pReused = reused.c_str();
+		const char *endReused = pReused + reused.length();
+		const char *pAdded = added.c_str();
+		const char *endAdded = pAdded + added.length();
+		unsigned int idReused = (pReused < endReused) ? ReadVarInt(pReused, endReused) : 0;
+		unsigned int idAdded = (pAdded < endAdded) ? ReadVarInt(pAdded, endAdded) : 0;
+		bool haveReused = !reused.empty();
+		bool haveAdded = !added.empty();
+		unsigned int last = 0;
+		while (haveReused || haveAdded) {
+			unsigned int id;
+			if (haveReused && (!haveAdded || (idReused < idAdded))) {
+				id = idReused;
+				haveReused = pReused < endReused;
+				if (haveReused)
+					idReused += ReadVarInt(pReused, endReused);
+			} else {
+				id = idAdded;
+				haveAdded = pAdded < endAdded;
+				if (haveAdded)
+					idAdded += ReadVarInt(pAdded, endAdded);
+			}
+			AppendVarInt(out, id - last);
+			last = id;
+		}
+	}
+};
+
+struct PostingAdder {
+	std::map<unsigned int, PostingBuilder> &builders;
+	unsigned int id;
+	PostingAdder(std::map<unsigned int, PostingBuilder> &builders_, unsigned int id_) : builders(builders_), id(id_) {
+	}
+	void operator()(unsigned int trigram) {
+		builders[trigram].AddAdded(id);
+	}
+};
+
+struct IndexedFile {
+	FilePath path;
+	std::string relative;
+	long long modified;
+	long long size;
+	bool indexed;
+};
+
+void ListFiles(const FilePath &directory, const std::string &rootPrefix, std::vector<IndexedFile> &files, const Worker &worker) {
+	FilePathSet directories;
+	FilePathSet filesInDirectory;
+	FilePath(directory).List(directories, filesInDirectory);
+	for (size_t i = 0; i < filesInDirectory.size(); i++) {
+		IndexedFile file;
+		file.path = filesInDirectory[i];
+		file.relative = RelativePath(rootPrefix, file.path);
+		file.indexed = false;
+		if (GrepFileStatus(file.path, file.modified, file.size))
+			files.push_back(file);
+	}
+	for (size_t j = 0; (j < directories.size()) && !worker.Cancelling(); j++) {
+		if (directories[j].Name().AsInternal()[0] != '.')
+			ListFiles(directories[j], rootPrefix, files, worker);
+	}
+}
+
+}
+
+GrepIndexer::GrepIndexer(WorkerListener *pListener_, const FilePath &root_, const FilePath &indexPath_) :
+	pListener(pListener_), root(root_), indexPath(indexPath_) {
+}
+
+GrepIndexer::~GrepIndexer() {
+}
+
+void GrepIndexer::Execute() {
+	const std::string rootPrefix = RootPrefix(root);
+	std::vector<IndexedFile> files;
+	ListFiles(root, rootPrefix, files, *this);
+	SetSizeJob(static_cast<int>(files.size()));
+
+	std::map<unsigned int, PostingBuilder> builders;
+	std::vector<bool> reused(files.size(), false);
+	{
+		// Carry over the trigrams of files that have not changed since the previous index.
+		GrepIndex previous;
+		if (!Cancelling() && previous.Load(indexPath, root)) {
+			std::vector<int> newIds(previous.FileCount(), -1);
+			for (size_t id = 0; id < files.size(); id++) {
+				size_t idPrevious = 0;
+				if (previous.Lookup(files[id].path, idPrevious) &&
+					previous.Matches(idPrevious, files[id].modified, files[id].size)) {
+					newIds[idPrevious] = static_cast<int>(id);
+					reused[id] = true;
+					files[id].indexed = previous.Indexed(idPrevious);
+				}
+			}
+			std::vector<unsigned int> ids;
+			for (size_t t = 0; (t < previous.TrigramCount()) && !Cancelling(); t++) {
+				previous.Postings(t, ids);
+				PostingBuilder *builder = 0;
+				for (size_t i = 0; i < ids.size(); i++) {
+					// Files keep their order so the new ids are also increasing.
+					if (newIds[ids[i]] >= 0) {
+						if (!builder)
+							builder = &builders[previous.Trigram(t)];
+						builder->AddReused(newIds[ids[i]]);
+					}
+				}
+			}
+		}
+	}
+
+	TrigramSet trigramSet;
+	for (size_t id = 0; (id < files.size()) && !Cancelling(); id++) {
+		if (!reused[id] && (files[id].size <= grepIndexMaxFileSize)) {
+			FileContents contents(files[id].path);
+			if (contents.Data() && !contents.StartContainsNull()) {
+				ForEachTrigram(contents.Data(), contents.Length(), trigramSet);
+				PostingAdder adder(builders, static_cast<unsigned int>(id));
+				for (size_t t = 0; t < trigramSet.trigrams.size(); t++)
+					adder(trigramSet.trigrams[t]);
+				trigramSet.Clear();
+				files[id].indexed = true;
+			}
+		}
+		IncrementProgress(1);
+	}
+
+	if (!Cancelling()) {
+		std::string header(indexMagic, 4);
+		AppendUInt32(header, grepIndexVersion);
+		AppendUInt32(header, static_cast<unsigned int>(files.size()));
+		AppendUInt32(header, static_cast<unsigned int>(builders.size()));
+		AppendUInt32(header, static_cast<unsigned int>(rootPrefix.length()));
+		header += rootPrefix;
+		for (size_t id = 0; id < files.size(); id++) {
+			AppendUInt32(header, static_cast<unsigned int>(files[id].relative.length()));
+			header += files[id].relative;
+			AppendUInt64(header, files[id].modified);
+			AppendUInt64(header, files[id].size);
+			AppendUInt32(header, files[id].indexed ? 1 : 0);
+		}
+		std::string table;
+		std::string postingData;
+		for (std::map<unsigned int, PostingBuilder>::iterator it = builders.begin(); it != builders.end(); ++it) {
+			AppendUInt32(table, it->first);
+			AppendUInt32(table, it->second.count);
+			AppendUInt64(table, postingData.length());
+			it->second.Write(postingData);
+			// Release memory as the postings are written.
+			std::string().swap(it->second.reused);
+			std::string().swap(it->second.added);
+		}
+
+		// Write to a temporary file then replace so a search never sees a partial index.
+		FilePath pathTemporary(indexPath.AsInternal() + GUI::gui_string(GUI_TEXT(".tmp")));
+		FILE *fp = pathTemporary.Open(fileWrite);
+		if (fp) {
+			bool written = (fwrite(header.c_str(), header.length(), 1, fp) == 1) &&
+				(table.empty() || fwrite(table.c_str(), table.length(), 1, fp) == 1) &&
+				(postingData.empty() || fwrite(postingData.c_str(), postingData.length(), 1, fp) == 1);
+			written = (fclose(fp) == 0) && written;
+			if (!written || !ReplaceFile(pathTemporary, indexPath)) {
+				pathTemporary.Remove();
+			}
+		}
+	}
+	SetCompleted();
+	pListener->PostOnMainThread(WORK_GREPINDEXED, this);
+}
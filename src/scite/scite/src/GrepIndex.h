@@ -0,0 +1,83 @@
+// SciTE - Scintilla based Text Editor
+/** @file GrepIndex.h
+ ** Definition of the trigram index used to limit the files read by find in files.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef GREPINDEX_H
+#define GREPINDEX_H
+
+/// Version of the index file format. An index with any other version is rebuilt.
+const unsigned int grepIndexVersion = 2;
+/// Files larger than this are not indexed so are always searched.
+const long long grepIndexMaxFileSize = 32 * 1024 * 1024;
+
+bool GrepFileStatus(const FilePath &fPath, long long &modified, long long &size);
+
+/// Read only access to an index file which is memory mapped.
+/// The index maps each case folded trigram to the files that contain it.
+/// Files that are not in the index, have changed since it was built, or were
+/// too large or binary to index are always treated as candidates.
+class GrepIndex {
+	FileContents *contents;
+	std::string rootPrefix;
+	std::map<std::string, size_t> fileIds;
+	std::vector<long long> modifieds;
+	std::vector<long long> sizes;
+	std::vector<bool> indexed;
+	const char *trigramTable;
+	size_t trigramCount;
+	const char *postings;
+	size_t postingsLength;
+	std::vector<bool> candidates;
+	bool selected;
+	size_t filesChanged;
+	// Deleted so GrepIndex objects can not be copied
+	GrepIndex(const GrepIndex &);
+	GrepIndex &operator=(const GrepIndex &);
+public:
+	GrepIndex();
+	~GrepIndex();
+	/// Fails if the index is missing, damaged, has another version or is for another root.
+	bool Load(const FilePath &indexPath, const FilePath &root);
+	void Close();
+	size_t FileCount() const {
+		return modifieds.size();
+	}
+	bool Lookup(const FilePath &fPath, size_t &id) const;
+	bool Matches(size_t id, long long modified, long long size) const;
+	bool Indexed(size_t id) const {
+		return indexed[id];
+	}
+	size_t TrigramCount() const {
+		return trigramCount;
+	}
+	unsigned int Trigram(size_t position) const;
+	/// Decode the sorted ids of the files containing the trigram at position.
+	void Postings(size_t position, std::vector<unsigned int> &ids) const;
+
+	/// Restrict the candidates to indexed files containing every trigram of literal.
+	/// Literals shorter than a trigram do not restrict the candidates.
+	void SelectCandidates(const std::string &literal);
+	/// Can the file be skipped because the index shows it can not contain the literal?
+	/// Also notes whether the index is out of date.
+	bool Excludes(const FilePath &fPath);
+	/// Did the search see files that are missing from the index or have changed?
+	/// Deleted files are not noticed as they can not cause matches to be missed.
+	bool Stale() const;
+};
+
+/// Builds or updates an index on a background thread. Files that have the same
+/// modification time and size as in the previous index keep their trigrams
+/// without being read again. Like find in files, directories starting with '.' are skipped.
+class GrepIndexer : public Worker {
+	WorkerListener *pListener;
+	FilePath root;
+	FilePath indexPath;
+public:
+	GrepIndexer(WorkerListener *pListener_, const FilePath &root_, const FilePath &indexPath_);
+	virtual ~GrepIndexer();
+	virtual void Execute();
+};
+
+#endif
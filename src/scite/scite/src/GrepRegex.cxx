@@ -0,0 +1,767 @@
+// SciTE - Scintilla based Text Editor
+/** @file GrepRegex.cxx
+ ** Regular expressions compiled to a deterministic automaton for find in files.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <string.h>
+#include <ctype.h>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+#include "GrepRegex.h"
+
+namespace {
+
+/// Limits beyond which the expression is left to std::regex.
+const size_t maxInstructions = 20000;
+const size_t maxStates = 4000;
+const int maxRepeat = 1000;
+const int repeatInfinite = -1;
+
+class ByteSet {
+	unsigned int bits[8];
+public:
+	ByteSet() {
+		memset(bits, 0, sizeof(bits));
+	}
+	void Add(int ch) {
+		bits[ch >> 5] |= 1U << (ch & 31);
+	}
+	void AddRange(int first, int last) {
+		for (int ch = first; ch <= last; ch++)
+			Add(ch);
+	}
+	void AddSet(const ByteSet &other) {
+		for (int i = 0; i < 8; i++)
+			bits[i] |= other.bits[i];
+	}
+	bool Contains(int ch) const {
+		return (bits[ch >> 5] & (1U << (ch & 31))) != 0;
+	}
+	void Invert() {
+		for (int i = 0; i < 8; i++)
+			bits[i] = ~bits[i];
+	}
+	void FoldCase() {
+		for (int ch = 'a'; ch <= 'z'; ch++) {
+			if (Contains(ch) || Contains(ch - 'a' + 'A')) {
+				Add(ch);
+				Add(ch - 'a' + 'A');
+			}
+		}
+	}
+};
+
+bool IsWordByte(int ch) {
+	return (ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z') || (ch >= '0' && ch <= '9') || (ch == '_');
+}
+
+ByteSet WordSet() {
+	ByteSet set;
+	set.AddRange('a', 'z');
+	set.AddRange('A', 'Z');
+	set.AddRange('0', '9');
+	set.Add('_');
+	return set;
+}
+
+ByteSet DigitSet() {
+	ByteSet set;
+	set.AddRange('0', '9');
+	return set;
+}
+
+ByteSet SpaceSet() {
+	ByteSet set;
+	set.AddRange('\t', '\r');
+	set.Add(' ');
+	return set;
+}
+
+enum AssertKind { assertLineStart, assertLineEnd, assertWordBoundary, assertNotWordBoundary };
+
+struct Node {
+	enum Kind { nodeEmpty, nodeSet, nodeConcat, nodeAlternate, nodeRepeat, nodeAssert };
+	Kind kind;
+	ByteSet set;
+	// For literal characters, used to find the required literal.
+	int literal;
+	AssertKind assertion;
+	int repeatMin;
+	int repeatMax;
+	std::vector<int> children;
+	explicit Node(Kind kind_) : kind(kind_), literal(-1), assertion(assertLineStart), repeatMin(0), repeatMax(0) {
+	}
+};
+
+/// Recursive descent parser producing a tree of Nodes.
+/// Fails on anything outside the supported subset.
+class Parser {
+	const std::string &pattern;
+	size_t pos;
+	bool matchCase;
+public:
+	std::vector<Node> nodes;
+	Parser(const std::string &pattern_, bool matchCase_) : pattern(pattern_), pos(0), matchCase(matchCase_) {
+	}
+	bool AtEnd() const {
+		return pos >= pattern.length();
+	}
+	int Peek() const {
+		return static_cast<unsigned char>(pattern[pos]);
+	}
+	int Add(const Node &node) {
+		nodes.push_back(node);
+		return static_cast<int>(nodes.size() - 1);
+	}
+	int AddSet(const ByteSet &set, int literal) {
+		Node node(Node::nodeSet);
+		node.set = set;
+		if (!matchCase)
+			node.set.FoldCase();
+		if (literal >= 0)
+			node.literal = (!matchCase && literal >= 'A' && literal <= 'Z') ? (literal - 'A' + 'a') : literal;
+		return Add(node);
+	}
+	// Returns node index or -1 for failure.
+	int ParseAlternation() {
+		Node alternate(Node::nodeAlternate);
+		for (;;) {
+			const int branch = ParseConcatenation();
+			if (branch < 0)
+				return -1;
+			alternate.children.push_back(branch);
+			if (AtEnd() || Peek() != '|')
+				break;
+			pos++;
+		}
+		if (alternate.children.size() == 1)
+			return alternate.children[0];
+		return Add(alternate);
+	}
+	int ParseConcatenation() {
+		Node concat(Node::nodeConcat);
+		while (!AtEnd() && Peek() != '|' && Peek() != ')') {
+			const int item = ParseRepeat();
+			if (item < 0)
+				return -1;
+			concat.children.push_back(item);
+		}
+		if (concat.children.empty())
+			return Add(Node(Node::nodeEmpty));
+		if (concat.children.size() == 1)
+			return concat.children[0];
+		return Add(concat);
+	}
+	bool ParseCount(int &value) {
+		if (AtEnd() || !isdigit(Peek()))
+			return false;
+		value = 0;
+		while (!AtEnd() && isdigit(Peek())) {
+			value = value * 10 + (Peek() - '0');
+			if (value > maxRepeat)
+				return false;
+			pos++;
+		}
+		return true;
+	}
+	int ParseRepeat() {
+		int atom = ParseAtom();
+		if (atom < 0 || AtEnd())
+			return atom;
+		int repeatMin = 0;
+		int repeatMax = 0;
+		const int ch = Peek();
+		if (ch == '*') {
+			repeatMin = 0;
+			repeatMax = repeatInfinite;
+			pos++;
+		} else if (ch == '+') {
+			repeatMin = 1;
+			repeatMax = repeatInfinite;
+			pos++;
+		} else if (ch == '?') {
+			repeatMin = 0;
+			repeatMax = 1;
+			pos++;
+		} else if (ch == '{') {
+			pos++;
+			if (!ParseCount(repeatMin))
+				return -1;
+			repeatMax = repeatMin;
+			if (!AtEnd() && Peek() == ',') {
+				pos++;
+				repeatMax = repeatInfinite;
+				if (!AtEnd() && Peek() != '}') {
+					if (!ParseCount(repeatMax) || repeatMax < repeatMin)
+						return -1;
+				}
+			}
+			if (AtEnd() || Peek() != '}')
+				return -1;
+			pos++;
+		} else {
+			return atom;
+		}
+		// Lazy quantifiers match the same lines as greedy ones.
+		if (!AtEnd() && Peek() == '?')
+			pos++;
+		if (nodes[atom].kind == Node::nodeAssert)
+			return -1;
+		if (!AtEnd() && (Peek() == '*' || Peek() == '+' || Peek() == '?' || Peek() == '{'))
+			return -1;
+		Node repeat(Node::nodeRepeat);
+		repeat.repeatMin = repeatMin;
+		repeat.repeatMax = repeatMax;
+		repeat.children.push_back(atom);
+		return Add(repeat);
+	}
+	bool ParseClassEscape(ByteSet &set, int &single) {
+		// Called after '\\' inside or outside a class. Sets single for a single character.
+		if (AtEnd())
+			return false;
+		const int ch = Peek();
+		pos++;
+		single = -1;
+		switch (ch) {
+		case 'd':
+			set.AddSet(DigitSet());
+			return true;
+		case 'D': {
+				ByteSet other = DigitSet();
+				other.Invert();
+				set.AddSet(other);
+				return true;
+			}
+		case 'w':
+			set.AddSet(WordSet());
+			return true;
+		case 'W': {
+				ByteSet other = WordSet();
+				other.Invert();
+				set.AddSet(other);
+				return true;
+			}
+		case 's':
+			set.AddSet(SpaceSet());
+			return true;
+		case 'S': {
+				ByteSet other = SpaceSet();
+				other.Invert();
+				set.AddSet(other);
+				return true;
+			}
+		case 't':
+			single = '\t';
+			break;
+		case 'n':
+			single = '\n';
+			break;
+		case 'r':
+			single = '\r';
+			break;
+		case 'f':
+			single = '\f';
+			break;
+		case 'v':
+			single = '\v';
+			break;
+		default:
+			// Back references, \0, \x, \u, \c and \b inside classes are left to std::regex.
+			if (isalnum(ch) || ch >= 0x80)
+				return false;
+			single = ch;
+			break;
+		}
+		set.Add(single);
+		return true;
+	}
+	int ParseClass() {
+		// Called after '['
+		ByteSet set;
+		bool negate = false;
+		if (!AtEnd() && Peek() == '^') {
+			negate = true;
+			pos++;
+		}
+		bool first = true;
+		for (;;) {
+			if (AtEnd())
+				return -1;
+			int ch = Peek();
+			if (ch == ']' && !first)
+				break;
+			if (ch == ']' || ch == '[')
+				return -1;
+			first = false;
+			pos++;
+			int low = ch;
+			if (ch == '\\') {
+				if (!ParseClassEscape(set, low))
+					return -1;
+				if (low < 0)
+					continue;
+			} else {
+				set.Add(low);
+			}
+			if (!AtEnd() && Peek() == '-' && (pos + 1 < pattern.length()) && pattern[pos + 1] != ']') {
+				pos++;
+				int high = Peek();
+				pos++;
+				if (high == '\\') {
+					ByteSet ignored;
+					if (!ParseClassEscape(ignored, high) || high < 0)
+						return -1;
+				}
+				if ((high < low) || (high >= 0x80) || (low >= 0x80))
+					return -1;
+				set.AddRange(low, high);
+			}
+		}
+		pos++;
+		if (!matchCase)
+			set.FoldCase();
+		if (negate)
+			set.Invert();
+		Node node(Node::nodeSet);
+		node.set = set;
+		return Add(node);
+	}
+	int AddAssertion(AssertKind assertion) {
+		Node node(Node::nodeAssert);
+		node.assertion = assertion;
+		return Add(node);
+	}
+	int ParseAtom() {
+		const int ch = Peek();
+		pos++;
+		switch (ch) {
+		case '(': {
+				if (!AtEnd() && Peek() == '?') {
+					// Only non-capturing groups, not lookahead.
+					if (pos + 1 >= pattern.length() || pattern[pos + 1] != ':')
+						return -1;
+					pos += 2;
+				}
+				const int inner = ParseAlternation();
+				if (inner < 0 || AtEnd() || Peek() != ')')
+					return -1;
+				pos++;
+				return inner;
+			}
+		case '[':
+			return ParseClass();
+		case '.': {
+				ByteSet set;
+				set.Add('\n');
+				set.Add('\r');
+				set.Invert();
+				return AddSet(set, -1);
+			}
+		case '^':
+			return AddAssertion(assertLineStart);
+		case '$':
+			return AddAssertion(assertLineEnd);
+		case '\\': {
+				if (AtEnd())
+					return -1;
+				if (Peek() == 'b') {
+					pos++;
+					return AddAssertion(assertWordBoundary);
+				}
+				if (Peek() == 'B') {
+					pos++;
+					return AddAssertion(assertNotWordBoundary);
+				}
+				ByteSet set;
+				int single = -1;
+				if (!ParseClassEscape(set, single))
+					return -1;
+				return AddSet(set, single);
+			}
+		case ')':
+		case ']':
+		case '{':
+		case '}':
+		case '*':
+		case '+':
+		case '?':
+			return -1;
+		default: {
+				ByteSet set;
+				set.Add(ch);
+				return AddSet(set, ch);
+			}
+		}
+	}
+};
+
+/// Finds the longest run of literal characters that every match must contain.
+class LiteralFinder {
+	const std::vector<Node> &nodes;
+	std::string current;
+public:
+	std::string longest;
+	explicit LiteralFinder(const std::vector<Node> &nodes_) : nodes(nodes_) {
+	}
+	void EndRun() {
+		if (current.length() > longest.length())
+			longest = current;
+		current.clear();
+	}
+	void Walk(int index) {
+		const Node &node = nodes[index];
+		switch (node.kind) {
+		case Node::nodeConcat:
+			for (size_t i = 0; i < node.children.size(); i++)
+				Walk(node.children[i]);
+			break;
+		case Node::nodeSet:
+			if (node.literal >= 0) {
+				current.push_back(static_cast<char>(node.literal));
+			} else {
+				EndRun();
+			}
+			break;
+		case Node::nodeRepeat:
+			if (node.repeatMin >= 1 && nodes[node.children[0]].kind == Node::nodeSet &&
+				nodes[node.children[0]].literal >= 0) {
+				const char literal = static_cast<char>(nodes[node.children[0]].literal);
+				if (node.repeatMin == node.repeatMax) {
+					current.append(node.repeatMin, literal);
+					break;
+				}
+				// Only the first repetition is known to follow the current run.
+				current.push_back(literal);
+			}
+			EndRun();
+			break;
+		case Node::nodeAssert:
+		case Node::nodeEmpty:
+			// Zero width so runs continue across them.
+			break;
+		default:
+			EndRun();
+			break;
+		}
+	}
+};
+
+/// Thompson style program built from the tree.
+struct Instruction {
+	enum Op { opSet, opSplit, opJump, opAssert, opMatch };
+	Op op;
+	int set;
+	AssertKind assertion;
+	int x;
+	int y;
+	Instruction(Op op_) : op(op_), set(0), assertion(assertLineStart), x(0), y(0) {
+	}
+};
+
+class Program {
+	const std::vector<Node> &nodes;
+public:
+	std::vector<Instruction> code;
+	std::vector<ByteSet> sets;
+	explicit Program(const std::vector<Node> &nodes_) : nodes(nodes_) {
+	}
+	int Emit(const Instruction &instruction) {
+		code.push_back(instruction);
+		return static_cast<int>(code.size() - 1);
+	}
+	int Next() const {
+		return static_cast<int>(code.size());
+	}
+	bool Compile(int index) {
+		if (code.size() > maxInstructions)
+			return false;
+		const Node &node = nodes[index];
+		switch (node.kind) {
+		case Node::nodeEmpty:
+			return true;
+		case Node::nodeSet: {
+				Instruction instruction(Instruction::opSet);
+				instruction.set = static_cast<int>(sets.size());
+				sets.push_back(node.set);
+				instruction.x = Next() + 1;
+				Emit(instruction);
+				return true;
+			}
+		case Node::nodeAssert: {
+				Instruction instruction(Instruction::opAssert);
+				instruction.assertion = node.assertion;
+				instruction.x = Next() + 1;
+				Emit(instruction);
+				return true;
+			}
+		case Node::nodeConcat:
+			for (size_t i = 0; i < node.children.size(); i++) {
+				if (!Compile(node.children[i]))
+					return false;
+			}
+			return true;
+		case Node::nodeAlternate: {
+				std::vector<int> jumps;
+				for (size_t i = 0; i < node.children.size(); i++) {
+					int split = -1;
+					if (i + 1 < node.children.size()) {
+						split = Emit(Instruction(Instruction::opSplit));
+						code[split].x = Next();
+					}
+					if (!Compile(node.children[i]))
+						return false;
+					if (split >= 0) {
+						jumps.push_back(Emit(Instruction(Instruction::opJump)));
+						code[split].y = Next();
+					}
+				}
+				for (size_t j = 0; j < jumps.size(); j++)
+					code[jumps[j]].x = Next();
+				return true;
+			}
+		case Node::nodeRepeat: {
+				const int child = node.children[0];
+				for (int i = 0; i < node.repeatMin; i++) {
+					if (!Compile(child))
+						return false;
+				}
+				if (node.repeatMax == repeatInfinite) {
+					const int split = Emit(Instruction(Instruction::opSplit));
+					code[split].x = Next();
+					if (!Compile(child))
+						return false;
+					Instruction jump(Instruction::opJump);
+					jump.x = split;
+					Emit(jump);
+					code[split].y = Next();
+				} else {
+					std::vector<int> splits;
+					for (int i = node.repeatMin; i < node.repeatMax; i++) {
+						const int split = Emit(Instruction(Instruction::opSplit));
+						code[split].x = Next();
+						splits.push_back(split);
+						if (!Compile(child))
+							return false;
+					}
+					for (size_t s = 0; s < splits.size(); s++)
+						code[splits[s]].y = Next();
+				}
+				return true;
+			}
+		}
+		return false;
+	}
+};
+
+/// Context needed to evaluate zero width assertions between two bytes.
+struct Context {
+	bool atStart;
+	bool atEnd;
+	bool previousWord;
+	bool nextWord;
+};
+
+class AutomatonBuilder {
+	const Program &program;
+	std::vector<int> marks;
+	int generation;
+	std::vector<int> stack;
+public:
+	explicit AutomatonBuilder(const Program &program_) : program(program_), marks(program_.code.size(), 0), generation(0) {
+	}
+	bool AssertionHolds(AssertKind assertion, const Context &context) const {
+		switch (assertion) {
+		case assertLineStart:
+			return context.atStart;
+		case assertLineEnd:
+			return context.atEnd;
+		case assertWordBoundary:
+			return context.previousWord != context.nextWord;
+		case assertNotWordBoundary:
+			return context.previousWord == context.nextWord;
+		}
+		return false;
+	}
+	/// Follow splits, jumps and assertions that hold from the threads in states.
+	/// Returns true if a match instruction is reached. Consuming instructions are added to closure.
+	bool Closure(const std::vector<int> &states, const Context &context, std::vector<int> &closure) {
+		generation++;
+		bool matched = false;
+		for (size_t i = 0; i < states.size(); i++) {
+			stack.push_back(states[i]);
+			while (!stack.empty()) {
+				const int pc = stack.back();
+				stack.pop_back();
+				if (marks[pc] == generation)
+					continue;
+				marks[pc] = generation;
+				const Instruction &instruction = program.code[pc];
+				switch (instruction.op) {
+				case Instruction::opSet:
+					closure.push_back(pc);
+					break;
+				case Instruction::opSplit:
+					stack.push_back(instruction.y);
+					stack.push_back(instruction.x);
+					break;
+				case Instruction::opJump:
+					stack.push_back(instruction.x);
+					break;
+				case Instruction::opAssert:
+					if (AssertionHolds(instruction.assertion, context))
+						stack.push_back(instruction.x);
+					break;
+				case Instruction::opMatch:
+					matched = true;
+					break;
+				}
+			}
+		}
+		return matched;
+	}
+};
+
+struct StateKey {
+	std::vector<int> threads;
+	bool atStart;
+	bool previousWord;
+	bool operator<(const StateKey &other) const {
+		if (atStart != other.atStart)
+			return atStart < other.atStart;
+		if (previousWord != other.previousWord)
+			return previousWord < other.previousWord;
+		return threads < other.threads;
+	}
+};
+
+}
+
+GrepRegex::GrepRegex() : classCount(0) {
+	memset(byteClass, 0, sizeof(byteClass));
+}
+
+GrepRegex::~GrepRegex() {
+}
+
+bool GrepRegex::Compile(const std::string &pattern, bool matchCase) {
+	requiredLiteral.clear();
+	transitions.clear();
+	endMatches.clear();
+	classCount = 0;
+
+	Parser parser(pattern, matchCase);
+	const int root = parser.ParseAlternation();
+	if (root < 0 || !parser.AtEnd())
+		return false;
+
+	LiteralFinder finder(parser.nodes);
+	finder.Walk(root);
+	finder.EndRun();
+	requiredLiteral = finder.longest;
+
+	Program program(parser.nodes);
+	if (!program.Compile(root))
+		return false;
+	program.Emit(Instruction(Instruction::opMatch));
+	if (program.code.size() > maxInstructions)
+		return false;
+
+	// Bytes that are treated the same by every set and by word boundaries share a class.
+	std::map<std::string, int> signatures;
+	std::vector<int> representatives;
+	for (int ch = 0; ch < 256; ch++) {
+		std::string signature(1, IsWordByte(ch) ? 'w' : '-');
+		for (size_t s = 0; s < program.sets.size(); s++)
+			signature.push_back(program.sets[s].Contains(ch) ? '1' : '0');
+		std::map<std::string, int>::iterator it = signatures.find(signature);
+		if (it == signatures.end()) {
+			const int classNew = static_cast<int>(representatives.size());
+			signatures[signature] = classNew;
+			representatives.push_back(ch);
+			byteClass[ch] = static_cast<unsigned char>(classNew);
+		} else {
+			byteClass[ch] = static_cast<unsigned char>(it->second);
+		}
+	}
+	classCount = static_cast<int>(representatives.size());
+
+	// Subset construction over all reachable states. The start instruction is added
+	// to every state so matches may begin at any position.
+	AutomatonBuilder builder(program);
+	std::vector<StateKey> states;
+	std::map<StateKey, int> stateIndex;
+	StateKey start;
+	start.threads.push_back(0);
+	start.atStart = true;
+	start.previousWord = false;
+	states.push_back(start);
+	stateIndex[start] = 0;
+	std::vector<int> table;
+	std::vector<int> closure;
+	for (size_t state = 0; state < states.size(); state++) {
+		const StateKey key = states[state];
+		for (int cls = 0; cls < classCount; cls++) {
+			const int ch = representatives[cls];
+			Context context;
+			context.atStart = key.atStart;
+			context.atEnd = false;
+			context.previousWord = key.previousWord;
+			context.nextWord = IsWordByte(ch);
+			closure.clear();
+			if (builder.Closure(key.threads, context, closure)) {
+				table.push_back(matchFound);
+				continue;
+			}
+			StateKey next;
+			next.atStart = false;
+			next.previousWord = context.nextWord;
+			for (size_t t = 0; t < closure.size(); t++) {
+				const Instruction &instruction = program.code[closure[t]];
+				if (program.sets[instruction.set].Contains(ch))
+					next.threads.push_back(instruction.x);
+			}
+			next.threads.push_back(0);
+			std::sort(next.threads.begin(), next.threads.end());
+			next.threads.erase(std::unique(next.threads.begin(), next.threads.end()), next.threads.end());
+			std::map<StateKey, int>::iterator it = stateIndex.find(next);
+			if (it == stateIndex.end()) {
+				if (states.size() >= maxStates)
+					return false;
+				const int indexNew = static_cast<int>(states.size());
+				stateIndex[next] = indexNew;
+				states.push_back(next);
+				table.push_back(indexNew);
+			} else {
+				table.push_back(it->second);
+			}
+		}
+	}
+	std::vector<bool> ends;
+	for (size_t state = 0; state < states.size(); state++) {
+		Context context;
+		context.atStart = states[state].atStart;
+		context.atEnd = true;
+		context.previousWord = states[state].previousWord;
+		context.nextWord = false;
+		closure.clear();
+		ends.push_back(builder.Closure(states[state].threads, context, closure));
+	}
+	transitions.swap(table);
+	endMatches.swap(ends);
+	return true;
+}
+
+bool GrepRegex::Search(const char *start, const char *end) const {
+	int state = 0;
+	for (const char *position = start; position < end; position++) {
+		state = transitions[state * classCount + byteClass[static_cast<unsigned char>(*position)]];
+		if (state == matchFound)
+			return true;
+	}
+	return endMatches[state];
+}
@@ -0,0 +1,48 @@
+// SciTE - Scintilla based Text Editor
+/** @file GrepRegex.h
+ ** Regular expressions compiled to a deterministic automaton for find in files.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef GREPREGEX_H
+#define GREPREGEX_H
+
+/// Handles the regular subset of ECMAScript expressions: literals, ".", classes,
+/// "\d\w\s" and their negations, groups, alternation, repetition, "^", "$", "\b" and "\B".
+/// Expressions with back references or lookahead are not compiled so the caller
+/// can fall back to std::regex. Matching is by byte and case folding is ASCII only
+/// which is how std::regex treats char strings in the "C" locale.
+/// After Compile, the object is only read so may be shared between threads.
+class GrepRegex {
+public:
+	GrepRegex();
+	~GrepRegex();
+	/// Returns true when the automaton was built and Search may be called.
+	bool Compile(const std::string &pattern, bool matchCase);
+	bool Compiled() const {
+		return !transitions.empty();
+	}
+	/// A string that must occur in every match, lowered when not matching case.
+	/// Available whenever the expression could be parsed, even if the automaton
+	/// became too large to build. Empty when no such string was found.
+	const std::string &RequiredLiteral() const {
+		return requiredLiteral;
+	}
+	/// Is there a match anywhere in [start, end)?
+	bool Search(const char *start, const char *end) const;
+
+private:
+	std::string requiredLiteral;
+	int classCount;
+	unsigned char byteClass[256];
+	/// State * classCount + class -> next state or matchFound.
+	std::vector<int> transitions;
+	/// Does the state match when the end of the text is reached?
+	std::vector<bool> endMatches;
+	enum { matchFound = -1 };
+	// Deleted so GrepRegex objects can not be copied
+	GrepRegex(const GrepRegex &);
+	GrepRegex &operator=(const GrepRegex &);
+};
+
+#endif
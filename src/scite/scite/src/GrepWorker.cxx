@@ -0,0 +1,663 @@
+// SciTE - Scintilla based Text Editor
+/** @file GrepWorker.cxx
+ ** Implementation of classes to search files on several threads for find in files.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <set>
+#include <map>
+#include <algorithm>
+
+#if defined(__unix__)
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#else
+
+#undef _WIN32_WINNT
+#define _WIN32_WINNT  0x0602
+#include <windows.h>
+
+#endif
+
+#include "Scintilla.h"
+#include "ILexer.h"
+
+#include "GUI.h"
+
+#include "StringList.h"
+#include "StringHelpers.h"
+#include "FilePath.h"
+#include "StyleDefinition.h"
+#include "PropSetFile.h"
+#include "StyleWriter.h"
+#include "Extender.h"
+#include "SciTE.h"
+#include "Mutex.h"
+#include "JobQueue.h"
+#include "Cookie.h"
+#include "Worker.h"
+#include "FileWorker.h"
+#include "MatchMarker.h"
+#include "SciTEBase.h"
+#include "GrepRegex.h"
+#include "GrepWorker.h"
+
+#if CXX11_REGEX_ENABLED
+#include <regex>
+#endif
+
+static void SleepMilliseconds(int milliseconds) {
+#ifdef __unix__
+	usleep(milliseconds * 1000);
+#else
+	::Sleep(milliseconds);
+#endif
+}
+
+FileContents::FileContents(const FilePath &fPath, bool mapAlways) : data(0), length(0), mapped(0), mapping(0) {
+#if defined(__unix__)
+	int fd = open(fPath.AsInternal(), O_RDONLY);
+	if (fd < 0)
+		return;
+	struct stat statFile;
+	if ((fstat(fd, &statFile) == 0) && (statFile.st_size > 0)) {
+		length = static_cast<size_t>(statFile.st_size);
+		if (mapAlways || (length >= grepMapSize)) {
+			void *view = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (view != MAP_FAILED) {
+				mapped = view;
+				data = static_cast<const char *>(view);
+#ifdef MADV_SEQUENTIAL
+				// Searches read straight through while documents jump around
+				if (!mapAlways)
+					madvise(view, length, MADV_SEQUENTIAL);
+#endif
+			}
+		}
+		if (!data) {
+			block.resize(length);
+			size_t lenRead = 0;
+			while (lenRead < length) {
+				ssize_t lenBlock = read(fd, &block[lenRead], length - lenRead);
+				if (lenBlock <= 0)
+					break;
+				lenRead += lenBlock;
+			}
+			length = lenRead;
+			data = length ? &block[0] : 0;
+		}
+	}
+	close(fd);
+#else
+	HANDLE hFile = ::CreateFileW(fPath.AsInternal(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+		NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return;
+	LARGE_INTEGER sizeFile;
+	if (::GetFileSizeEx(hFile, &sizeFile) && (sizeFile.QuadPart > 0) &&
+		(static_cast<unsigned long long>(sizeFile.QuadPart) <= static_cast<size_t>(-1))) {
+		length = static_cast<size_t>(sizeFile.QuadPart);
+		if (mapAlways || (length >= grepMapSize)) {
+			// Sized to the file now so text appended by other programs is not mapped.
+			// Windows refuses to truncate a file below a mapping that is open.
+			mapping = ::CreateFileMappingW(hFile, NULL, PAGE_READONLY,
+				static_cast<DWORD>(sizeFile.HighPart), sizeFile.LowPart, NULL);
+			if (mapping) {
+				mapped = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, length);
+				data = static_cast<const char *>(mapped);
+			}
+		}
+		if (!data) {
+			block.resize(length);
+			size_t lenRead = 0;
+			while (lenRead < length) {
+				DWORD lenBlock = 0;
+				DWORD lenWant = static_cast<DWORD>(std::min<size_t>(length - lenRead, 0x40000000));
+				if (!::ReadFile(hFile, &block[lenRead], lenWant, &lenBlock, NULL) || (lenBlock == 0))
+					break;
+				lenRead += lenBlock;
+			}
+			length = lenRead;
+			data = length ? &block[0] : 0;
+		}
+	}
+	::CloseHandle(hFile);
+#endif
+}
+
+FileContents::~FileContents() {
+#if defined(__unix__)
+	if (mapped) {
+		munmap(mapped, length);
+	}
+#else
+	if (mapped) {
+		::UnmapViewOfFile(mapped);
+	}
+	if (mapping) {
+		::CloseHandle(mapping);
+	}
+#endif
+	mapped = 0;
+	mapping = 0;
+}
+
+bool FileContents::StartContainsNull() const {
+	return data && memchr(data, '\0', std::min(length, grepBinaryCheckSize)) != NULL;
+}
+
+static inline bool IsLineEnd(char ch) {
+	return (ch == '\r') || (ch == '\n');
+}
+
+static const char *LineStart(const char *bufferStart, const char *position) {
+	while ((position > bufferStart) && !IsLineEnd(position[-1]))
+		position--;
+	return position;
+}
+
+static const char *LineEnd(const char *position, const char *bufferEnd) {
+	while ((position < bufferEnd) && !IsLineEnd(*position))
+		position++;
+	return position;
+}
+
+static const char *NextLine(const char *lineEnd, const char *bufferEnd) {
+	if (lineEnd < bufferEnd) {
+		if ((*lineEnd == '\r') && (lineEnd + 1 < bufferEnd) && (lineEnd[1] == '\n'))
+			return lineEnd + 2;
+		return lineEnd + 1;
+	}
+	return bufferEnd;
+}
+
+/// Count the line ends, "\n", "\r\n", or a lone "\r", in a range.
+static int CountLineEnds(const char *start, const char *end) {
+	int lineEnds = 0;
+	for (const char *nl = start; (nl < end) && (nl = static_cast<const char *>(memchr(nl, '\n', end - nl))) != NULL; nl++)
+		lineEnds++;
+	for (const char *cr = start; (cr < end) && (cr = static_cast<const char *>(memchr(cr, '\r', end - cr))) != NULL; cr++) {
+		if ((cr + 1 >= end) || (cr[1] != '\n'))
+			lineEnds++;
+	}
+	return lineEnds;
+}
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define GREP_SSE2 1
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static inline int LowestBit(unsigned int mask) {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return static_cast<int>(index);
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+/// Finds a literal string in a buffer. When not matching case the needle has
+/// already been lowered and ASCII letters in the buffer are folded while comparing.
+class LiteralSearch {
+	std::string needle;
+	bool matchCase;
+	unsigned char fold[256];
+	bool Matches(const char *position) const {
+		if (matchCase)
+			return memcmp(position, needle.c_str(), needle.length()) == 0;
+		for (size_t i = 0; i < needle.length(); i++) {
+			if (fold[static_cast<unsigned char>(position[i])] != static_cast<unsigned char>(needle[i]))
+				return false;
+		}
+		return true;
+	}
+public:
+	LiteralSearch(const std::string &needle_, bool matchCase_) : needle(needle_), matchCase(matchCase_) {
+		for (int ch = 0; ch < 256; ch++) {
+			fold[ch] = static_cast<unsigned char>(((ch >= 'A') && (ch <= 'Z') && !matchCase) ? (ch - 'A' + 'a') : ch);
+		}
+	}
+	size_t Length() const {
+		return needle.length();
+	}
+	const char *Find(const char *start, const char *end) const {
+		const size_t lenNeedle = needle.length();
+		if (lenNeedle == 0)
+			return (start < end) ? start : NULL;
+		if (static_cast<size_t>(end - start) < lenNeedle)
+			return NULL;
+		const char *last = end - lenNeedle;
+		const char *position = start;
+		const unsigned char chFirst = static_cast<unsigned char>(needle[0]);
+		const unsigned char chLast = static_cast<unsigned char>(needle[lenNeedle - 1]);
+#ifdef GREP_SSE2
+		// Filter 16 positions at a time on both the first and last bytes of the needle.
+		// ORing in 0x20 folds case only when the needle byte is a lower case letter.
+		const __m128i vFirst = _mm_set1_epi8(static_cast<char>(chFirst));
+		const __m128i vLast = _mm_set1_epi8(static_cast<char>(chLast));
+		const __m128i vFoldFirst = _mm_set1_epi8(
+			(!matchCase && (chFirst >= 'a') && (chFirst <= 'z')) ? 0x20 : 0);
+		const __m128i vFoldLast = _mm_set1_epi8(
+			(!matchCase && (chLast >= 'a') && (chLast <= 'z')) ? 0x20 : 0);
+		while (position + 16 <= last + 1) {
+			const __m128i blockFirst = _mm_or_si128(
+				_mm_loadu_si128(reinterpret_cast<const __m128i *>(position)), vFoldFirst);
+			const __m128i blockLast = _mm_or_si128(
+				_mm_loadu_si128(reinterpret_cast<const __m128i *>(position + lenNeedle - 1)), vFoldLast);
+			unsigned int mask = _mm_movemask_epi8(_mm_and_si128(
+				_mm_cmpeq_epi8(blockFirst, vFirst), _mm_cmpeq_epi8(blockLast, vLast)));
+			while (mask) {
+				const char *candidate = position + LowestBit(mask);
+				if (Matches(candidate))
+					return candidate;
+				mask &= mask - 1;
+			}
+			position += 16;
+		}
+#endif
+		if (matchCase) {
+			while ((position <= last) &&
+				(position = static_cast<const char *>(memchr(position, chFirst, last - position + 1))) != NULL) {
+				if (Matches(position))
+					return position;
+				position++;
+			}
+			return NULL;
+		}
+		for (; position <= last; position++) {
+			if ((fold[static_cast<unsigned char>(*position)] == chFirst) && Matches(position))
+				return position;
+		}
+		return NULL;
+	}
+};
+
+static bool IsWordCharacter(int ch) {
+	return (ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z')  || (ch >= '0' && ch <= '9')  || (ch == '_');
+}
+
+#if CXX11_REGEX_ENABLED
+
+/// Searches with an automaton when the expression allows it and otherwise with std::regex.
+class RegexpSearch
+{
+	bool use;
+	bool valid;
+	bool useAutomaton;
+	stdregex::regex regexObject;
+	GrepRegex automaton;
+
+public:
+	RegexpSearch() : use(false), valid(false), useAutomaton(false) {}
+
+	bool Init(const char *searchString, bool matchCase, bool wholeWord, bool allowAutomaton) {
+		stdregex::regex::flag_type flagsRe = stdregex::regex::ECMAScript;
+		std::string sRegex = searchString;
+		use = true;
+
+		if (!searchString || !searchString[0]) {
+			return false;
+		}
+
+		if (!matchCase) {
+			flagsRe |= stdregex::regex::icase;
+		}
+
+		if (wholeWord) {
+			sRegex = std::string("\\b") + sRegex + "\\b";
+		}
+
+		try {
+			regexObject.assign(sRegex, flagsRe);
+		} catch (stdregex::regex_error &) {
+			// Failed to create regular expression
+			return false;
+		}
+
+		// std::regex has accepted the expression so it is valid even if the automaton can not handle it.
+		useAutomaton = automaton.Compile(sRegex, matchCase) && allowAutomaton;
+		valid = true;
+		return true;
+	}
+
+	// Only reads the compiled expression so may be called from several threads at once.
+	const char *Search(const char *line, const char *lineEnd) const {
+		if (useAutomaton) {
+			return automaton.Search(line, lineEnd) ? line : NULL;
+		}
+		try {
+			if (valid && stdregex::regex_search(line, lineEnd, regexObject)) {
+				return line;
+			}
+		} catch (stdregex::regex_error &) {
+			return NULL;
+		}
+
+		return NULL;
+	}
+
+	const std::string &RequiredLiteral() const {
+		return automaton.RequiredLiteral();
+	}
+
+	bool Use() const {
+		return use;
+	}
+
+	bool Enabled() const {
+		return true;
+	}
+};
+
+#else
+
+class RegexpSearch
+{
+	std::string none;
+public:
+	RegexpSearch() {}
+	bool Init(const char *, bool, bool, bool) { return false; }
+	const char *Search(const char *, const char *) const { return NULL; }
+	const std::string &RequiredLiteral() const { return none; }
+	bool Use() const { return false; }
+	bool Enabled() const { return false; }
+};
+
+#endif
+
+GrepSearch::GrepSearch() : regexpSearch(new RegexpSearch()), literalSearch(0) {
+}
+
+GrepSearch::~GrepSearch() {
+	delete regexpSearch;
+	regexpSearch = NULL;
+	delete literalSearch;
+	literalSearch = NULL;
+}
+
+bool GrepSearch::Init(const GrepParameters &params_) {
+	params = params_;
+	if (params.regExp && regexpSearch->Enabled()) {
+		if (!regexpSearch->Init(params.searchString.c_str(), params.matchCase, params.wholeWord, params.regExpAutomaton)) {
+			return false;
+		}
+		// Only lines containing a string required by the expression need to be tried.
+		if (!regexpSearch->RequiredLiteral().empty()) {
+			literalSearch = new LiteralSearch(regexpSearch->RequiredLiteral(), params.matchCase);
+		}
+		return true;
+	}
+	literalSearch = new LiteralSearch(params.searchString, params.matchCase);
+	return true;
+}
+
+std::string GrepSearch::RequiredLiteral() const {
+	if (regexpSearch->Use()) {
+		return regexpSearch->RequiredLiteral();
+	}
+	return params.searchString;
+}
+
+void GrepSearch::AppendLine(const FilePath &fPath, int lineNumber, const char *lineStart, const char *lineEnd, std::string &os) {
+	os.append(fPath.AsUTF8().c_str());
+	os.append(":");
+	std::string lNumber = StdStringFromInteger(lineNumber);
+	os.append(lNumber.c_str());
+	os.append(":");
+	os.append(lineStart, lineEnd - lineStart);
+	os.append("\n");
+}
+
+void GrepSearch::SearchFile(const FilePath &fPath, std::string &os) const {
+	FileContents contents(fPath);
+	if (!contents.Data() || (!params.binary && contents.StartContainsNull())) {
+		return;
+	}
+	const char *bufferStart = contents.Data();
+	const char *bufferEnd = bufferStart + contents.Length();
+	if (!literalSearch) {
+		int lineNumber = 1;
+		for (const char *line = bufferStart; line < bufferEnd; lineNumber++) {
+			const char *lineEnd = LineEnd(line, bufferEnd);
+			if (regexpSearch->Search(line, lineEnd)) {
+				AppendLine(fPath, lineNumber, line, lineEnd, os);
+			}
+			line = NextLine(lineEnd, bufferEnd);
+		}
+		return;
+	}
+	// Scan the whole buffer for the literal and only find the lines around each match.
+	// For regular expressions, the literal is a prefilter and the line is then checked.
+	const size_t searchLength = literalSearch->Length();
+	int lineNumber = 1;
+	const char *lineCounted = bufferStart;
+	const char *position = bufferStart;
+	while (const char *match = literalSearch->Find(position, bufferEnd)) {
+		if (params.wholeWord && !regexpSearch->Use()) {
+			const char *matchEnd = match + searchLength;
+			if (((match > bufferStart) && IsWordCharacter(match[-1])) ||
+				((matchEnd < bufferEnd) && IsWordCharacter(*matchEnd))) {
+				position = match + 1;
+				continue;
+			}
+		}
+		const char *lineStart = LineStart(bufferStart, match);
+		const char *lineEnd = LineEnd(match, bufferEnd);
+		if (!regexpSearch->Use() || regexpSearch->Search(lineStart, lineEnd)) {
+			lineNumber += CountLineEnds(lineCounted, lineStart);
+			lineCounted = lineStart;
+			AppendLine(fPath, lineNumber, lineStart, lineEnd, os);
+		}
+		position = NextLine(lineEnd, bufferEnd);
+		if (position >= bufferEnd)
+			break;
+	}
+}
+
+GrepWorker::GrepWorker(GrepEngine *pEngine_, size_t queue_) : pEngine(pEngine_), queue(queue_) {
+}
+
+void GrepWorker::Execute() {
+	pEngine->Run(queue);
+	SetCompleted();
+}
+
+GrepEngine::GrepEngine() : nextQueue(0), filesAdded(0), mutex(Mutex::Create()),
+	enumerated(false), cancelled(false), nextToEmit(0) {
+}
+
+GrepEngine::~GrepEngine() {
+	Cancel();
+	// Threads hold a pointer to this engine so wait for them all to stop.
+	for (size_t i = 0; i < workers.size(); i++) {
+		while (!workers[i]->FinishedJob()) {
+			SleepMilliseconds(1);
+		}
+		delete workers[i];
+	}
+	workers.clear();
+	for (size_t q = 0; q < queues.size(); q++) {
+		delete queues[q];
+	}
+	queues.clear();
+	delete mutex;
+	mutex = 0;
+}
+
+bool GrepEngine::Init(const GrepParameters &params) {
+	return search.Init(params);
+}
+
+void GrepEngine::Start(WorkerListener *pListener, int threads) {
+	if (threads <= 0) {
+		threads = ProcessorCount();
+	}
+	if (threads > grepMaxThreads) {
+		threads = grepMaxThreads;
+	}
+	for (int t = 0; t < threads; t++) {
+		queues.push_back(new BatchQueue());
+	}
+	for (int t = 0; t < threads; t++) {
+		GrepWorker *pWorker = new GrepWorker(this, t);
+		if (pListener && pListener->PerformOnNewThread(pWorker)) {
+			workers.push_back(pWorker);
+		} else {
+			// Batches in this queue will be stolen by the other threads or by Wait.
+			delete pWorker;
+		}
+	}
+}
+
+void GrepEngine::Distribute(GrepBatch &batch) {
+	BatchQueue *pQueue = queues[nextQueue];
+	nextQueue = (nextQueue + 1) % queues.size();
+	Lock lock(pQueue->mutex);
+	pQueue->batches.push_back(GrepBatch());
+	pQueue->batches.back().start = batch.start;
+	pQueue->batches.back().files.swap(batch.files);
+}
+
+void GrepEngine::AddFile(const FilePath &fPath) {
+	if (pending.files.empty()) {
+		pending.start = filesAdded;
+	}
+	pending.files.push_back(fPath);
+	filesAdded++;
+	if (pending.files.size() >= grepBatchSize) {
+		Distribute(pending);
+	}
+}
+
+void GrepEngine::EnumerationComplete() {
+	if (!pending.files.empty()) {
+		Distribute(pending);
+	}
+	Lock lock(mutex);
+	enumerated = true;
+}
+
+void GrepEngine::Cancel() {
+	Lock lock(mutex);
+	cancelled = true;
+}
+
+bool GrepEngine::Cancelled() const {
+	Lock lock(mutex);
+	return cancelled;
+}
+
+bool GrepEngine::PopBatch(size_t queue, GrepBatch &batch) {
+	BatchQueue *pQueue = queues[queue];
+	Lock lock(pQueue->mutex);
+	if (pQueue->batches.empty()) {
+		return false;
+	}
+	// Take the earliest batch so output can be released promptly.
+	batch.start = pQueue->batches.front().start;
+	batch.files.swap(pQueue->batches.front().files);
+	pQueue->batches.pop_front();
+	return true;
+}
+
+bool GrepEngine::StealBatch(size_t queue, GrepBatch &batch) {
+	for (size_t i = 1; i < queues.size(); i++) {
+		BatchQueue *pQueue = queues[(queue + i) % queues.size()];
+		Lock lock(pQueue->mutex);
+		if (!pQueue->batches.empty()) {
+			batch.start = pQueue->batches.back().start;
+			batch.files.swap(pQueue->batches.back().files);
+			pQueue->batches.pop_back();
+			return true;
+		}
+	}
+	return false;
+}
+
+void GrepEngine::StoreResult(size_t start, BatchResult &result) {
+	Lock lock(mutex);
+	BatchResult &stored = results[start];
+	stored.count = result.count;
+	stored.output.swap(result.output);
+}
+
+void GrepEngine::Run(size_t queue) {
+	for (;;) {
+		// Check for the end of enumeration before looking for work so no batch is missed.
+		bool finalPass;
+		{
+			Lock lock(mutex);
+			if (cancelled)
+				return;
+			finalPass = enumerated;
+		}
+		GrepBatch batch;
+		if (PopBatch(queue, batch) || StealBatch(queue, batch)) {
+			BatchResult result;
+			for (size_t i = 0; i < batch.files.size() && !Cancelled(); i++) {
+				search.SearchFile(batch.files[i], result.output);
+			}
+			result.count = batch.files.size();
+			StoreResult(batch.start, result);
+		} else if (finalPass) {
+			return;
+		} else {
+			SleepMilliseconds(1);
+		}
+	}
+}
+
+void GrepEngine::TakeOutput(std::string &os) {
+	Lock lock(mutex);
+	std::map<size_t, BatchResult>::iterator it = results.find(nextToEmit);
+	while (it != results.end()) {
+		os.append(it->second.output);
+		nextToEmit += it->second.count;
+		results.erase(it);
+		it = results.find(nextToEmit);
+	}
+}
+
+bool GrepEngine::Finished() const {
+	Lock lock(mutex);
+	return cancelled || (enumerated && (nextToEmit >= filesAdded));
+}
+
+void GrepEngine::Wait() {
+	if (workers.empty()) {
+		Run(0);
+	} else {
+		SleepMilliseconds(1);
+	}
+}
+
+int GrepEngine::ProcessorCount() {
+#ifdef __unix__
+	long processors = sysconf(_SC_NPROCESSORS_ONLN);
+	return (processors > 0) ? static_cast<int>(processors) : 1;
+#else
+	SYSTEM_INFO si;
+	::GetSystemInfo(&si);
+	return (si.dwNumberOfProcessors > 0) ? static_cast<int>(si.dwNumberOfProcessors) : 1;
+#endif
+}
@@ -0,0 +1,163 @@
+// SciTE - Scintilla based Text Editor
+/** @file GrepWorker.h
+ ** Definition of classes to search files on several threads for find in files.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef GREPWORKER_H
+#define GREPWORKER_H
+
+/// Number of files handed to a grep thread at a time.
+const size_t grepBatchSize = 32;
+/// Upper limit on the number of grep threads.
+const int grepMaxThreads = 16;
+/// Whole files smaller than this are read into memory, larger files are mapped.
+const size_t grepMapSize = 1024 * 1024;
+/// Only the start of a file is checked for NUL bytes to detect binary files.
+const size_t grepBinaryCheckSize = 64 * 1024;
+
+/// Read only view of the whole contents of a file.
+class FileContents {
+	const char *data;
+	size_t length;
+	std::vector<char> block;
+	void *mapped;
+	void *mapping;
+	// Deleted so FileContents objects can not be copied
+	FileContents(const FileContents &);
+	FileContents &operator=(const FileContents &);
+public:
+	/// With mapAlways the file is mapped whatever its size, for documents that read it in place.
+	/// Only the length found when opening is mapped so other programs may still append to the file.
+	explicit FileContents(const FilePath &fPath, bool mapAlways = false);
+	~FileContents();
+	const char *Data() const {
+		return data;
+	}
+	size_t Length() const {
+		return length;
+	}
+	bool StartContainsNull() const;
+};
+
+struct GrepParameters {
+	std::string searchString;
+	bool matchCase;
+	bool wholeWord;
+	bool binary;
+	bool regExp;
+	bool regExpAutomaton;
+	GrepParameters() : matchCase(false), wholeWord(false), binary(false), regExp(false), regExpAutomaton(true) {
+	}
+};
+
+class RegexpSearch;
+class LiteralSearch;
+
+/// Matches the search against the contents of one file.
+/// Files are read or mapped whole and literals are found by scanning the whole
+/// buffer so line boundaries are only worked out around matches.
+/// After Init, the object is only read so may be shared between threads.
+class GrepSearch {
+	GrepParameters params;
+	RegexpSearch *regexpSearch;
+	LiteralSearch *literalSearch;
+	static void AppendLine(const FilePath &fPath, int lineNumber, const char *lineStart, const char *lineEnd, std::string &os);
+	// Deleted so GrepSearch objects can not be copied
+	GrepSearch(const GrepSearch &);
+	GrepSearch &operator=(const GrepSearch &);
+public:
+	GrepSearch();
+	~GrepSearch();
+	bool Init(const GrepParameters &params_);
+	/// Append "path:line:text" lines for each matching line of fPath to os.
+	void SearchFile(const FilePath &fPath, std::string &os) const;
+	/// A string that every matching line contains or empty if there is none.
+	std::string RequiredLiteral() const;
+};
+
+/// A contiguous run of enumerated files. Results are merged in order of start.
+struct GrepBatch {
+	size_t start;
+	FilePathSet files;
+	GrepBatch() : start(0) {
+	}
+};
+
+class GrepEngine;
+
+class GrepWorker : public Worker {
+	GrepEngine *pEngine;
+	size_t queue;
+public:
+	GrepWorker(GrepEngine *pEngine_, size_t queue_);
+	virtual void Execute();
+};
+
+/// Searches files as they are enumerated with a pool of threads.
+/// Each thread owns a queue of batches and steals from the back of other
+/// queues when its own is empty. Output is released in enumeration order.
+class GrepEngine {
+	struct BatchQueue {
+		Mutex *mutex;
+		std::deque<GrepBatch> batches;
+		BatchQueue() : mutex(Mutex::Create()) {
+		}
+		~BatchQueue() {
+			delete mutex;
+		}
+	};
+	struct BatchResult {
+		size_t count;
+		std::string output;
+		BatchResult() : count(0) {
+		}
+	};
+	GrepSearch search;
+	std::vector<BatchQueue *> queues;
+	std::vector<GrepWorker *> workers;
+	GrepBatch pending;
+	size_t nextQueue;
+	size_t filesAdded;
+
+	Mutex *mutex;
+	bool enumerated;
+	bool cancelled;
+	size_t nextToEmit;
+	std::map<size_t, BatchResult> results;
+
+	// Deleted so GrepEngine objects can not be copied
+	GrepEngine(const GrepEngine &);
+	GrepEngine &operator=(const GrepEngine &);
+	void Distribute(GrepBatch &batch);
+	bool PopBatch(size_t queue, GrepBatch &batch);
+	bool StealBatch(size_t queue, GrepBatch &batch);
+	void StoreResult(size_t start, BatchResult &result);
+public:
+	GrepEngine();
+	~GrepEngine();
+	bool Init(const GrepParameters &params);
+	std::string RequiredLiteral() const {
+		return search.RequiredLiteral();
+	}
+	/// Start the threads. If no thread can be started, the files are searched in Wait.
+	void Start(WorkerListener *pListener, int threads);
+	/// Enumeration stage: queue a file to be searched.
+	void AddFile(const FilePath &fPath);
+	void EnumerationComplete();
+	void Cancel();
+	bool Cancelled() const;
+	/// Move any output that is ready, in enumeration order, into os.
+	void TakeOutput(std::string &os);
+	/// True when every file has been searched or the search was cancelled.
+	bool Finished() const;
+	/// Sleep for a little while, or search on this thread if no threads were started.
+	void Wait();
+
+	/// Called on grep threads to search batches until there are no more.
+	void Run(size_t queue);
+
+	static int ProcessorCount();
+};
+
+#endif
@@ -9,83 +9,6 @@
 #include <string.h>
 #include <ctype.h>
 
-int IFaceTable::FindConstant(const char *name) {
-	int lo = 0;
-	int hi = IFaceTable::constantCount - 1;
-	do {
-		int idx = (lo+hi)/2;
-		int cmp = strcmp(name, constants[idx].name);
-
-		if (cmp > 0) {
-			lo = idx + 1;
-		} else if (cmp < 0) {
-			hi = idx - 1;
-		} else {
-			return idx;
-		}
-	} while (lo <= hi);
-
-	return -1;
-}
-
-int IFaceTable::FindFunction(const char *name) {
-	int lo = 0;
-	int hi = IFaceTable::functionCount - 1;
-	do {
-		int idx = (lo+hi)/2;
-		int cmp = strcmp(name, functions[idx].name);
-		if (cmp > 0) {
-			lo = idx + 1;
-		} else if (cmp < 0) {
-			hi = idx - 1;
-		} else {
-			return idx;
-		}
-	} while (lo <= hi);
-
-	return -1;
-}
-
-int IFaceTable::FindFunctionByConstantName(const char *name) {
-	if (strncmp(name, "SCI_", 4)==0) {
-		// This looks like a constant for an iface function.  This requires
-		// a sequential search.  Take special care since the function names
-		// are mixed case, whereas the constants are all-caps.
-
-		for (int idx = 0; idx < functionCount; ++idx) {
-			const char *nm = name+4;
-			const char *fn = IFaceTable::functions[idx].name;
-			while (*nm && *fn && (*nm == toupper(*fn))) {
-				++nm;
-				++fn;
-			}
-			if (!*nm && !*fn) {
-				return idx;
-			}
-		}
-	}
-	return -1;
-}
-
-int IFaceTable::FindProperty(const char *name) {
-	int lo = 0;
-	int hi = IFaceTable::propertyCount - 1;
-	do {
-		int idx = (lo+hi)/2;
-		int cmp = strcmp(name, properties[idx].name);
-
-		if (cmp > 0) {
-			lo = idx + 1;
-		} else if (cmp < 0) {
-			hi = idx - 1;
-		} else {
-			return idx;
-		}
-	} while (lo <= hi);
-
-	return -1;
-}
-
 int IFaceTable::GetConstantName(int value, char *nameOut, unsigned nameBufferLen) {
 	if (nameOut && nameBufferLen > 0) {
 		*nameOut = '\0';
@@ -2063,6 +1986,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_GETALLLINESVISIBLE",2236},
 	{"SCI_GETANCHOR",2009},
 	{"SCI_GETAUTOMATICFOLD",2664},
+	{"SCI_GETBACKGROUNDLEXING",9012},
 	{"SCI_GETBACKSPACEUNINDENTS",2263},
 	{"SCI_GETBUFFEREDDRAW",2034},
 	{"SCI_GETCARETFORE",2138},
@@ -2074,6 +1998,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_GETCARETSTICKY",2457},
 	{"SCI_GETCARETSTYLE",2513},
 	{"SCI_GETCARETWIDTH",2189},
+	{"SCI_GETCHANGESTAMP",9015},
 	{"SCI_GETCHARACTERPOINTER",2520},
 	{"SCI_GETCHARAT",2007},
 	{"SCI_GETCODEPAGE",2137},
@@ -2084,6 +2009,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_GETDIRECTFUNCTION",2184},
 	{"SCI_GETDIRECTPOINTER",2185},
 	{"SCI_GETDOCPOINTER",2357},
+	{"SCI_GETDOCUMENTOPTIONS",2379},
 	{"SCI_GETEDGECOLOUR",2364},
 	{"SCI_GETEDGECOLUMN",2360},
 	{"SCI_GETEDGEMODE",2362},
@@ -2111,6 +2037,10 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_GETINDICATORCURRENT",2501},
 	{"SCI_GETINDICATORVALUE",2503},
 	{"SCI_GETLAYOUTCACHE",2273},
+	{"SCI_GETLAYOUTCACHEBUDGET",9006},
+	{"SCI_GETLAYOUTCACHEHITS",9008},
+	{"SCI_GETLAYOUTCACHEMEMORY",9007},
+	{"SCI_GETLAYOUTCACHEMISSES",9009},
 	{"SCI_GETLENGTH",2006},
 	{"SCI_GETLEXER",4002},
 	{"SCI_GETLEXERLANGUAGE",4012},
@@ -2141,9 +2071,11 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_GETMULTIPASTE",2615},
 	{"SCI_GETMULTIPLESELECTION",2564},
 	{"SCI_GETOVERTYPE",2187},
+	{"SCI_GETPARALLELLEXING",9014},
 	{"SCI_GETPASTECONVERTENDINGS",2468},
 	{"SCI_GETPHASESDRAW",2673},
 	{"SCI_GETPOSITIONCACHE",2515},
+	{"SCI_GETPOSITIONCACHESTATISTIC",9010},
 	{"SCI_GETPRIMARYSTYLEFROMSTYLE",4028},
 	{"SCI_GETPRINTCOLOURMODE",2149},
 	{"SCI_GETPRINTMAGNIFICATION",2147},
@@ -2193,6 +2125,8 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_GETTEXTLENGTH",2183},
 	{"SCI_GETTWOPHASEDRAW",2283},
 	{"SCI_GETUNDOCOLLECTION",2019},
+	{"SCI_GETUNDOMEMORY",9004},
+	{"SCI_GETUNDOMEMORYLIMIT",9003},
 	{"SCI_GETUSETABS",2125},
 	{"SCI_GETVIEWEOL",2355},
 	{"SCI_GETVIEWWS",2020},
@@ -2252,6 +2186,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_SETADDITIONALSELFORE",2600},
 	{"SCI_SETANCHOR",2026},
 	{"SCI_SETAUTOMATICFOLD",2663},
+	{"SCI_SETBACKGROUNDLEXING",9011},
 	{"SCI_SETBACKSPACEUNINDENTS",2262},
 	{"SCI_SETBUFFEREDDRAW",2035},
 	{"SCI_SETCARETFORE",2069},
@@ -2295,6 +2230,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_SETINDICATORVALUE",2502},
 	{"SCI_SETKEYWORDS",4005},
 	{"SCI_SETLAYOUTCACHE",2272},
+	{"SCI_SETLAYOUTCACHEBUDGET",9005},
 	{"SCI_SETLEXER",4001},
 	{"SCI_SETLEXERLANGUAGE",4006},
 	{"SCI_SETLINEENDTYPESALLOWED",2656},
@@ -2316,6 +2252,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_SETMULTIPASTE",2614},
 	{"SCI_SETMULTIPLESELECTION",2563},
 	{"SCI_SETOVERTYPE",2186},
+	{"SCI_SETPARALLELLEXING",9013},
 	{"SCI_SETPASTECONVERTENDINGS",2467},
 	{"SCI_SETPHASESDRAW",2674},
 	{"SCI_SETPOSITIONCACHE",2514},
@@ -2354,6 +2291,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_SETTECHNOLOGY",2630},
 	{"SCI_SETTWOPHASEDRAW",2284},
 	{"SCI_SETUNDOCOLLECTION",2012},
+	{"SCI_SETUNDOMEMORYLIMIT",9002},
 	{"SCI_SETUSETABS",2124},
 	{"SCI_SETVIEWEOL",2356},
 	{"SCI_SETVIEWWS",2021},
@@ -2604,6 +2542,8 @@ static IFaceConstant ifaceConstants[] = {
 	{"SC_CURSORNORMAL",-1},
 	{"SC_CURSORREVERSEARROW",7},
 	{"SC_CURSORWAIT",4},
+	{"SC_DOCUMENTOPTION_DEFAULT",0},
+	{"SC_DOCUMENTOPTION_TEXT_CHUNKED",0x1000},
 	{"SC_EFF_QUALITY_ANTIALIASED",2},
 	{"SC_EFF_QUALITY_DEFAULT",0},
 	{"SC_EFF_QUALITY_LCD_OPTIMIZED",3},
@@ -2708,6 +2648,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SC_MOD_INSERTCHECK",0x100000},
 	{"SC_MOD_INSERTTEXT",0x1},
 	{"SC_MOD_LEXERSTATE",0x80000},
+	{"SC_MOD_REPLACEALL",static_cast<int>(0x10000000)},
 	{"SC_MULTIAUTOC_EACH",1},
 	{"SC_MULTIAUTOC_ONCE",0},
 	{"SC_MULTILINEUNDOREDO",0x1000},
@@ -2723,6 +2664,10 @@ static IFaceConstant ifaceConstants[] = {
 	{"SC_PHASES_MULTIPLE",2},
 	{"SC_PHASES_ONE",0},
 	{"SC_PHASES_TWO",1},
+	{"SC_POSITIONCACHE_EVICTIONS",2},
+	{"SC_POSITIONCACHE_HITS",0},
+	{"SC_POSITIONCACHE_LONGHITS",3},
+	{"SC_POSITIONCACHE_MISSES",1},
 	{"SC_PRINT_BLACKONWHITE",2},
 	{"SC_PRINT_COLOURONWHITE",3},
 	{"SC_PRINT_COLOURONWHITEDEFAULTBG",4},
@@ -2845,8 +2790,9 @@ static IFaceFunction ifaceFunctions[] = {
 	{"CopyRange", 2419, iface_void, {iface_position, iface_position}},
 	{"CopyText", 2420, iface_void, {iface_length, iface_string}},
 	{"CountCharacters", 2633, iface_int, {iface_int, iface_int}},
-	{"CreateDocument", 2375, iface_int, {iface_void, iface_void}},
-	{"CreateLoader", 2632, iface_int, {iface_int, iface_void}},
+	{"CreateDocument", 2375, iface_int, {iface_void, iface_int}},
+	{"CreateLoader", 2632, iface_int, {iface_int, iface_int}},
+	{"CreateMappedDocument", 9000, iface_int, {iface_int, iface_int}},
 	{"Cut", 2177, iface_void, {iface_void, iface_void}},
 	{"DelLineLeft", 2395, iface_void, {iface_void, iface_void}},
 	{"DelLineRight", 2396, iface_void, {iface_void, iface_void}},
@@ -2991,6 +2937,7 @@ static IFaceFunction ifaceFunctions[] = {
 	{"RegisterRGBAImage", 2627, iface_void, {iface_int, iface_string}},
 	{"ReleaseAllExtendedStyles", 2552, iface_void, {iface_void, iface_void}},
 	{"ReleaseDocument", 2377, iface_void, {iface_void, iface_int}},
+	{"ReplaceAllInTarget", 9001, iface_int, {iface_string, iface_string}},
 	{"ReplaceSel", 2170, iface_void, {iface_void, iface_string}},
 	{"ReplaceTarget", 2194, iface_int, {iface_length, iface_string}},
 	{"ReplaceTargetRE", 2195, iface_int, {iface_length, iface_string}},
@@ -3110,6 +3057,7 @@ static IFaceProperty ifaceProperties[] = {
 	{"AutoCTypeSeparator", 2285, 2286, iface_int, iface_void},
 	{"AutomaticFold", 2664, 2663, iface_int, iface_void},
 	{"BackSpaceUnIndents", 2263, 2262, iface_bool, iface_void},
+	{"BackgroundLexing", 9012, 9011, iface_bool, iface_void},
 	{"BufferedDraw", 2034, 2035, iface_bool, iface_void},
 	{"CallTipBack", 0, 2205, iface_colour, iface_void},
 	{"CallTipFore", 0, 2206, iface_colour, iface_void},
@@ -3126,6 +3074,7 @@ static IFaceProperty ifaceProperties[] = {
 	{"CaretSticky", 2457, 2458, iface_int, iface_void},
 	{"CaretStyle", 2513, 2512, iface_int, iface_void},
 	{"CaretWidth", 2189, 2188, iface_int, iface_void},
+	{"ChangeStamp", 9015, 0, iface_int, iface_void},
 	{"CharAt", 2007, 0, iface_int, iface_position},
 	{"CharacterPointer", 2520, 0, iface_int, iface_void},
 	{"CodePage", 2137, 2037, iface_int, iface_void},
@@ -3137,6 +3086,7 @@ static IFaceProperty ifaceProperties[] = {
 	{"DirectPointer", 2185, 0, iface_int, iface_void},
 	{"DistanceToSecondaryStyles", 4025, 0, iface_int, iface_void},
 	{"DocPointer", 2357, 2358, iface_int, iface_void},
+	{"DocumentOptions", 2379, 0, iface_int, iface_void},
 	{"EOLMode", 2030, 2031, iface_int, iface_void},
 	{"EdgeColour", 2364, 2365, iface_colour, iface_void},
 	{"EdgeColumn", 2360, 2361, iface_int, iface_void},
@@ -3175,6 +3125,10 @@ static IFaceProperty ifaceProperties[] = {
 	{"IndicatorValue", 2503, 2502, iface_int, iface_void},
 	{"KeyWords", 0, 4005, iface_string, iface_int},
 	{"LayoutCache", 2273, 2272, iface_int, iface_void},
+	{"LayoutCacheBudget", 9006, 9005, iface_int, iface_void},
+	{"LayoutCacheHits", 9008, 0, iface_int, iface_void},
+	{"LayoutCacheMemory", 9007, 0, iface_int, iface_void},
+	{"LayoutCacheMisses", 9009, 0, iface_int, iface_void},
 	{"Length", 2006, 0, iface_int, iface_void},
 	{"Lexer", 4002, 4001, iface_int, iface_void},
 	{"LexerLanguage", 4012, 4006, iface_stringresult, iface_void},
@@ -3214,9 +3168,11 @@ static IFaceProperty ifaceProperties[] = {
 	{"MultiPaste", 2615, 2614, iface_int, iface_void},
 	{"MultipleSelection", 2564, 2563, iface_bool, iface_void},
 	{"Overtype", 2187, 2186, iface_bool, iface_void},
+	{"ParallelLexing", 9014, 9013, iface_bool, iface_void},
 	{"PasteConvertEndings", 2468, 2467, iface_bool, iface_void},
 	{"PhasesDraw", 2673, 2674, iface_int, iface_void},
 	{"PositionCache", 2515, 2514, iface_int, iface_void},
+	{"PositionCacheStatistic", 9010, 0, iface_int, iface_int},
 	{"PrimaryStyleFromStyle", 4028, 0, iface_int, iface_int},
 	{"PrintColourMode", 2149, 2148, iface_int, iface_void},
 	{"PrintMagnification", 2147, 2146, iface_int, iface_void},
@@ -3285,6 +3241,8 @@ static IFaceProperty ifaceProperties[] = {
 	{"TextLength", 2183, 0, iface_int, iface_void},
 	{"TwoPhaseDraw", 2283, 2284, iface_bool, iface_void},
 	{"UndoCollection", 2019, 2012, iface_bool, iface_void},
+	{"UndoMemory", 9004, 0, iface_int, iface_void},
+	{"UndoMemoryLimit", 9003, 9002, iface_int, iface_void},
 	{"UseTabs", 2125, 2124, iface_bool, iface_void},
 	{"VScrollBar", 2281, 2280, iface_bool, iface_void},
 	{"ViewEOL", 2355, 2356, iface_bool, iface_void},
@@ -3302,10 +3260,475 @@ static IFaceProperty ifaceProperties[] = {
 	{"Zoom", 2374, 2373, iface_int, iface_void}
 };
 
+
+static const int ifaceConstantDisplacements[] = {
+	0,-2665,1,0,-2659,0,-2658,-2657,2,0,2,0,-2654,-2653,0,-2646,
+	1,-2645,0,-2641,0,-2640,0,0,-2636,0,2,-2635,-2632,-2631,0,-2630,
+	-2628,-2626,2,0,-2623,0,-2622,-2621,2,1,1,2,1,0,0,-2615,
+	-2614,-2612,-2609,0,-2608,-2606,0,0,-2604,2,-2603,0,0,-2602,-2601,2,
+	0,0,-2598,-2594,0,-2592,-2591,-2588,5,-2583,2,-2578,-2577,4,0,-2567,
+	1,0,-2565,0,0,-2564,3,-2561,2,0,1,0,-2558,1,0,-2555,
+	-2550,-2549,0,-2548,-2547,-2543,-2535,3,0,1,0,-2533,-2532,0,0,0,
+	-2531,1,0,2,-2527,0,-2523,2,-2518,-2515,-2510,0,1,-2505,2,0,
+	2,1,0,2,1,-2495,0,0,5,-2492,1,-2490,0,2,1,-2481,
+	0,0,3,4,-2479,-2478,0,-2474,0,0,-2470,-2468,0,-2466,-2464,1,
+	1,1,-2462,1,0,0,0,-2461,-2460,2,5,2,-2450,-2449,0,0,
+	0,0,0,-2447,-2445,0,0,0,0,-2436,0,0,-2435,1,0,-2433,
+	0,-2432,-2431,-2429,0,1,1,2,-2428,-2423,1,-2421,-2420,0,0,-2419,
+	0,1,-2418,0,-2415,0,-2413,0,-2410,-2407,-2406,2,-2403,0,4,-2400,
+	-2399,0,1,0,1,0,-2395,-2394,2,0,-2392,0,-2389,-2387,-2386,1,
+	0,-2385,1,2,1,0,0,2,-2384,1,0,0,0,-2383,1,0,
+	0,1,2,0,-2380,0,1,2,-2377,5,1,1,-2371,1,0,0,
+	-2370,1,4,-2368,-2365,0,1,-2364,0,0,-2358,0,0,1,-2356,1,
+	1,-2355,2,0,0,1,-2353,1,0,1,-2352,0,0,-2348,-2345,4,
+	1,2,0,0,0,1,-2342,3,1,0,1,-2341,-2339,0,0,-2338,
+	0,-2337,-2329,0,0,0,0,-2327,0,-2326,-2324,1,1,-2320,3,0,
+	1,-2312,1,-2307,4,0,-2298,-2297,0,0,-2296,-2291,0,-2290,0,2,
+	0,0,0,0,1,-2289,0,2,0,1,0,0,-2288,1,1,0,
+	0,0,0,1,-2285,1,2,2,0,2,1,1,0,-2278,-2273,0,
+	0,0,-2272,0,-2271,0,0,0,-2268,2,1,-2259,0,1,3,2,
+	0,-2258,2,-2257,0,0,0,0,-2255,1,1,-2251,-2240,0,1,-2236,
+	-2235,-2231,-2229,-2225,0,0,0,-2218,0,-2215,1,2,2,-2210,-2209,1,
+	1,0,-2208,1,0,0,-2203,-2196,-2190,7,0,2,-2189,0,1,0,
+	0,0,2,1,-2188,0,-2185,0,-2182,0,0,3,-2180,-2179,0,-2176,
+	-2174,0,-2171,1,-2170,1,0,-2168,0,0,-2165,-2162,-2160,-2159,-2157,0,
+	3,-2153,1,-2151,-2148,3,-2146,-2139,0,1,-2138,-2135,0,0,-2134,-2131,
+	-2130,1,-2129,-2123,-2119,-2118,-2117,-2116,-2112,4,-2110,0,-2108,3,2,2,
+	0,1,1,8,0,3,2,0,0,0,0,0,0,1,4,2,
+	0,-2106,1,0,-2101,-2100,6,-2098,1,-2094,3,-2090,-2089,0,0,0,
+	-2085,-2080,3,-2077,0,-2075,2,0,-2070,0,-2069,2,0,0,0,0,
+	0,0,0,0,0,0,-2066,0,1,0,0,0,0,1,1,4,
+	0,-2064,1,-2060,-2054,-2053,-2052,2,-2048,0,-2047,0,0,1,1,1,
+	1,-2046,0,1,0,-2043,2,1,2,2,0,0,2,2,0,0,
+	-2041,-2036,-2034,-2033,-2029,2,-2028,0,0,1,0,4,0,-2022,-2017,0,
+	1,0,0,0,0,-2014,0,2,-2013,2,-2009,-2004,1,0,1,-2003,
+	3,5,0,0,-2000,0,2,0,-1999,-1997,-1995,0,0,0,-1988,-1984,
+	1,-1982,0,0,-1981,-1978,0,-1975,-1974,0,0,-1972,5,-1970,0,-1968,
+	0,4,0,0,-1964,5,-1956,0,0,-1955,-1954,-1953,0,0,7,-1951,
+	2,-1949,-1944,0,2,-1943,1,1,5,-1940,-1938,0,0,-1937,0,0,
+	-1933,0,0,0,-1931,0,1,0,6,0,0,1,-1928,0,-1927,-1924,
+	2,0,-1923,1,-1912,1,0,1,0,0,-1911,-1910,2,0,3,-1909,
+	0,0,2,1,1,-1908,-1907,-1906,-1901,1,0,-1894,1,0,0,-1893,
+	-1892,-1890,0,-1889,-1887,1,0,-1886,0,0,0,-1883,1,5,0,6,
+	0,0,1,3,0,-1881,1,3,2,-1880,-1878,6,2,0,0,-1876,
+	-1875,0,-1872,1,-1865,-1863,0,0,-1862,0,0,2,0,-1861,0,-1857,
+	-1854,-1853,-1848,1,1,0,-1847,0,0,0,0,2,0,-1846,0,1,
+	-1844,1,0,0,1,-1842,1,3,-1839,3,4,-1834,1,-1833,0,-1829,
+	-1826,-1818,-1816,2,0,-1814,0,-1813,-1806,-1804,8,0,-1801,0,0,-1798,
+	0,0,-1796,-1793,3,1,-1785,-1783,-1782,-1781,-1780,-1776,1,6,1,0,
+	0,-1775,0,1,-1770,1,0,0,0,-1768,-1767,5,2,0,1,-1763,
+	2,1,2,0,1,0,1,0,-1760,-1758,-1755,-1753,0,4,-1752,-1751,
+	-1749,-1748,-1746,-1738,-1734,-1733,-1731,0,-1730,-1724,-1723,0,1,-1714,0,-1709,
+	-1705,-1704,4,1,0,1,-1698,-1686,0,-1685,0,0,0,0,-1681,2,
+	1,-1680,0,3,0,-1679,-1678,-1676,1,0,1,0,-1675,0,0,-1674,
+	0,-1672,-1671,-1670,0,-1669,1,0,0,1,1,-1667,-1666,1,0,0,
+	0,0,0,-1663,1,-1662,-1661,2,6,0,0,-1658,0,0,0,0,
+	0,-1656,-1652,2,-1651,-1648,0,0,0,1,2,-1647,0,1,-1645,-1644,
+	-1642,-1639,0,-1638,1,4,-1636,-1634,-1626,1,-1624,1,0,-1623,2,0,
+	-1621,8,-1619,7,3,-1617,0,0,0,-1613,2,0,0,-1612,-1610,1,
+	1,0,0,-1609,-1605,-1604,6,0,-1601,0,1,-1598,-1595,0,0,0,
+	1,0,0,-1594,0,3,-1588,5,2,1,1,1,1,-1582,1,1,
+	0,0,0,0,2,1,0,1,0,-1579,0,2,-1576,7,-1574,-1564,
+	-1557,-1556,0,-1555,0,0,5,-1553,0,0,0,-1552,0,-1549,3,-1547,
+	-1543,4,0,-1542,0,-1539,-1535,0,0,1,0,0,0,0,-1530,-1528,
+	1,0,-1527,2,3,2,-1525,1,1,0,-1522,-1517,-1516,0,0,0,
+	4,4,-1514,4,-1511,-1510,0,-1507,0,-1506,0,0,-1503,1,1,2,
+	1,0,0,-1498,-1494,-1491,-1489,-1482,0,0,0,0,5,-1476,-1475,-1472,
+	4,0,0,-1470,-1464,-1463,0,0,-1462,2,-1460,-1458,2,-1456,0,-1455,
+	-1454,10,0,-1452,-1449,-1447,0,0,-1446,0,0,0,-1439,-1437,0,-1434,
+	-1431,-1429,0,-1427,0,0,0,-1426,-1422,0,0,-1418,-1417,-1415,-1414,-1413,
+	-1409,-1408,-1406,0,-1405,-1403,1,-1402,5,-1398,2,-1396,1,3,-1391,-1390,
+	0,-1389,-1382,-1381,-1379,2,3,0,-1376,0,0,-1374,-1370,10,-1365,-1364,
+	4,0,-1362,0,6,0,0,0,0,0,-1361,-1359,0,-1354,1,11,
+	4,2,-1353,-1352,-1349,0,-1343,1,0,2,-1341,0,4,-1340,0,-1339,
+	2,1,3,4,1,-1337,-1327,1,0,-1325,0,2,-1321,2,-1320,3,
+	-1315,1,0,-1314,-1313,-1310,1,0,-1303,0,-1302,3,0,0,-1296,-1294,
+	4,-1292,-1289,-1286,-1285,-1282,-1277,3,-1274,-1272,-1270,4,4,1,0,-1269,
+	1,-1268,-1262,0,0,5,-1261,-1259,0,-1258,0,-1257,-1256,0,0,-1254,
+	-1252,0,1,0,4,0,-1249,-1241,2,-1235,5,-1233,0,0,-1232,2,
+	8,2,-1230,0,0,1,1,0,0,-1220,-1219,4,0,3,-1218,0,
+	0,1,-1217,1,0,0,0,0,1,0,-1216,0,0,0,0,-1213,
+	2,-1207,0,1,0,0,-1201,-1198,2,-1194,-1193,4,0,0,0,1,
+	-1190,0,4,-1189,-1187,1,6,0,-1185,1,-1184,0,0,-1182,3,-1181,
+	0,-1179,-1176,0,-1174,2,0,-1173,4,-1171,-1168,0,3,-1162,-1157,-1155,
+	-1152,-1141,-1140,0,2,3,-1136,1,1,1,0,-1133,-1132,0,1,-1131,
+	-1129,2,0,1,0,0,-1126,0,0,-1125,1,-1124,-1122,-1121,-1114,0,
+	0,1,5,-1113,-1111,-1110,1,3,-1109,2,0,1,-1107,1,-1106,0,
+	-1105,2,0,2,-1104,4,-1101,0,0,-1098,8,0,2,2,0,0,
+	-1097,4,-1093,-1092,-1089,1,1,-1086,-1084,-1079,-1076,-1075,-1072,1,0,0,
+	-1071,0,1,-1069,0,2,0,0,0,-1065,0,0,0,11,2,7,
+	0,-1063,0,0,-1061,2,-1060,0,1,-1058,-1057,2,-1055,-1052,-1050,2,
+	0,0,7,0,-1048,2,0,2,-1046,1,4,0,0,-1045,-1044,-1042,
+	-1041,0,-1039,0,1,0,-1037,0,0,9,0,0,0,0,0,2,
+	0,-1035,3,0,-1022,5,-1021,0,0,3,-1017,3,0,0,-1016,2,
+	1,-1014,2,0,0,0,-1013,1,-1012,-1011,0,2,-1008,0,10,2,
+	-1005,-1004,-999,0,-994,0,0,9,4,0,-992,0,6,1,-991,0,
+	5,-990,4,8,3,-989,1,-988,0,-977,0,0,-975,0,2,-974,
+	1,-967,0,0,0,0,0,4,0,0,-963,2,4,2,0,-962,
+	-959,1,0,1,2,4,0,-956,21,-954,-953,1,-949,-947,1,-945,
+	-941,0,0,-940,4,0,0,-939,3,-937,-935,2,-927,-926,-924,8,
+	0,-922,2,0,0,1,0,15,0,0,1,1,7,-919,-917,0,
+	-913,0,-912,0,4,1,0,0,1,0,7,0,-908,0,-904,4,
+	-898,-896,0,3,0,0,11,0,-895,0,0,1,-894,-892,0,2,
+	2,0,0,-891,-890,2,1,0,-888,1,0,2,-887,-885,-882,0,
+	2,-880,-878,-870,0,2,-865,-862,-861,1,-860,-859,-855,-854,3,0,
+	1,1,-851,0,0,4,0,0,-846,-845,-844,-842,-838,0,0,3,
+	4,-836,-834,2,5,2,-832,-830,-827,-826,-821,5,-820,1,-816,-812,
+	4,1,0,1,3,-810,0,-806,2,0,-803,0,-802,9,0,-801,
+	6,1,0,0,5,4,-799,-798,0,-796,0,-795,-791,3,-790,6,
+	-786,0,0,0,0,0,-785,9,0,-784,-783,1,-781,-779,5,0,
+	-776,1,5,-773,-771,-769,0,0,0,0,0,-767,3,-757,-756,-754,
+	-751,0,0,-748,0,-743,-741,0,5,0,5,-739,6,1,1,-738,
+	0,0,-736,2,-735,2,1,-733,-732,6,0,-731,2,-724,0,0,
+	0,3,-720,0,0,4,0,2,0,0,-719,0,-715,-714,0,0,
+	0,-713,-711,0,-708,-705,0,0,-696,-695,-693,2,0,-691,0,-686,
+	-683,-682,0,-680,0,-679,0,-677,-676,-674,0,0,-673,0,0,0,
+	-671,-669,0,0,4,-668,0,-665,0,2,0,6,5,-664,2,0,
+	-663,0,0,-662,0,0,6,0,-658,-657,0,0,-656,0,1,-650,
+	0,1,0,-648,-646,0,0,-645,2,-638,4,0,-637,0,-635,0,
+	-633,-629,0,0,-628,0,4,-626,3,0,4,-624,0,-622,0,0,
+	0,0,16,4,-620,0,2,0,0,2,0,5,0,-618,-615,0,
+	-612,0,-611,1,-610,0,-605,8,0,6,3,0,-601,0,0,-595,
+	0,0,0,-593,0,-590,-584,0,0,7,-583,-580,-575,1,2,0,
+	-571,0,-569,0,0,0,10,0,0,0,6,-567,0,-566,0,1,
+	0,3,-561,4,9,4,0,-560,0,0,0,0,0,12,0,0,
+	-552,-550,1,5,2,2,2,-549,0,11,0,1,0,0,4,-548,
+	10,0,0,-547,0,0,1,0,0,0,-544,-542,0,0,1,2,
+	-541,0,0,-539,-538,-531,-530,0,-528,0,1,0,0,0,0,-525,
+	2,-522,-519,0,-517,0,3,-514,0,-511,0,-510,-509,0,0,0,
+	0,-503,0,-501,0,0,-499,0,0,1,-496,2,-495,0,0,4,
+	0,-494,0,-492,-491,0,-490,0,-488,-487,-486,-483,-482,-481,3,-478,
+	1,0,0,0,1,1,-477,0,12,-476,3,-475,1,0,6,1,
+	-469,0,3,-467,-463,2,-462,-461,2,0,-458,2,-454,0,-452,0,
+	0,-451,3,0,0,1,-449,6,-448,-447,-446,5,-440,-439,6,1,
+	1,7,-435,-433,0,-432,-430,1,7,-428,2,0,0,4,0,0,
+	0,0,0,0,1,-426,0,-425,-423,0,0,17,-418,0,0,0,
+	4,-415,5,0,-414,0,0,8,-413,2,-403,0,-398,7,0,0,
+	-396,0,-394,0,7,0,0,0,-393,-392,-391,3,0,-388,0,0,
+	0,-385,-384,-372,-371,0,0,-370,-368,12,-366,-364,1,-360,0,1,
+	0,-358,0,0,0,10,-357,-354,-353,1,0,5,-347,0,-340,3,
+	-329,1,1,2,-328,2,1,0,0,-327,0,1,0,2,3,0,
+	-326,0,10,-324,-321,0,0,2,0,-313,0,4,0,-311,0,-310,
+	-305,0,-303,0,-298,0,1,-295,-294,2,0,0,-291,1,-290,0,
+	7,-287,0,0,0,0,0,0,0,-284,0,0,0,2,-281,-278,
+	0,0,0,-276,0,-267,2,0,0,0,-266,0,-265,-264,13,11,
+	0,-258,0,0,0,-256,0,3,0,1,0,4,-255,-251,0,0,
+	0,1,-246,-245,0,-244,2,0,-243,-240,1,10,-236,1,0,5,
+	1,0,1,-233,3,-231,-230,1,0,-228,0,-220,0,0,0,-219,
+	-218,0,-214,0,-211,0,1,0,-205,-204,0,1,8,1,5,0,
+	0,-203,-202,-200,1,-196,1,10,0,0,-193,1,0,0,0,0,
+	-190,0,-187,-186,4,1,13,-182,-181,0,-173,0,0,3,0,-172,
+	-171,0,4,-169,0,-167,0,3,0,2,0,-160,-159,-158,14,0,
+	-155,-152,5,0,-151,0,0,7,6,-148,-147,2,1,0,0,0,
+	-140,1,36,3,0,6,-138,0,4,-126,-125,0,-122,0,0,-118,
+	0,6,0,0,18,-117,-113,0,0,-112,-109,5,0,4,0,8,
+	0,-107,9,5,-106,-102,0,1,0,0,-99,-96,0,-90,0,0,
+	0,2,-89,0,0,-80,-76,0,-73,0,-72,0,20,0,1,-69,
+	1,-64,4,-63,0,0,0,0,2,6,-62,-54,1,-50,3,-49,
+	-48,0,0,0,0,10,1,-47,0,0,3,0,0,-46,0,-43,
+	0,-42,-41,-40,4,8,0,0,0,0,0,3,-35,-32,0,1,
+	-31,0,-30,0,0,-23,0,-22,0,18,0,-21,-19,-14,-11,-10,
+	8,0,0,0,3,-4,0,0,-1,6
+};
+
+static const int ifaceConstantSlots[] = {
+	2144,1656,2322,641,1948,1958,2014,270,1505,898,634,911,16,1491,1184,2535,
+	604,1113,49,691,1100,2397,1508,771,1842,1074,2135,895,2580,1139,2606,1708,
+	43,271,549,9,851,1272,2121,2555,296,722,401,1680,2370,2501,2621,654,
+	1009,2047,454,547,272,1280,1179,1306,1513,2015,226,1537,297,1703,419,1116,
+	179,379,532,1727,1852,705,2097,1742,56,371,682,79,2331,2168,601,711,
+	2532,144,337,1938,2567,2307,2259,1592,2411,12,1371,2027,871,81,2094,613,
+	37,2359,83,2568,1878,2251,2619,1055,2511,920,64,1721,1159,2146,492,2401,
+	785,2194,779,1285,2481,2138,382,1466,534,1056,784,2350,410,23,335,1596,
+	2550,1767,457,1180,8,1998,739,302,1214,865,361,188,546,2125,2544,2104,
+	574,1692,365,1866,2569,2217,2406,1696,2447,1311,1460,2574,1638,1232,2067,1339,
+	2661,1424,1124,334,2265,1279,1391,730,1335,2327,1069,1469,1786,1023,940,11,
+	985,1603,1619,1972,1626,714,1070,2222,496,267,1182,566,490,1310,848,114,
+	1764,1517,1395,1421,435,103,1090,2605,2454,2280,1040,1075,1228,804,959,692,
+	1900,406,1457,1904,78,1934,600,2407,1084,1156,543,2317,736,2334,1524,1570,
+	747,286,934,1206,875,847,2521,494,1765,1198,855,623,1412,1681,277,1320,
+	1851,2078,1968,924,820,484,1527,1985,1361,1510,2545,2355,324,67,2464,1042,
+	60,1465,1956,2577,1732,1518,1660,856,1073,1503,2192,1804,1041,2004,97,1945,
+	2305,110,1564,1960,118,2075,799,19,1150,2140,684,36,2538,192,981,2445,
+	1939,1019,515,1806,2536,1396,563,1687,2468,830,1064,1212,245,507,2022,2324,
+	191,2163,1870,1825,2363,648,2246,293,538,1611,1413,2298,411,1906,874,17,
+	1118,647,1707,2034,299,342,1193,2202,253,1168,488,908,2466,1675,2652,125,
+	1160,757,1843,710,643,1109,510,2394,756,1922,2316,0,27,98,1777,806,
+	1873,1697,1717,238,102,2344,917,1217,1881,668,493,1502,2387,883,1834,2657,
+	729,922,1174,2030,1426,1734,46,2594,698,1778,2337,1588,2264,59,1477,2664,
+	1855,2410,2625,2079,2031,1005,2496,925,1771,1545,1336,991,735,459,380,2431,
+	1899,2063,2279,2275,2422,290,1067,524,1658,451,1276,1225,252,1153,575,1138,
+	237,32,2357,1635,2282,2443,1145,2499,2093,1577,1844,614,1163,431,284,2060,
+	1154,2647,527,255,2120,1165,1409,891,1529,171,1864,2139,1143,429,213,1896,
+	1014,661,498,1689,276,812,439,589,781,914,1643,2263,1039,1772,823,1164,
+	1048,2338,2170,248,2528,586,35,639,216,2108,1422,715,10,383,2306,408,
+	471,1420,1083,455,2497,2309,793,523,1704,868,2058,2556,505,158,596,1251,
+	2082,1359,2016,1006,2045,689,1954,1984,352,1318,2044,970,475,2107,145,1431,
+	630,2507,1263,1496,2458,1131,1629,227,301,1045,2656,2147,954,2539,2,1262,
+	2213,2201,2659,1540,1313,788,1756,1094,1188,2248,2601,1022,2247,1980,292,2126,
+	1724,2127,1008,1651,2312,1317,978,2320,1872,1347,2515,1677,968,675,1991,906,
+	1148,205,1849,740,2277,1487,2429,466,221,1836,2382,1372,829,1382,1474,996,
+	2573,1497,1152,636,2527,1792,1625,2416,1879,1343,1504,592,2642,1461,1803,2512,
+	606,2129,1319,2475,1161,2644,1647,764,187,29,1631,755,2297,70,234,21,
+	2329,1390,649,2272,1926,888,1871,1838,1740,2630,2596,1404,1241,2188,1334,184,
+	1230,2436,1941,1557,1432,458,2470,602,1467,2485,1169,104,1633,2441,1663,2364,
+	2122,1401,1801,2185,1229,256,1688,241,1462,2395,354,240,1414,2313,2308,463,
+	443,2612,700,787,1256,269,42,916,2302,1367,2025,2440,556,1902,1087,456,
+	1195,465,1213,1610,1366,2068,816,1965,130,1293,1218,577,2124,1252,2141,2617,
+	2651,1875,2021,2462,1506,306,992,766,1865,2409,133,1031,1425,2159,622,437,
+	1028,1585,778,2417,1360,2325,2178,2150,1936,2137,1091,794,857,1617,1544,1623,
+	1996,1033,854,631,1097,1531,2448,943,841,571,1949,1931,364,123,2457,1450,
+	1480,1316,1648,1810,628,1733,41,2560,1257,1759,1511,2164,138,518,1300,328,
+	1445,1408,1754,2402,2230,1812,2335,1032,2633,1668,807,165,763,1746,2074,1632,
+	397,2233,2484,1950,1378,1044,884,2160,1516,834,2010,786,332,1081,2117,737,
+	1043,1330,131,1827,1809,2467,1929,2341,395,1052,1650,500,2646,2663,2142,822,
+	935,323,1868,1444,880,436,1969,2256,1495,4,174,958,1628,696,2553,1350,
+	2582,1128,375,719,1670,670,810,2353,1714,2415,308,2262,1260,1807,580,137,
+	658,326,1327,516,369,603,407,1183,989,1303,961,712,1691,2607,674,1975,
+	2405,2352,1898,2340,3,2343,31,1536,1509,1063,1845,2102,745,687,1483,2052,
+	1429,2241,2391,2598,1890,1111,1448,2540,1684,1243,611,2356,2176,1621,2384,2319,
+	262,1211,50,561,1579,2648,148,211,929,88,392,2050,433,1221,1739,2490,
+	170,341,2392,937,723,1326,2193,2342,520,1920,2268,1201,1894,768,1725,1149,
+	567,1671,298,1302,1199,1459,987,2542,2524,132,2614,1914,1034,872,1357,1002,
+	1655,666,1110,1092,1988,1476,772,2042,260,1137,632,2383,124,1816,2388,531,
+	1035,2281,2191,474,175,1226,2420,1796,73,1265,716,1935,2531,2408,826,1808,
+	2186,1567,1618,521,1185,1054,594,713,2525,618,1015,1811,2586,1072,708,1305,
+	2036,438,1549,1490,2638,1151,2323,2267,152,2351,1501,1559,1249,1627,727,995,
+	1013,288,2442,734,803,2498,1833,1634,305,1315,1250,1166,1025,1344,1451,1683,
+	1857,2426,1479,582,2478,282,659,809,559,1297,1745,1591,1599,1135,553,1215,
+	372,2385,2156,1453,422,997,317,2349,1583,1,1543,2090,2236,2161,2242,2446,
+	1368,2358,207,142,1181,2386,2333,1886,2273,1269,1388,1402,2177,802,52,1254,
+	402,1348,1711,718,683,1609,2249,487,839,915,717,1715,919,1963,1645,1800,
+	726,1863,1999,1443,693,1146,75,189,2181,1736,412,473,1141,327,695,1854,
+	656,2450,1264,2198,386,2534,119,797,1615,2530,1916,2001,173,2059,1351,699,
+	671,1826,1380,1553,2639,936,1093,2412,294,775,545,275,876,2486,885,953,
+	1383,1905,1817,1284,2315,2371,526,181,1325,2500,220,1946,2347,2232,1572,1492,
+	2113,2474,1216,146,2205,2054,1323,1597,562,106,1829,2296,949,1369,873,2636,
+	68,424,249,508,1394,1526,182,899,1324,199,167,242,150,939,976,2438,
+	862,877,1016,1253,1846,754,1236,1407,1720,869,2152,396,1430,2000,1551,1616,
+	178,48,2615,446,964,85,956,1209,1957,653,1917,355,76,605,1637,2076,
+	588,694,519,2495,177,2529,1661,1468,2623,1133,2252,645,1758,348,1001,542,
+	910,1769,2439,1690,522,1464,44,733,2105,346,957,1970,2618,2505,2503,1086,
+	285,853,1227,1747,1805,686,1268,1288,1484,61,2650,2103,1405,2112,1534,2269,
+	66,551,2061,1636,2114,1085,264,1142,400,2523,1095,1196,2149,599,1761,1639,
+	607,2516,281,1910,620,1942,2283,1170,625,1695,1030,367,2520,1565,2461,2488,
+	2301,477,1847,1494,1410,732,2053,2011,47,690,2253,1375,1569,2155,1979,384,
+	1586,1522,1103,200,932,900,849,984,2465,1528,811,942,126,1271,2171,2593,
+	432,1888,1578,570,1682,92,1247,657,2377,2494,890,2136,2179,2610,2208,752,
+	938,1458,472,2453,550,5,2455,312,921,886,1397,1814,120,2219,1776,1955,
+	2444,931,1321,1187,1381,2506,2423,127,608,541,948,1789,2070,1478,1893,1672,
+	1519,1078,1799,485,2399,499,1473,1642,195,183,2089,1840,1027,1546,1983,101,
+	2210,236,821,1824,1107,2111,172,1533,1755,426,1828,1659,1613,828,1757,1698,
+	197,887,1239,1358,555,398,2166,1259,1869,897,1353,2118,1122,2234,2613,963,
+	482,304,470,1301,464,1017,1982,45,1912,1136,2570,514,1554,2100,2214,1612,
+	2221,540,1049,2287,82,468,1880,423,1389,2366,2071,1584,1791,2558,112,2019,
+	831,1121,1760,1832,2365,2131,1065,1802,2033,627,2504,2115,2020,1877,517,2101,
+	449,185,2449,704,1119,1475,506,155,688,404,844,2660,2372,1162,971,1748,
+	1538,1434,141,1667,347,2393,905,168,2491,1258,676,1277,1907,1210,2203,525,
+	1558,360,2189,1127,2006,1197,767,2123,1953,300,136,376,1548,544,1057,2224,
+	818,1428,2223,257,2245,503,1595,231,63,1624,1386,359,1488,2183,462,2428,
+	1580,2360,2336,209,1472,738,912,1752,418,2563,662,2508,1219,1614,748,667,
+	2628,1192,1514,867,1598,77,87,2548,2187,2172,2427,1392,1790,1178,2592,1555,
+	2007,842,1082,394,405,1556,635,84,945,1930,2080,495,74,983,1763,2400,
+	1593,1937,765,2029,1173,2634,1377,2537,135,2057,640,331,378,2554,749,1693,
+	2518,2299,633,1770,2286,1004,319,2290,1337,442,1374,980,2143,2284,909,1328,
+	1818,2603,1007,2043,2009,1207,1665,353,859,548,362,988,1415,90,2173,535,
+	993,1986,2561,190,642,1384,186,2572,233,1515,1575,1437,2549,595,445,1274,
+	1915,1587,2295,2602,2218,780,344,1921,1600,40,709,1853,486,2653,1322,2028,
+	1839,230,846,2215,986,2243,239,1101,2145,349,1220,598,210,417,617,1333,
+	1706,845,1978,289,2404,2133,1861,1874,479,2240,2608,2239,1244,2128,351,1267,
+	366,1438,2064,1061,274,391,2543,54,903,2026,646,2182,528,629,2589,1482,
+	1235,2212,198,2414,2196,2318,1270,1542,1059,1071,965,2073,1024,415,1678,1129,
+	644,2584,1036,783,1068,2557,762,1657,2158,902,1096,121,1352,1246,2040,425,
+	2032,652,1332,381,907,1385,258,2374,2473,414,1768,314,1582,2291,1589,214,
+	1204,1066,2314,497,450,1735,389,878,2002,2041,1604,1620,1012,1743,782,2190,
+	447,511,2013,1304,2339,111,660,2292,1738,2346,2003,1652,896,441,1862,2228,
+	1923,926,95,203,1255,770,356,26,1447,1298,2289,619,1295,1889,2266,224,
+	637,1356,2065,776,1106,1342,2571,320,223,2110,967,858,998,1233,863,2084,
+	560,2046,2616,39,218,235,615,2541,2276,1550,1679,2096,154,1841,222,1932,
+	860,1307,196,1266,1823,2479,201,2421,2566,2354,316,1112,1046,1856,2285,338,
+	1933,340,1630,71,1029,2640,1530,96,1781,1924,669,2091,1573,20,1454,2575,
+	1481,1147,2260,2493,2148,1995,34,728,707,2039,1190,1132,1088,169,1441,1788,
+	1966,2588,2087,1171,1172,2609,483,2294,1654,2328,743,1400,129,345,153,610,
+	1674,1077,2244,2235,590,861,1140,2368,1925,1500,2130,2088,800,2109,994,2626,
+	1289,977,2257,467,1525,790,795,315,2587,701,1223,330,2035,1079,585,955,
+	2658,1737,452,1449,1423,2627,769,2489,2216,2509,777,250,2424,1718,194,283,
+	1354,2274,2238,638,1099,1436,529,557,2261,33,720,2225,2023,251,2451,219,
+	2562,1951,1062,176,1775,2526,1798,819,1308,2237,1340,1952,1700,1292,1646,259,
+	651,2250,1685,2066,1793,731,409,1903,166,1561,440,89,278,2169,1155,1782,
+	2367,944,1967,1234,2288,2258,1498,808,1521,758,1512,1345,2153,38,116,663,
+	1291,2434,1541,358,833,1419,1446,2220,1940,370,1795,2637,2492,2477,2578,837,
+	1753,1329,972,2209,1705,2622,1026,204,583,339,679,1911,1398,57,390,513,
+	2048,1644,1959,870,761,1673,2430,2134,1108,1486,2459,1362,1399,2184,2437,1439,
+	2049,2565,469,2546,923,1411,2379,1699,678,1773,1787,805,2207,558,15,852,
+	1694,612,1331,1974,1971,616,2012,1205,1098,509,950,147,1535,2332,1993,1010,
+	1590,2624,650,969,946,1123,1702,1240,597,7,1987,1299,1499,2167,229,1686,
+	979,1676,1867,24,246,65,1837,1433,1393,2522,587,2083,1794,6,2229,626,
+	591,1884,160,80,2369,208,1290,621,107,336,725,444,159,552,1751,1730,
+	1606,2471,2132,2165,1114,569,814,1365,2585,2116,428,1783,1669,1850,1728,1859,
+	554,1471,1520,817,789,1177,2081,149,1200,2092,951,2487,1822,2403,677,1713,
+	1576,2310,703,2600,318,1977,1981,536,2513,1992,2381,265,665,2551,1973,333,
+	2069,18,2476,1203,329,139,387,1779,1248,1144,1455,1883,2227,792,180,1286,
+	2038,2085,1281,2432,1202,279,1913,2576,568,1440,990,476,151,2321,927,2460,
+	1273,576,2375,672,741,947,100,593,893,655,879,325,1897,1080,1532,157,
+	1547,1944,2514,453,1053,539,2482,2271,609,1050,1666,122,975,86,1231,1275,
+	724,393,108,702,1089,1349,14,1282,478,287,825,1858,481,962,1355,13,
+	1994,2452,2564,584,374,228,51,1819,572,2380,2611,680,2300,1309,162,1463,
+	2095,2390,1860,217,1997,1566,1785,1562,2631,461,206,581,801,1418,117,1403,
+	813,892,1892,2469,1456,1820,866,1774,1287,1238,1701,2199,918,413,774,1716,
+	759,1653,247,266,930,1750,1489,1962,1710,1601,1964,2162,2231,1876,798,1927,
+	2018,835,1102,685,1051,1427,1105,22,460,1662,1726,2480,480,1831,1749,2154,
+	1961,72,850,2278,2591,291,2559,1605,164,2599,1766,512,268,2502,2056,156,
+	1370,697,1021,350,1363,742,881,1602,1976,2629,2051,1649,2398,2433,2597,904,
+	2180,1076,2583,750,894,1909,2197,2425,416,882,161,1208,2211,93,434,321,
+	2620,322,2024,244,232,2519,1712,2655,1928,501,1000,1891,2552,91,1608,212,
+	25,530,1641,2206,1885,1485,1261,1523,1709,1435,1011,901,143,1581,263,2008,
+	1552,1047,1493,69,681,664,1989,827,2311,1120,2413,533,2330,2378,1037,1607,
+	363,1379,1723,2373,2376,2665,491,753,565,2086,310,489,1560,1731,1296,1729,
+	2254,1780,2304,1104,2595,1125,1848,399,2106,2418,2579,1887,2649,1237,94,836,
+	1784,1020,2157,1470,843,357,109,537,2662,115,30,2072,941,243,2419,307,
+	1222,261,973,832,2175,1539,974,504,960,2483,624,1312,1640,2226,933,2200,
+	1416,1664,838,1563,2604,1813,313,2635,1947,1452,303,751,105,2204,2345,1895,
+	2362,2641,280,1835,53,760,1918,578,225,448,388,373,952,1406,1719,744,
+	2255,1058,1191,99,2293,2055,193,1571,202,1242,2099,1882,706,1990,1003,385,
+	796,2463,311,2547,421,1338,1117,2632,134,1943,403,1762,824,2303,1417,2005,
+	928,1364,28,377,1901,1167,673,128,773,2098,1821,2077,1442,502,815,1507,
+	1245,2151,2435,1018,2361,1134,2195,420,295,999,2590,2389,2643,721,2270,1797,
+	140,1294,1346,1194,2645,2326,2037,1373,1722,368,2472,864,55,1314,343,2017,
+	1115,2533,564,1574,2396,1568,1038,573,840,1186,2062,254,966,1744,579,2174,
+	1278,1157,2581,215,1376,913,1283,1176,791,2510,1224,1130,1622,2654,1815,1060,
+	1175,1387,2348,2119,982,1341,309,746,62,1908,1830,889,58,2517,2456,1919,
+	273,427,1189,430,163,113,1126,1158,1741,1594
+};
+
+static const int ifaceFunctionDisplacements[] = {
+	2,1,2,0,0,0,0,0,1,-293,1,-292,0,0,0,0,
+	-291,0,0,1,0,-286,1,0,-285,0,-284,0,0,0,0,-283,
+	-279,0,-275,2,-270,2,0,-269,2,2,1,0,1,3,-264,-259,
+	0,0,0,1,-257,0,0,-256,-255,-254,0,0,-253,2,0,1,
+	1,0,0,4,-250,-238,2,1,-235,0,-232,-230,0,1,0,1,
+	1,0,0,6,-226,-225,0,4,-222,0,-220,-216,-210,1,1,6,
+	-209,1,0,0,0,-205,-203,0,1,0,0,0,3,1,-202,0,
+	-201,-200,1,-196,1,-195,0,-194,2,2,-192,0,-186,-185,0,0,
+	-181,0,1,-180,0,-175,1,0,0,0,-171,-170,-169,5,2,0,
+	-168,0,-159,5,0,2,-156,2,1,2,0,-150,-149,1,0,1,
+	-143,2,0,0,0,1,7,0,-142,3,0,-138,-137,3,-135,-129,
+	-128,-127,0,3,-126,0,0,0,-125,0,-122,5,-120,0,0,0,
+	-115,9,3,-111,-110,-107,0,0,-106,-105,7,-104,2,6,-103,1,
+	-101,-93,0,0,-91,-90,0,0,-82,1,-81,-78,-75,8,0,0,
+	1,-74,0,1,5,0,0,-73,-72,-68,2,0,0,-67,4,0,
+	-64,-53,4,-49,-48,-45,0,-44,0,0,0,0,0,0,0,-43,
+	2,-40,-36,-35,0,3,8,1,0,0,-34,-33,-30,-27,0,-19,
+	20,-18,-16,3,0,-13,0,-12,0,6,0,4,0,-11,3,0,
+	-10,7,-8,-7,-5,0,-1
+};
+
+static const int ifaceFunctionSlots[] = {
+	175,154,86,264,140,260,159,220,78,121,127,24,128,252,13,150,
+	233,259,261,185,28,173,171,104,106,248,276,126,218,273,7,132,
+	243,90,60,165,39,137,153,99,161,216,271,219,286,83,178,268,
+	291,23,266,122,230,0,213,120,129,196,144,156,45,191,245,97,
+	72,48,151,272,287,35,87,77,66,277,31,241,49,275,58,226,
+	199,57,42,51,269,279,40,79,168,26,239,112,141,290,179,18,
+	147,93,105,30,192,189,116,225,85,44,114,183,163,12,9,107,
+	5,16,284,160,1,223,10,236,208,201,64,255,95,184,254,96,
+	133,267,14,4,27,84,207,56,238,177,244,59,146,292,251,152,
+	181,71,19,130,6,256,41,55,170,214,101,240,139,169,164,61,
+	217,110,123,231,193,75,237,278,158,34,8,33,65,118,43,246,
+	47,257,190,102,197,270,131,142,280,81,15,167,54,38,162,195,
+	235,53,206,136,202,76,229,21,188,3,215,94,149,221,119,274,
+	143,20,212,2,74,172,138,204,69,113,50,198,166,203,52,25,
+	68,32,89,145,253,186,294,80,293,73,70,249,247,155,37,98,
+	100,232,103,63,148,224,250,11,211,288,210,36,88,82,222,17,
+	265,91,111,258,182,125,134,117,262,205,200,62,29,180,282,289,
+	124,157,263,46,115,176,92,227,209,234,281,194,228,67,108,242,
+	135,109,187,283,174,22,285
+};
+
+static const int ifacePropertyDisplacements[] = {
+	0,1,2,4,1,-231,0,3,-227,1,0,-225,0,3,2,1,
+	0,0,-220,-216,-211,1,1,0,1,0,2,1,-210,0,-209,-207,
+	-202,-201,0,0,-200,0,0,1,0,2,0,6,-199,0,0,0,
+	-196,0,2,-195,4,0,-191,1,0,-190,0,0,1,0,-186,0,
+	0,0,-183,0,0,-177,-173,3,2,0,7,-171,0,0,2,1,
+	0,3,0,-170,-169,-168,1,0,0,1,0,2,0,0,0,0,
+	-159,-151,0,0,-150,3,0,3,3,-142,-141,0,0,0,0,-135,
+	0,0,2,4,0,-133,-126,0,6,0,1,0,2,-122,7,-120,
+	0,-117,0,-115,-111,-107,2,6,0,-106,0,0,1,0,0,0,
+	0,0,1,-102,2,0,-101,-92,0,0,0,9,-91,0,2,0,
+	0,0,-90,0,0,6,-76,1,0,3,1,0,0,0,0,0,
+	1,0,1,0,3,-74,-65,-63,0,-61,0,-60,-55,18,0,1,
+	0,4,0,-54,28,0,0,-52,-47,-43,1,-41,4,1,1,-39,
+	0,-37,-35,0,-31,10,0,33,7,0,12,-25,0,0,-19,-16,
+	15,-10,-9,0,0,-6,-5,0,-3
+};
+
+static const int ifacePropertySlots[] = {
+	26,161,19,208,116,40,77,152,119,159,169,14,144,103,6,137,
+	47,45,150,162,21,15,214,78,92,117,73,100,127,11,138,3,
+	163,179,95,118,4,25,203,145,9,113,157,112,57,1,192,200,
+	218,173,220,81,61,210,191,105,63,141,0,153,13,186,154,50,
+	17,104,58,219,165,228,178,181,102,75,7,189,99,93,65,225,
+	147,80,128,202,16,31,20,130,32,143,52,2,205,122,23,188,
+	227,84,129,96,229,193,72,164,94,64,136,56,172,83,51,139,
+	70,60,167,134,35,36,30,114,18,142,196,82,151,158,87,22,
+	221,185,46,125,133,123,231,44,62,90,183,171,170,49,146,97,
+	211,230,38,149,8,148,111,132,48,224,217,201,166,155,59,204,
+	39,195,115,215,199,216,156,140,180,190,85,110,29,33,106,209,
+	120,206,98,101,212,54,194,108,126,66,10,121,222,198,176,109,
+	24,74,226,34,91,107,175,67,5,207,124,69,135,71,42,174,
+	79,232,28,160,86,168,43,12,177,37,223,53,27,187,76,182,
+	88,89,68,55,184,213,131,41,197
+};
+
+static const int ifaceFunctionConstantDisplacements[] = {
+	0,0,1,0,-295,1,0,2,-294,1,0,-287,1,-286,-280,0,
+	-279,2,-278,1,0,-277,-271,0,0,-266,4,0,-264,0,-263,4,
+	1,1,-261,0,-252,0,-251,0,-250,-248,-246,1,0,-244,-240,1,
+	-238,2,0,0,-235,0,5,-234,-228,0,0,3,1,0,1,-226,
+	0,0,0,-224,0,0,-221,5,0,0,1,0,-220,1,1,-217,
+	2,1,0,-216,0,0,0,-214,0,0,0,2,0,0,0,0,
+	-213,1,0,-209,2,0,0,2,-207,-205,-201,0,3,-200,0,0,
+	0,1,-199,4,-198,-195,3,0,0,0,-193,-188,0,-185,0,-184,
+	-179,-177,1,-172,-168,1,0,1,1,4,1,2,-167,0,0,2,
+	0,-164,0,0,3,0,0,0,-163,0,0,0,0,0,0,-161,
+	1,-160,2,-158,0,-155,2,-153,1,-149,-148,-147,0,-146,2,-144,
+	9,-129,0,-128,-127,-126,-115,1,0,-112,0,-111,-99,-95,-93,2,
+	0,1,-92,1,4,3,0,10,1,5,-90,-89,-88,0,0,1,
+	-87,-84,-80,2,0,6,3,1,-76,8,-70,-69,-67,0,0,10,
+	0,-66,0,0,-65,11,1,-64,1,0,0,-60,-59,-58,-57,0,
+	7,0,0,0,-56,0,-54,0,0,2,-53,0,-52,-48,1,-47,
+	-41,-36,0,-33,0,-29,0,0,0,-27,0,-26,3,-25,1,0,
+	-22,1,2,-19,0,1,2,2,-16,0,1,0,26,1,-15,-12,
+	-11,-7,-5,0,0,-3,1
+};
+
+static const int ifaceFunctionConstantSlots[] = {
+	5,136,117,44,213,144,233,45,189,251,227,91,86,161,200,28,
+	8,174,72,76,115,92,98,178,226,259,108,84,242,130,162,147,
+	244,196,94,150,179,88,235,216,255,83,35,114,26,40,292,278,
+	124,187,25,47,36,100,141,58,2,51,17,277,208,127,111,110,
+	183,205,95,215,122,30,74,29,175,4,146,3,248,206,129,182,
+	105,82,85,284,286,194,69,142,269,241,236,290,285,203,272,172,
+	64,219,157,165,202,53,271,180,97,287,264,145,139,96,166,132,
+	177,281,164,15,65,192,249,42,34,80,67,52,16,75,289,133,
+	237,181,50,116,190,228,138,155,71,148,24,41,266,62,170,57,
+	112,210,230,137,201,218,134,20,252,198,93,294,158,283,275,262,
+	73,32,103,99,212,140,199,143,13,120,119,173,81,70,176,169,
+	31,153,171,273,12,59,0,6,261,276,253,263,109,209,102,254,
+	56,245,23,223,9,78,238,197,22,207,128,184,131,265,27,19,
+	79,77,107,154,221,240,247,186,250,195,229,21,163,243,193,118,
+	66,222,270,217,125,156,258,126,234,151,274,1,232,191,135,54,
+	168,288,246,101,282,220,268,260,293,239,279,49,61,257,33,14,
+	123,46,211,267,104,60,121,185,159,167,152,160,90,48,89,291,
+	39,38,18,87,106,231,68,256,43,11,204,149,188,37,280,224,
+	113,63,225,55,10,214,7
+};
+
 enum {
-	ifaceFunctionCount = 293,
-	ifaceConstantCount = 2643,
-	ifacePropertyCount = 222
+	ifaceFunctionCount = 295,
+	ifaceConstantCount = 2666,
+	ifacePropertyCount = 233
 };
 
 //--Autogenerated
@@ -3318,3 +3741,59 @@ const int IFaceTable::constantCount = ifaceConstantCount;
 
 const IFaceProperty * const IFaceTable::properties = ifaceProperties;
 const int IFaceTable::propertyCount = ifacePropertyCount;
+
+// The hashes are built by scripts/IFaceTableGen.py, so they must use the same
+// function: 32 bit FNV-1a with the displacement as the seed.
+static unsigned int HashName(unsigned int seed, const char *name) {
+	unsigned int h = seed ? seed : 0x811C9DC5u;
+	for (; *name; ++name) {
+		h = (h ^ static_cast<unsigned char>(*name)) * 0x01000193u;
+	}
+	return h;
+}
+
+// The only index name can have, which the caller must still check.
+static int HashedIndex(const char *name, const int *displacements, const int *slots, int count) {
+	if (count == 0) {
+		return -1;
+	}
+	const int displacement = displacements[HashName(0, name) % count];
+	const int slot = (displacement < 0) ? -1 - displacement :
+		static_cast<int>(HashName(displacement, name) % count);
+	return slots[slot];
+}
+
+int IFaceTable::FindConstant(const char *name) {
+	const int idx = HashedIndex(name, ifaceConstantDisplacements, ifaceConstantSlots, constantCount);
+	return (idx >= 0 && strcmp(name, constants[idx].name) == 0) ? idx : -1;
+}
+
+int IFaceTable::FindFunction(const char *name) {
+	const int idx = HashedIndex(name, ifaceFunctionDisplacements, ifaceFunctionSlots, functionCount);
+	return (idx >= 0 && strcmp(name, functions[idx].name) == 0) ? idx : -1;
+}
+
+int IFaceTable::FindFunctionByConstantName(const char *name) {
+	if (strncmp(name, "SCI_", 4)==0) {
+		// This looks like a constant for an iface function.  Take special care
+		// since the function names are mixed case, whereas the constants are all-caps.
+		const int idx = HashedIndex(name, ifaceFunctionConstantDisplacements, ifaceFunctionConstantSlots, functionCount);
+		if (idx >= 0) {
+			const char *nm = name+4;
+			const char *fn = IFaceTable::functions[idx].name;
+			while (*nm && *fn && (*nm == toupper(*fn))) {
+				++nm;
+				++fn;
+			}
+			if (!*nm && !*fn) {
+				return idx;
+			}
+		}
+	}
+	return -1;
+}
+
+int IFaceTable::FindProperty(const char *name) {
+	const int idx = HashedIndex(name, ifacePropertyDisplacements, ifacePropertySlots, propertyCount);
+	return (idx >= 0 && strcmp(name, properties[idx].name) == 0) ? idx : -1;
+}
@@ -260,3 +260,12 @@ bool MultiplexExtension::NeedsOnClose() {
 	}
 	return false;
 }
+
+bool MultiplexExtension::OnIdle() {
+	bool moreWork = false;
+	for (int i = 0; i < extensionCount; ++i) {
+		if (extensions[i]->OnIdle())
+			moreWork = true;
+	}
+	return moreWork;
+}
@@ -75,6 +75,7 @@ public:
 	virtual bool OnClose(const char *);
 	virtual bool OnUserStrip(int control, int change);
 	virtual bool NeedsOnClose();
+	virtual bool OnIdle();
 
 private:
 	Extension **extensions;
@@ -9,11 +9,14 @@
 #include <string>
 #include <sstream>
 #include <vector>
+#include <map>
 #include <algorithm>
 #include <unordered_set>
 
 #ifdef _WIN32
 #include <windows.h>
+#else
+#include <unistd.h>
 #endif
 
 // for msvc 9 (internally 1500), unordered_set is in the tr1 namespace
@@ -34,6 +37,9 @@
 #include "Extender.h"
 #include "SciTEKeys.h"
 #include "IFaceTable.h"
+#include "GUI.h"
+#include "Mutex.h"
+#include "Worker.h"
 #include "PythonExtension.h"
 
 #ifdef _WIN32
@@ -83,11 +89,17 @@ inline sptr_t CastSzToSptr(const char *cp) {
 void verifyConstantsTableOrder();
 int FindFriendlyNamedIDMConstant(const char* name);
 bool GetPaneFromInt(int nPane, ExtensionAPI::Pane* outPane);
+bool RequireMainThread();
+void StartPythonTasks();
+bool StopPythonTasks();
 void trace(const char* text, int n);
 void trace(const char* text1, const char* text2 = NULL);
 void trace_error(const char* text1, const char* text2 = NULL);
 void onUpdateUI();
 void onChangeCurrentFile();
+void BatchChar(char ch);
+void BatchKey(int keyval, int modifiers);
+void FlushKeystrokes();
 bool RunCallback(EventNumber eventNumber,
 	const char* stringPar = NULL,
 	bool useNumericPar1 = false, int numericPar1 = 0,
@@ -132,6 +144,8 @@ const char* EventNumberToString(int i)
 		case EventNumber_OnKey: return "OnKey";
 		case EventNumber_OnUserStrip: return "OnUserStrip";
 		case EventNumber_OnFileChange: return "OnFileChange";
+		case EventNumber_OnCharBatch: return "OnCharBatch";
+		case EventNumber_OnKeyBatch: return "OnKeyBatch";
 		default: return NULL;
 	}
 }
@@ -212,6 +226,7 @@ bool PythonExtension::OnClose(const char *filename)
 
 bool PythonExtension::OnChar(char ch)
 {
+	BatchChar(ch);
 	return RunCallback(EventNumber_OnChar, NULL, true, ch);
 }
 
@@ -222,6 +237,7 @@ bool PythonExtension::OnUserListSelection(int type, const char *selection)
 
 bool PythonExtension::OnKey(int keyval, int modifiers)
 {
+	BatchKey(keyval, modifiers);
 	return RunCallback(EventNumber_OnKey,
 		NULL, true, keyval, true, modifiers);
 }
@@ -250,10 +266,18 @@ bool PythonExtension::RemoveBuffer(int)
 	return false;
 }
 
+bool PythonExtension::OnIdle()
+{
+	FlushKeystrokes();
+	return false;
+}
+
 bool PythonExtension::OnFileChange()
 {
 	// the goal is to trigger the callback for all cases when the current buffer's filepath can change.
 	// new document. open document. save as. switch buffer.
+	// keystrokes typed into the previous document are delivered first.
+	FlushKeystrokes();
 	onChangeCurrentFile();
 	return RunCallback(EventNumber_OnFileChange);
 }
@@ -369,6 +393,165 @@ public:
 	}
 };
 
+// the main thread gives up the GIL whenever it returns to SciTE, so that
+// background tasks can run. saved by InitializePython.
+static PyThreadState* mainThreadState = NULL;
+
+// holds the GIL for the current thread while in scope.
+class PythonGIL
+{
+private:
+	bool _held;
+	PyGILState_STATE _state;
+	PythonGIL (const PythonGIL& other);
+	PythonGIL& operator= (const PythonGIL& other);
+
+public:
+	PythonGIL() : _held(Py_IsInitialized() != 0), _state(PyGILState_UNLOCKED)
+	{
+		if (_held)
+		{
+			_state = PyGILState_Ensure();
+		}
+	}
+	~PythonGIL()
+	{
+		if (_held)
+		{
+			PyGILState_Release(_state);
+		}
+	}
+};
+
+bool IsMainThread()
+{
+	return !mainThreadState || PyThreadState_Get() == mainThreadState;
+}
+
+// timings of event handlers and commands, so that a script making typing sluggish can be found.
+struct CallbackTiming
+{
+	enum { recentSamples = 1000 };
+	int count;
+	int overBudget;
+	double total;
+	double max;
+	std::vector<double> recent; // ring of the latest samples, for percentiles
+	size_t next;
+	
+	CallbackTiming() : count(0), overBudget(0), total(0), max(0), next(0)
+	{
+	}
+	
+	void Add(double seconds)
+	{
+		count++;
+		total += seconds;
+		max = std::max(max, seconds);
+		if (recent.size() < recentSamples)
+		{
+			recent.push_back(seconds);
+		}
+		else
+		{
+			recent[next] = seconds;
+			next = (next + 1) % recentSamples;
+		}
+	}
+	
+	double Percentile(int percent) const
+	{
+		if (recent.empty())
+		{
+			return 0;
+		}
+		
+		std::vector<double> sorted(recent);
+		size_t index = (sorted.size() - 1) * percent / 100;
+		std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+		return sorted[index];
+	}
+};
+
+class CallbackProfiler
+{
+	std::map<std::string, CallbackTiming> timings;
+	double budget; // in seconds, 0 means no budget
+	int disableAfter; // 0 means never disable
+	
+public:
+	CallbackProfiler() : budget(0), disableAfter(0)
+	{
+	}
+	
+	void SetBudget(double budgetMs, int disableAfterCount)
+	{
+		budget = budgetMs > 0 ? budgetMs / 1000.0 : 0;
+		disableAfter = disableAfterCount > 0 ? disableAfterCount : 0;
+	}
+	
+	// returns true if this call went over the budget.
+	bool Record(const std::string& name, double seconds, CallbackTiming** outTiming = NULL)
+	{
+		CallbackTiming& timing = timings[name];
+		timing.Add(seconds);
+		bool over = budget > 0 && seconds > budget;
+		if (over)
+		{
+			timing.overBudget++;
+		}
+		
+		if (outTiming)
+		{
+			*outTiming = &timing;
+		}
+		
+		return over;
+	}
+	
+	// true once, on the call that takes the handler to ext.python.event.budget.disable.
+	bool ShouldDisable(const CallbackTiming& timing)
+	{
+		return disableAfter > 0 && timing.overBudget == disableAfter;
+	}
+	
+	void ReportOverBudget(const char* what, double seconds)
+	{
+		std::ostringstream stm;
+		stm << ">Python: " << what << " took " << (int)(seconds * 1000) <<
+			" ms, over the ext.python.event.budget of " << (int)(budget * 1000) <<
+			" ms. ScApp.ShowCallbackTimings() lists the slowest handlers.\n";
+		trace(stm.str().c_str());
+	}
+	
+	PyObject* GetTimings()
+	{
+		PyObject* list = PyList_New(0);
+		for (std::map<std::string, CallbackTiming>::const_iterator it = timings.begin();
+			list && it != timings.end(); ++it)
+		{
+			const CallbackTiming& timing = it->second;
+			PyObject* item = Py_BuildValue("siddddi", it->first.c_str(), timing.count, timing.total,
+				timing.Percentile(50), timing.Percentile(99), timing.max, timing.overBudget);
+			if (!item || PyList_Append(list, item) != 0)
+			{
+				Py_XDECREF(item);
+				Py_DECREF(list);
+				return NULL;
+			}
+			
+			Py_DECREF(item);
+		}
+		
+		return list;
+	}
+	
+	void Reset()
+	{
+		timings.clear();
+	}
+} callbackProfiler;
+
 class CachePythonObjects
 {
 	PyObjectOwned cachedStrings[EventNumber_LEN];
@@ -556,7 +739,10 @@ public:
 			return true;
 		}
 		
+		PythonGIL gil;
+		GUI::ElapsedTime et;
 		PyObjectOwned result(PyRun_String(cmd, Py_file_input, runStringGlobals, runStringLocals));
+		callbackProfiler.Record(CommandTimingName(cmd), et.Duration());
 		if (PyErr_Occurred() && PyErr_ExceptionMatches(classRequestEventPropagate))
 		{
 			// this special exception means we should say that the event was not handled.
@@ -593,6 +779,7 @@ public:
 			return false;
 		}
 		
+		PythonGIL gil;
 		PyObjectOwned args;
 		BuildPythonArgs(args, eventNumber, stringPar,
 			useNumericPar1, numericPar1, useNumericPar2, numericPar2);
@@ -602,15 +789,23 @@ public:
 			return false;
 		}
 		
+		return RunCallbackWithArgs(eventNumber, args);
+	}
+	
+	// the caller holds the GIL and has checked NeedsNotification.
+	bool RunCallbackWithArgs(EventNumber eventNumber, PyObject* args)
+	{
 		PyObject* eventName = cachedStrings[eventNumber];
-		PyObjectOwned fullArgs(Py_BuildValue("OO", eventName, (PyObject*)args));
+		PyObjectOwned fullArgs(Py_BuildValue("OO", eventName, args));
 		if (!fullArgs)
 		{
 			trace_error("Error building full args.");
 			return false;
 		}
 		
+		GUI::ElapsedTime et;
 		PyObjectOwned result(PyObject_CallObject(functionOnEvent, fullArgs));
+		CheckEventTiming(eventNumber, et.Duration());
 		if (!result)
 		{
 			trace_error("Error in callback.", EventNumberToString(eventNumber));
@@ -631,6 +826,30 @@ public:
 		return false;
 	}
 	
+	// slow handlers are disabled one at a time through app_RecordTiming,
+	// so the event itself is only reported here.
+	void CheckEventTiming(EventNumber eventNumber, double seconds)
+	{
+		CallbackTiming* timing = NULL;
+		if (callbackProfiler.Record(EventNumberToString(eventNumber), seconds, &timing) &&
+			timing->overBudget == 1)
+		{
+			callbackProfiler.ReportOverBudget(EventNumberToString(eventNumber), seconds);
+		}
+	}
+	
+	static std::string CommandTimingName(const char* cmd)
+	{
+		// commands are keyed by the start of their code, which is enough to tell them apart.
+		std::string name("py:");
+		for (const char* p = cmd; *p && *p != '\n' && name.size() < 60; p++)
+		{
+			name += *p == '\r' || *p == '\t' ? ' ' : *p;
+		}
+		
+		return name;
+	}
+	
 	void EnableNotification(const char* eventName, bool enabled)
 	{
 		EventNumber number = eventNumberFromString(eventName);
@@ -680,12 +899,16 @@ void PythonExtension::InitializePython()
 	{
 		SetupPythonNamespace();
 		cachePythonObjects.Initialize();
+		mainThreadState = PyEval_SaveThread();
 	}
 }
 
 bool PythonExtension::Initialise(ExtensionAPI* host)
 {
 	_host = host;
+	StartPythonTasks();
+	callbackProfiler.SetBudget(atof(_host->Property("ext.python.event.budget").c_str()),
+		atoi(_host->Property("ext.python.event.budget.disable").c_str()));
 	std::string delayLoadProp = _host->Property("ext.python.delayload");
 	bool delayLoad = delayLoadProp.length() > 0 && delayLoadProp[0] != '0';
 
@@ -701,8 +924,21 @@ bool PythonExtension::Initialise(ExtensionAPI* host)
 
 bool PythonExtension::Finalise()
 {
+	bool tasksStopped = StopPythonTasks();
+	if (mainThreadState)
+	{
+		PyEval_RestoreThread(mainThreadState);
+		mainThreadState = NULL;
+	}
+	
 	cachePythonObjects.Release();
-	Py_Finalize();
+	if (tasksStopped)
+	{
+		// otherwise a task is still in Python code, and finalizing would crash it.
+		Py_Finalize();
+	}
+	
+	// tasks check the pool's stopping flag so never reach the host after this.
 	_host = NULL;
 	return false;
 }
@@ -721,6 +957,7 @@ bool PythonExtension::Load(const char *filename)
 		if (f)
 		{
 			// Python will close the file handle
+			PythonGIL gil;
 			int result = PyRun_SimpleFileEx(f, filename, 1);
 			if (result != 0)
 			{
@@ -774,128 +1011,766 @@ inline PyObject* IncrefAndReturnNone()
 	return Py_None;
 }
 
-PyObject* pyfun_LogStdout(PyObject*, PyObject* args)
+// Keystrokes for OnCharBatch and OnKeyBatch handlers, which are called once SciTE is idle
+// rather than on every key, so that slow handlers like autocomplete don't add latency to typing.
+class KeystrokeBatch
 {
-	const char* msg = NULL; // we don't own this.
-	if (PyArg_ParseTuple(args, "s", &msg) && msg)
+	std::string chars;
+	std::vector<std::pair<int, int> > ranges; // where chars were typed, adjacent ranges are merged
+	std::vector<std::pair<int, int> > keys; // keyval and modifiers
+	
+	static PyObject* BuildRangeList(const std::vector<std::pair<int, int> >& pairs)
 	{
-		if (Host())
+		PyObject* list = PyList_New(pairs.size());
+		for (size_t i = 0; list && i < pairs.size(); i++)
 		{
-			trace(msg);
+			PyObject* item = Py_BuildValue("ii", pairs[i].first, pairs[i].second);
+			if (!item)
+			{
+				Py_CLEAR(list);
+				break;
+			}
+			
+			PyList_SET_ITEM(list, i, item); // steals the reference
 		}
-
-		return IncrefAndReturnNone();
+		
+		return list;
 	}
-	else
+	
+	static PyObject* BuildKeyList(const std::vector<std::pair<int, int> >& pairs)
 	{
-		return NULL;
+		PyObject* list = PyList_New(pairs.size());
+		for (size_t i = 0; list && i < pairs.size(); i++)
+		{
+			int modifiers = pairs[i].second;
+			PyObject* item = Py_BuildValue("iOOO", pairs[i].first,
+				(SCMOD_SHIFT & modifiers) != 0 ? Py_True : Py_False,
+				(SCMOD_CTRL & modifiers) != 0 ? Py_True : Py_False,
+				(SCMOD_ALT & modifiers) != 0 ? Py_True : Py_False);
+			if (!item)
+			{
+				Py_CLEAR(list);
+				break;
+			}
+			
+			PyList_SET_ITEM(list, i, item); // steals the reference
+		}
+		
+		return list;
 	}
-}
-
-PyObject* pyfun_MessageBox(PyObject*, PyObject* args)
-{
-	const char* msg = NULL; // we don't own this.
-	if (PyArg_ParseTuple(args, "s", &msg) && msg)
+	
+	static void Deliver(EventNumber eventNumber, PyObject* args)
 	{
-#ifdef _WIN32
-		::MessageBoxA(NULL, msg, "SciTE", 0);
-#endif
-		return IncrefAndReturnNone();
+		if (!args)
+		{
+			trace_error("Error building args.", EventNumberToString(eventNumber));
+			PyErr_Clear();
+		}
+		else if (cachePythonObjects.NeedsNotification(eventNumber))
+		{
+			cachePythonObjects.RunCallbackWithArgs(eventNumber, args);
+		}
 	}
-	else
+	
+public:
+	void AddChar(char ch)
 	{
-		return NULL;
+		if (cachePythonObjects.NeedsNotification(EventNumber_OnCharBatch))
+		{
+			int end = (int)Host()->Send(ExtensionAPI::paneEditor, SCI_GETCURRENTPOS);
+			int start = (int)Host()->Send(ExtensionAPI::paneEditor, SCI_POSITIONBEFORE, end);
+			if (!ranges.empty() && ranges.back().second == start)
+			{
+				ranges.back().second = end;
+			}
+			else
+			{
+				ranges.push_back(std::make_pair(start, end));
+			}
+			
+			chars += ch;
+			Host()->RequestIdle();
+		}
 	}
-}
-
-void SciteOpenFile(const char* filename)
-{
-	std::string cmd = "open:";
-	for (unsigned int i = 0; i < strlen(filename); i++)
+	
+	void AddKey(int keyval, int modifiers)
 	{
-		if (filename[i] == '\\')
+		if (cachePythonObjects.NeedsNotification(EventNumber_OnKeyBatch))
 		{
-			cmd += "\\\\";
+			keys.push_back(std::make_pair(keyval, modifiers));
+			Host()->RequestIdle();
 		}
-		else
+	}
+	
+	void Flush()
+	{
+		if ((chars.empty() && keys.empty()) || !Host())
 		{
-			cmd += filename[i];
+			return;
+		}
+		
+		// handlers may type more, so take the pending keystrokes first.
+		std::string charsTyped;
+		std::vector<std::pair<int, int> > rangesTyped, keysTyped;
+		charsTyped.swap(chars);
+		rangesTyped.swap(ranges);
+		keysTyped.swap(keys);
+		
+		PythonGIL gil;
+		if (!charsTyped.empty())
+		{
+			PyObjectOwned rangeList(BuildRangeList(rangesTyped));
+			PyObjectOwned args(rangeList ?
+				Py_BuildValue("s#O", charsTyped.data(), (int)charsTyped.size(), (PyObject*)rangeList) : NULL);
+			Deliver(EventNumber_OnCharBatch, args);
+		}
+		
+		if (!keysTyped.empty())
+		{
+			PyObjectOwned keyList(BuildKeyList(keysTyped));
+			PyObjectOwned args(keyList ? Py_BuildValue("(O)", (PyObject*)keyList) : NULL);
+			Deliver(EventNumber_OnKeyBatch, args);
 		}
 	}
+} keystrokeBatch;
 
-	Host()->Perform(cmd.c_str());
+void BatchChar(char ch)
+{
+	keystrokeBatch.AddChar(ch);
 }
 
-PyObject* pyfun_SciteOpenFile(PyObject*, PyObject* args)
+void BatchKey(int keyval, int modifiers)
 {
-	const char* filename = NULL; // we don't own this.
-	if (PyArg_ParseTuple(args, "s", &filename) && filename)
-	{
-		SciteOpenFile(filename);
-		return IncrefAndReturnNone();
-	}
-	else
-	{
-		return NULL;
-	}
+	keystrokeBatch.AddKey(keyval, modifiers);
 }
 
-PyObject* pyfun_GetProperty(PyObject*, PyObject* args)
+void FlushKeystrokes()
 {
-	const char* propName = NULL; // we don't own this.
-	if (PyArg_ParseTuple(args, "s", &propName) && propName)
+	keystrokeBatch.Flush();
+}
+
+// raised in a background task that is cancelled or times out
+static PyObject* taskCancelledError = NULL;
+
+inline void SleepMilliseconds(int ms)
+{
+#ifdef _WIN32
+	::Sleep(ms);
+#else
+	usleep(ms * 1000);
+#endif
+}
+
+// Python work that a script runs in the background with ScApp.RunInBackground.
+// Each task runs on its own thread, holding the GIL only while running Python code,
+// and its callback is then called on the main thread with (result, exception).
+// The fields shared between threads are guarded by the pool's mutex.
+class PythonTask : public ExtensionWorker
+{
+	PythonTask(const PythonTask& other);
+	PythonTask& operator= (const PythonTask& other);
+
+public:
+	int id;
+	double timeout;
+	GUI::ElapsedTime et;
+	long threadId;
+	bool cancelled;
+	bool timedOut;
+	PyObject* function;
+	PyObject* args;
+	PyObject* callback;
+	PyObject* result;
+	PyObject* error;
+
+	PythonTask(int id_, PyObject* function_, PyObject* args_, PyObject* callback_, double timeout_) :
+		id(id_), timeout(timeout_), threadId(0), cancelled(false), timedOut(false),
+		function(function_), args(args_), callback(callback_), result(NULL), error(NULL)
+	{
+		Py_INCREF(function);
+		Py_INCREF(args);
+		Py_INCREF(callback);
+	}
+
+	// needs the GIL. after Python is finalized the references are left alone.
+	void ReleaseObjects()
+	{
+		Py_CLEAR(function);
+		Py_CLEAR(args);
+		Py_CLEAR(callback);
+		Py_CLEAR(result);
+		Py_CLEAR(error);
+	}
+
+	virtual void Execute();
+	virtual void FinishOnMainThread();
+};
+
+// Runs at most maxRunning tasks at once, queueing the rest. A watchdog thread
+// runs while there are tasks with timeouts, raising TaskCancelled in tasks that
+// are over time. Locking order is the GIL, then the mutex.
+class PythonTaskPool
+{
+	Mutex* mutex;
+	std::vector<PythonTask*> queued;
+	std::vector<PythonTask*> running;
+	Worker* watchdog;
+	int nextId;
+	size_t maxRunning;
+	bool stopping;
+	std::string pendingOutput;
+
+	PythonTaskPool(const PythonTaskPool& other);
+	PythonTaskPool& operator= (const PythonTaskPool& other);
+
+	bool NeedsWatchdog() const
 	{
-		std::string value = Host()->Property(propName);
+		for (size_t i = 0; i < queued.size(); i++)
+		{
+			if (queued[i]->timeout > 0)
+				return true;
+		}
 		
-		// follow properties file behavior: a missing property returns empty string, not null
-		const char* sz = value.length() > 0 ? value.c_str() : "";
+		for (size_t i = 0; i < running.size(); i++)
+		{
+			if (running[i]->timeout > 0 && !running[i]->timedOut && !running[i]->cancelled)
+				return true;
+		}
 		
-		// give the caller ownership of this object.
-		return PyString_FromString(sz);
-	}
-	else
-	{
-		return NULL;
+		return false;
 	}
-}
 
-PyObject* pyfun_SetProperty(PyObject*, PyObject* args)
-{
-	const char* propName = NULL; // we don't own this.
-	const char* propValue = NULL; // we don't own this.
-	if (PyArg_ParseTuple(args, "ss", &propName, &propValue) && propName && propValue)
+	void Interrupt(PythonTask* task)
 	{
-		// it looks like SetProperty allocates, it's ok if key and val go out of scope.
-		Host()->SetProperty(propName, propValue);
-		return IncrefAndReturnNone();
+		// the exception is raised the next time the thread runs Python bytecode.
+		if (task->threadId)
+		{
+			PyThreadState_SetAsyncExc(task->threadId, taskCancelledError);
+		}
 	}
-	else
+
+public:
+	PythonTaskPool() : mutex(NULL), watchdog(NULL), nextId(1), maxRunning(2), stopping(false)
 	{
-		return NULL;
 	}
-}
 
-PyObject* pyfun_UnsetProperty(PyObject*, PyObject* args)
-{
-	const char* propName = NULL; // we don't own this.
-	if (PyArg_ParseTuple(args, "s", &propName) && propName)
+	// called on the main thread before any task is submitted.
+	void Start(int maxRunning_)
 	{
-		Host()->UnsetProperty(propName);
-		return IncrefAndReturnNone();
+		if (!mutex)
+		{
+			mutex = Mutex::Create();
+		}
+		
+		maxRunning = std::max(1, maxRunning_);
 	}
-	else
+
+	// needs the GIL.
+	int Submit(PyObject* function, PyObject* args, PyObject* callback, double timeout)
 	{
-		return NULL;
+		PythonTask* task = NULL;
+		{
+			Lock lock(mutex);
+			task = new PythonTask(nextId++, function, args, callback, timeout);
+			queued.push_back(task);
+		}
+		
+		StartQueued();
+		return task->id;
 	}
-}
 
-PyObject* pyfun_pane_Append(PyObject*, PyObject* args)
-{
-	const char* text = NULL; // we don't own this.
-	int nPane = -1;
-	ExtensionAPI::Pane pane;
-	if (PyArg_ParseTuple(args, "is", &nPane, &text) &&
-		text &&
+	// needs the GIL.
+	void StartQueued()
+	{
+		std::vector<PythonTask*> starting;
+		bool startWatchdog = false;
+		{
+			Lock lock(mutex);
+			while (!stopping && !queued.empty() && running.size() < maxRunning)
+			{
+				starting.push_back(queued.front());
+				running.push_back(queued.front());
+				queued.erase(queued.begin());
+			}
+			
+			startWatchdog = !stopping && !watchdog && NeedsWatchdog();
+			if (startWatchdog)
+			{
+				watchdog = new PythonTaskWatchdog();
+			}
+		}
+		
+		for (size_t i = 0; i < starting.size(); i++)
+		{
+			if (!Host()->PerformOnNewThread(starting[i]))
+			{
+				// finish it as a failure, through the main thread as usual.
+				starting[i]->error = PyObject_CallFunction(PyExc_RuntimeError, (char*) "s",
+					"could not start a thread for the task.");
+				starting[i]->SetCompleted();
+				Host()->PostOnMainThread(WORK_EXTENSION, starting[i]);
+			}
+		}
+		
+		if (startWatchdog && !Host()->PerformOnNewThread(watchdog))
+		{
+			trace_error("Could not start a thread to time out background tasks.");
+			Lock lock(mutex);
+			delete watchdog;
+			watchdog = NULL;
+		}
+	}
+
+	// needs the GIL. returns false if the task had already finished.
+	bool Cancel(int id)
+	{
+		PythonTask* dropped = NULL;
+		{
+			Lock lock(mutex);
+			for (size_t i = 0; i < queued.size(); i++)
+			{
+				if (queued[i]->id == id)
+				{
+					dropped = queued[i];
+					queued.erase(queued.begin() + i);
+					break;
+				}
+			}
+			
+			for (size_t i = 0; !dropped && i < running.size(); i++)
+			{
+				if (running[i]->id == id && !running[i]->cancelled)
+				{
+					running[i]->cancelled = true;
+					Interrupt(running[i]);
+					return true;
+				}
+			}
+		}
+		
+		if (dropped)
+		{
+			dropped->ReleaseObjects();
+			delete dropped;
+		}
+		
+		return dropped != NULL;
+	}
+
+	// called on the task's thread. returns whether the task should run.
+	bool Starting(PythonTask* task)
+	{
+		Lock lock(mutex);
+		if (task->cancelled || stopping)
+			return false;
+		
+		task->threadId = PyThreadState_Get()->thread_id;
+		task->et.Duration(true);
+		return true;
+	}
+
+	// called on the task's thread, with the GIL, when it has stopped running Python code.
+	void Stopped(PythonTask* task)
+	{
+		long threadId = 0;
+		{
+			Lock lock(mutex);
+			threadId = task->threadId;
+			task->threadId = 0;
+		}
+		
+		if (threadId)
+		{
+			// clear any cancellation that arrived too late to be raised
+			PyThreadState_SetAsyncExc(threadId, NULL);
+		}
+	}
+
+	// called on the task's thread when it has finished. the task is posted to the main
+	// thread under the mutex so that Stop can not begin and the host go away meanwhile.
+	// once stopping, the task is left as Python may be finalized before it could be freed.
+	void PostFinished(PythonTask* task)
+	{
+		Lock lock(mutex);
+		if (!stopping)
+		{
+			Host()->PostOnMainThread(WORK_EXTENSION, task);
+		}
+	}
+
+	// called on the main thread when the task's callback is about to run.
+	void Remove(PythonTask* task)
+	{
+		Lock lock(mutex);
+		running.erase(std::remove(running.begin(), running.end(), task), running.end());
+	}
+
+	// called on the watchdog thread. returns whether the watchdog is still needed.
+	bool CheckTimeouts()
+	{
+		bool overTime = false;
+		{
+			Lock lock(mutex);
+			for (size_t i = 0; i < running.size() && !overTime; i++)
+			{
+				PythonTask* task = running[i];
+				overTime = task->threadId && task->timeout > 0 && !task->timedOut &&
+					!task->cancelled && task->et.Duration() > task->timeout;
+			}
+		}
+		
+		if (overTime)
+		{
+			PythonGIL gil;
+			Lock lock(mutex);
+			for (size_t i = 0; !stopping && i < running.size(); i++)
+			{
+				PythonTask* task = running[i];
+				if (task->threadId && task->timeout > 0 && !task->timedOut &&
+					!task->cancelled && task->et.Duration() > task->timeout)
+				{
+					task->timedOut = true;
+					Interrupt(task);
+				}
+			}
+		}
+		
+		Lock lock(mutex);
+		if (stopping || !NeedsWatchdog())
+		{
+			// the watchdog deletes itself, a new one is made if needed
+			watchdog = NULL;
+			return false;
+		}
+		
+		return true;
+	}
+
+	void AppendOutput(const char* text)
+	{
+		Lock lock(mutex);
+		pendingOutput += text;
+	}
+
+	// called on the main thread
+	void FlushOutput()
+	{
+		std::string output;
+		{
+			Lock lock(mutex);
+			output.swap(pendingOutput);
+		}
+		
+		if (!output.empty())
+		{
+			trace(output.c_str());
+		}
+	}
+
+	bool Stopping()
+	{
+		Lock lock(mutex);
+		return stopping;
+	}
+
+	// called on the main thread, without the GIL. Cancels every task and waits a short
+	// time for them to stop. returns false if a task is still running Python code.
+	bool Stop()
+	{
+		if (!mutex)
+		{
+			return true;
+		}
+		
+		std::vector<PythonTask*> dropped;
+		{
+			PythonGIL gil;
+			Lock lock(mutex);
+			stopping = true;
+			dropped.swap(queued);
+			for (size_t i = 0; i < running.size(); i++)
+			{
+				running[i]->cancelled = true;
+				Interrupt(running[i]);
+			}
+		}
+		
+		for (size_t i = 0; i < dropped.size(); i++)
+		{
+			PythonGIL gil;
+			dropped[i]->ReleaseObjects();
+			delete dropped[i];
+		}
+		
+		// tasks that finish now are not posted to the main thread, and are left undeleted.
+		for (int wait = 0; wait < 200; wait++)
+		{
+			bool finished = true;
+			{
+				Lock lock(mutex);
+				finished = !watchdog;
+				for (size_t i = 0; finished && i < running.size(); i++)
+				{
+					finished = running[i]->FinishedJob();
+				}
+			}
+			
+			if (finished)
+			{
+				return true;
+			}
+			
+			SleepMilliseconds(10);
+		}
+		
+		return false;
+	}
+
+	class PythonTaskWatchdog : public Worker
+	{
+	public:
+		virtual void Execute();
+	};
+} pythonTaskPool;
+
+void PythonTaskPool::PythonTaskWatchdog::Execute()
+{
+	while (pythonTaskPool.CheckTimeouts())
+	{
+		SleepMilliseconds(50);
+	}
+	
+	SetCompleted();
+	delete this;
+}
+
+void PythonTask::Execute()
+{
+	{
+		PythonGIL gil;
+		if (pythonTaskPool.Starting(this))
+		{
+			result = PyObject_CallObject(function, args);
+			if (!result)
+			{
+				PyObject *type = NULL, *value = NULL, *traceback = NULL;
+				PyErr_Fetch(&type, &value, &traceback);
+				PyErr_NormalizeException(&type, &value, &traceback);
+				error = value;
+				Py_XDECREF(type);
+				Py_XDECREF(traceback);
+			}
+			
+			pythonTaskPool.Stopped(this);
+		}
+	}
+	
+	SetCompleted();
+	pythonTaskPool.PostFinished(this);
+}
+
+void PythonTask::FinishOnMainThread()
+{
+	if (pythonTaskPool.Stopping())
+	{
+		// Python may already be finalized
+		delete this;
+		return;
+	}
+	
+	PythonGIL gil;
+	pythonTaskPool.Remove(this);
+	pythonTaskPool.FlushOutput();
+	if (timedOut)
+	{
+		Py_CLEAR(error);
+		error = PyObject_CallFunction(taskCancelledError, (char*) "s", "the task timed out.");
+	}
+	
+	if (!cancelled && callback != Py_None)
+	{
+		PyObjectOwned callbackResult(PyObject_CallFunction(callback, (char*) "OO",
+			result ? result : Py_None, error ? error : Py_None));
+		if (!callbackResult)
+		{
+			trace_error("Error in background task callback.");
+			PyErr_Print();
+		}
+	}
+	
+	ReleaseObjects();
+	delete this;
+	pythonTaskPool.StartQueued();
+}
+
+void StartPythonTasks()
+{
+	int maxRunning = atoi(Host()->Property("ext.python.worker.threads").c_str());
+	pythonTaskPool.Start(maxRunning > 0 ? maxRunning : 2);
+}
+
+bool StopPythonTasks()
+{
+	return pythonTaskPool.Stop();
+}
+
+void AppendTaskOutput(const char* text)
+{
+	pythonTaskPool.AppendOutput(text);
+}
+
+PyObject* pyfun_LogStdout(PyObject*, PyObject* args)
+{
+	const char* msg = NULL; // we don't own this.
+	if (PyArg_ParseTuple(args, "s", &msg) && msg)
+	{
+		if (!IsMainThread())
+		{
+			// output from a background task is shown when the task finishes.
+			AppendTaskOutput(msg);
+		}
+		else if (Host())
+		{
+			trace(msg);
+		}
+
+		return IncrefAndReturnNone();
+	}
+	else
+	{
+		return NULL;
+	}
+}
+
+PyObject* pyfun_MessageBox(PyObject*, PyObject* args)
+{
+	if (!RequireMainThread())
+	{
+		return NULL;
+	}
+	
+	const char* msg = NULL; // we don't own this.
+	if (PyArg_ParseTuple(args, "s", &msg) && msg)
+	{
+#ifdef _WIN32
+		::MessageBoxA(NULL, msg, "SciTE", 0);
+#endif
+		return IncrefAndReturnNone();
+	}
+	else
+	{
+		return NULL;
+	}
+}
+
+void SciteOpenFile(const char* filename)
+{
+	std::string cmd = "open:";
+	for (unsigned int i = 0; i < strlen(filename); i++)
+	{
+		if (filename[i] == '\\')
+		{
+			cmd += "\\\\";
+		}
+		else
+		{
+			cmd += filename[i];
+		}
+	}
+
+	Host()->Perform(cmd.c_str());
+}
+
+PyObject* pyfun_SciteOpenFile(PyObject*, PyObject* args)
+{
+	if (!RequireMainThread())
+	{
+		return NULL;
+	}
+	
+	const char* filename = NULL; // we don't own this.
+	if (PyArg_ParseTuple(args, "s", &filename) && filename)
+	{
+		SciteOpenFile(filename);
+		return IncrefAndReturnNone();
+	}
+	else
+	{
+		return NULL;
+	}
+}
+
+PyObject* pyfun_GetProperty(PyObject*, PyObject* args)
+{
+	if (!RequireMainThread())
+	{
+		return NULL;
+	}
+	
+	const char* propName = NULL; // we don't own this.
+	if (PyArg_ParseTuple(args, "s", &propName) && propName)
+	{
+		std::string value = Host()->Property(propName);
+		
+		// follow properties file behavior: a missing property returns empty string, not null
+		const char* sz = value.length() > 0 ? value.c_str() : "";
+		
+		// give the caller ownership of this object.
+		return PyString_FromString(sz);
+	}
+	else
+	{
+		return NULL;
+	}
+}
+
+PyObject* pyfun_SetProperty(PyObject*, PyObject* args)
+{
+	if (!RequireMainThread())
+	{
+		return NULL;
+	}
+	
+	const char* propName = NULL; // we don't own this.
+	const char* propValue = NULL; // we don't own this.
+	if (PyArg_ParseTuple(args, "ss", &propName, &propValue) && propName && propValue)
+	{
+		// it looks like SetProperty allocates, it's ok if key and val go out of scope.
+		Host()->SetProperty(propName, propValue);
+		return IncrefAndReturnNone();
+	}
+	else
+	{
+		return NULL;
+	}
+}
+
+PyObject* pyfun_UnsetProperty(PyObject*, PyObject* args)
+{
+	if (!RequireMainThread())
+	{
+		return NULL;
+	}
+	
+	const char* propName = NULL; // we don't own this.
+	if (PyArg_ParseTuple(args, "s", &propName) && propName)
+	{
+		Host()->UnsetProperty(propName);
+		return IncrefAndReturnNone();
+	}
+	else
+	{
+		return NULL;
+	}
+}
+
+PyObject* pyfun_pane_Append(PyObject*, PyObject* args)
+{
+	const char* text = NULL; // we don't own this.
+	int nPane = -1;
+	ExtensionAPI::Pane pane;
+	if (PyArg_ParseTuple(args, "is", &nPane, &text) &&
+		text &&
 		GetPaneFromInt(nPane, &pane))
 	{
 		Host()->Insert(pane, Host()->Send(pane, SCI_GETLENGTH, 0, 0), text);
@@ -986,29 +1861,207 @@ PyObject* pyfun_pane_FindText(PyObject*, PyObject* args) // returns a tuple
 			nPosEnd = Host()->Send(pane, SCI_GETLENGTH, 0, 0);
 		}
 
-		if (!(nPosStart < 0 || nPosEnd < 0))
-		{
-			Sci_TextToFind ft = { {0, 0}, 0, {0, 0} };
-			ft.lpstrText = text;
-			ft.chrg.cpMin = nPosStart;
-			ft.chrg.cpMax = nPosEnd;
-			int result = Host()->Send(pane, SCI_FINDTEXT,
-				static_cast<uptr_t>(nFlags), reinterpret_cast<sptr_t>(&ft));
+		if (!(nPosStart < 0 || nPosEnd < 0))
+		{
+			Sci_TextToFind ft = { {0, 0}, 0, {0, 0} };
+			ft.lpstrText = text;
+			ft.chrg.cpMin = nPosStart;
+			ft.chrg.cpMax = nPosEnd;
+			int result = Host()->Send(pane, SCI_FINDTEXT,
+				static_cast<uptr_t>(nFlags), reinterpret_cast<sptr_t>(&ft));
+
+			if (result >= 0)
+			{
+				// give the caller ownership of this object.
+				return Py_BuildValue(
+					"(i,i)", ft.chrgText.cpMin, ft.chrgText.cpMax);
+			}
+			else
+			{
+				return IncrefAndReturnNone();
+			}
+		}
+	}
+
+	return NULL;
+}
+
+// A read-only view of a range of a pane's document. Indexing and slicing copy just the
+// characters asked for out of the document's own memory, so a script can walk a large
+// document in pieces without first copying all of it.
+// Rules: the text is located again with SCI_GETRANGEPOINTER for each index or slice and
+// the pointer is not kept afterwards. The view becomes stale, and reading it raises an
+// error, once the pane shows another document or any text is inserted or deleted, as
+// seen through SCI_GETCHANGESTAMP.
+// The buffer protocol is not provided: re and buffer() keep the pointer they are given
+// for as long as they run, and a change to the document would leave them reading freed
+// memory or the gap.
+struct PaneBufferObject
+{
+	PyObject_HEAD
+	int nPane;
+	sptr_t docPointer;
+	int changeStamp;
+	int start;
+	int length;
+};
+
+// returns NULL with a Python error set if the view is stale.
+const char* PaneBufferText(PaneBufferObject* self)
+{
+	ExtensionAPI::Pane pane;
+	if (!Host())
+	{
+		PyErr_SetString(PyExc_RuntimeError, "buffer is not available.");
+		return NULL;
+	}
+	else if (!GetPaneFromInt(self->nPane, &pane))
+	{
+		return NULL;
+	}
+	
+	if (Host()->Send(pane, SCI_GETDOCPOINTER, 0, 0) != self->docPointer ||
+		Host()->Send(pane, SCI_GETCHANGESTAMP, 0, 0) != self->changeStamp)
+	{
+		PyErr_SetString(PyExc_RuntimeError, "buffer is stale, the document was modified or switched.");
+		return NULL;
+	}
+	
+	if (self->length == 0)
+	{
+		return "";
+	}
+	
+	return reinterpret_cast<const char*>(
+		Host()->Send(pane, SCI_GETRANGEPOINTER, self->start, self->length));
+}
+
+Py_ssize_t PaneBuffer_Length(PyObject* self)
+{
+	return reinterpret_cast<PaneBufferObject*>(self)->length;
+}
+
+PyObject* PaneBuffer_Item(PyObject* self, Py_ssize_t i)
+{
+	if (i < 0 || i >= reinterpret_cast<PaneBufferObject*>(self)->length)
+	{
+		PyErr_SetString(PyExc_IndexError, "buffer index out of range.");
+		return NULL;
+	}
+	
+	const char* text = PaneBufferText(reinterpret_cast<PaneBufferObject*>(self));
+	return text ? PyString_FromStringAndSize(text + i, 1) : NULL;
+}
+
+PyObject* PaneBuffer_Slice(PyObject* self, Py_ssize_t left, Py_ssize_t right)
+{
+	// the sequence protocol has already adjusted negative indices.
+	const Py_ssize_t length = reinterpret_cast<PaneBufferObject*>(self)->length;
+	left = std::max<Py_ssize_t>(0, std::min(left, length));
+	right = std::max(left, std::min(right, length));
+	const char* text = PaneBufferText(reinterpret_cast<PaneBufferObject*>(self));
+	return text ? PyString_FromStringAndSize(text + left, right - left) : NULL;
+}
+
+static PySequenceMethods paneBufferSequenceMethods =
+{
+	PaneBuffer_Length, // sq_length
+	0, // sq_concat
+	0, // sq_repeat
+	PaneBuffer_Item, // sq_item
+	PaneBuffer_Slice, // sq_slice
+	0, // sq_ass_item
+	0, // sq_ass_slice
+	0, // sq_contains
+	0, // sq_inplace_concat
+	0, // sq_inplace_repeat
+};
+
+static PyTypeObject paneBufferType =
+{
+	PyVarObject_HEAD_INIT(NULL, 0)
+	"SciTEModule.PaneBuffer", // tp_name
+	sizeof(PaneBufferObject), // tp_basicsize
+	0, // tp_itemsize
+	0, // tp_dealloc
+	0, // tp_print
+	0, // tp_getattr
+	0, // tp_setattr
+	0, // tp_compare
+	0, // tp_repr
+	0, // tp_as_number
+	&paneBufferSequenceMethods, // tp_as_sequence
+	0, // tp_as_mapping
+	0, // tp_hash
+	0, // tp_call
+	0, // tp_str
+	0, // tp_getattro
+	0, // tp_setattro
+	0, // tp_as_buffer
+	Py_TPFLAGS_DEFAULT, // tp_flags
+	"Read-only view of the text of a pane, see ScPaneClass.PaneGetBuffer", // tp_doc
+	0, // tp_traverse
+	0, // tp_clear
+	0, // tp_richcompare
+	0, // tp_weaklistoffset
+	0, // tp_iter
+	0, // tp_iternext
+	0, // tp_methods
+	0, // tp_members
+	0, // tp_getset
+	0, // tp_base
+	0, // tp_dict
+	0, // tp_descr_get
+	0, // tp_descr_set
+	0, // tp_dictoffset
+	0, // tp_init
+	0, // tp_alloc
+	0, // tp_new
+	0, // tp_free
+	0, // tp_is_gc
+	0, // tp_bases
+	0, // tp_mro
+	0, // tp_cache
+	0, // tp_subclasses
+	0, // tp_weaklist
+	0, // tp_del
+	0, // tp_version_tag
+};
 
-			if (result >= 0)
-			{
-				// give the caller ownership of this object.
-				return Py_BuildValue(
-					"(i,i)", ft.chrgText.cpMin, ft.chrgText.cpMax);
-			}
-			else
-			{
-				return IncrefAndReturnNone();
-			}
-		}
+PyObject* pyfun_pane_GetBuffer(PyObject*, PyObject* args)
+{
+	int nPane = -1, nPosStart = 0, nPosEnd = -1;
+	ExtensionAPI::Pane pane;
+	if (!PyArg_ParseTuple(args, "i|ii", &nPane, &nPosStart, &nPosEnd) ||
+		!GetPaneFromInt(nPane, &pane))
+	{
+		return NULL;
 	}
-
-	return NULL;
+	
+	const int documentLength = Host()->Send(pane, SCI_GETLENGTH, 0, 0);
+	if (nPosEnd == -1)
+	{
+		nPosEnd = documentLength;
+	}
+	
+	if (nPosStart < 0 || nPosEnd < nPosStart || nPosEnd > documentLength)
+	{
+		PyErr_SetString(PyExc_RuntimeError, "Invalid range.");
+		return NULL;
+	}
+	
+	PaneBufferObject* buffer = PyObject_New(PaneBufferObject, &paneBufferType);
+	if (buffer)
+	{
+		buffer->nPane = nPane;
+		buffer->docPointer = Host()->Send(pane, SCI_GETDOCPOINTER, 0, 0);
+		buffer->changeStamp = Host()->Send(pane, SCI_GETCHANGESTAMP, 0, 0);
+		buffer->start = nPosStart;
+		buffer->length = nPosEnd - nPosStart;
+	}
+	
+	// give the caller ownership of this object.
+	return reinterpret_cast<PyObject*>(buffer);
 }
 
 int GetPythonInt(PyObject *arg, bool optional=false)
@@ -1296,6 +2349,220 @@ PyObject* pyfun_pane_SendScintilla(PyObject*, PyObject* args)
 	}
 }
 
+PyObject* pyfun_pane_GetMessage(PyObject*, PyObject* args)
+{
+	const char* functionName = NULL; // we don't own this.
+	if (!PyArg_ParseTuple(args, "s", &functionName) || !functionName)
+	{
+		return NULL;
+	}
+
+	// message numbers for functions aren't in the constants table, look them up here.
+	std::string nameFound;
+	IFaceFunction functionInfo = SearchForFunction(functionName, nameFound);
+	if (PyErr_Occurred())
+	{
+		return NULL;
+	}
+	else if (!functionInfo.name)
+	{
+		PyErr_SetString(PyExc_RuntimeError, "Function or property not found");
+		return NULL;
+	}
+	else
+	{
+		return PyInt_FromLong(functionInfo.value);
+	}
+}
+
+// a function name looked up once for the whole batch
+struct BatchFunction
+{
+	std::string name;
+	std::string nameFound;
+	IFaceFunction functionInfo;
+};
+
+// whether a raw message reads a string from the given parameter. a Python str is
+// immutable and may be interned, so it must never be passed where Scintilla writes.
+bool RawMessageReadsString(int message, int param)
+{
+	for (int i = 0; i < IFaceTable::functionCount; i++)
+	{
+		if (IFaceTable::functions[i].value == message)
+			return IFaceTable::functions[i].paramType[param] == iface_string;
+	}
+
+	for (int i = 0; i < IFaceTable::propertyCount; i++)
+	{
+		const IFaceProperty& prop = IFaceTable::properties[i];
+		if (prop.getter == message)
+			return prop.GetterFunction().paramType[param] == iface_string;
+		else if (prop.setter == message)
+			return prop.SetterFunction().paramType[param] == iface_string;
+	}
+
+	return false;
+}
+
+PyObject* CallBatchItem(ExtensionAPI::Pane pane, PyObject* item, std::vector<BatchFunction>& resolved)
+{
+	Py_ssize_t itemLength = PyTuple_Check(item) ? PyTuple_GET_SIZE(item) : 0;
+	if (itemLength < 1 || itemLength > 3)
+	{
+		PyErr_SetString(PyExc_RuntimeError, "each call should be a tuple of 1 to 3 items.");
+		return NULL;
+	}
+
+	PyObject* target = PyTuple_GET_ITEM(item, 0);
+	PyObject* arg1 = itemLength > 1 ? PyTuple_GET_ITEM(item, 1) : NULL;
+	PyObject* arg2 = itemLength > 2 ? PyTuple_GET_ITEM(item, 2) : NULL;
+	if (PyInt_Check(target))
+	{
+		// a raw message number, its int parameters are sent without checking the iface types
+		// but strings are only accepted where the iface says the message reads a string.
+		sptr_t params[2] = {0, 0};
+		PyObject* args[] = {arg1, arg2};
+		const int message = PyInt_AsLong(target);
+		for (int i = 0; i < 2; i++)
+		{
+			if (args[i] && PyString_Check(args[i]))
+			{
+				if (!RawMessageReadsString(message, i))
+				{
+					PyErr_SetString(PyExc_RuntimeError, "a string can only be passed to a message that reads a string, call it by name instead.");
+					return NULL;
+				}
+
+				params[i] = CastSzToSptr(PyString_AsString(args[i]));
+			}
+			else if (args[i])
+			{
+				params[i] = GetPythonInt(args[i]);
+			}
+		}
+
+		if (PyErr_Occurred())
+		{
+			return NULL;
+		}
+
+		sptr_t result = Host()->Send(pane, message, params[0], params[1]);
+		return Py_BuildValue("i", (int)result);
+	}
+
+	const char* functionName = PyString_Check(target) ? PyString_AsString(target) : NULL;
+	if (!functionName)
+	{
+		PyErr_SetString(PyExc_RuntimeError, "expected function name or message number.");
+		return NULL;
+	}
+
+	// batches usually repeat a few names, so a short linear search is enough
+	const BatchFunction* found = NULL;
+	for (size_t i = 0; i < resolved.size() && !found; i++)
+	{
+		if (resolved[i].name == functionName)
+			found = &resolved[i];
+	}
+
+	if (!found)
+	{
+		BatchFunction function;
+		function.name = functionName;
+		function.functionInfo = SearchForFunction(functionName, function.nameFound);
+		if (PyErr_Occurred())
+		{
+			return NULL;
+		}
+		else if (!function.functionInfo.name)
+		{
+			PyErr_SetString(PyExc_RuntimeError, "Function or property not found");
+			return NULL;
+		}
+
+		resolved.push_back(function);
+		found = &resolved.back();
+	}
+
+	return CallPaneFunction(pane, found->functionInfo, found->nameFound.c_str(), arg1, arg2);
+}
+
+PyObject* pyfun_pane_SendScintillaBatch(PyObject*, PyObject* args)
+{
+	int nPane = -1;
+	ExtensionAPI::Pane pane;
+	PyObject* calls = NULL;
+	if (!PyArg_ParseTuple(args, "iO", &nPane, &calls) ||
+		!GetPaneFromInt(nPane, &pane))
+	{
+		return NULL;
+	}
+
+	// a packed array such as array.array('i') holds (message, wParam, lParam) triples.
+	// there are no per-call results, so None is returned.
+	const void* packed = NULL;
+	Py_ssize_t packedLength = 0;
+	bool isPacked = !PyString_Check(calls) && PyObject_CheckReadBuffer(calls);
+	if (isPacked)
+	{
+		if (PyObject_AsReadBuffer(calls, &packed, &packedLength) != 0)
+		{
+			return NULL;
+		}
+		else if (packedLength % (3 * sizeof(int)) != 0)
+		{
+			PyErr_SetString(PyExc_RuntimeError, "packed calls should be an array of ints, 3 per call.");
+			return NULL;
+		}
+	}
+
+	PyObject* sequence = isPacked ? NULL : PySequence_Fast(calls, "expected a list of calls or a packed array.");
+	if (!isPacked && !sequence)
+	{
+		return NULL;
+	}
+
+	// run every call in one undo group. the pane is repainted once, after control
+	// returns to the event loop, however many calls invalidate it.
+	Host()->Send(pane, SCI_BEGINUNDOACTION, 0, 0);
+	PyObject* results = NULL;
+	if (isPacked)
+	{
+		const int* values = static_cast<const int*>(packed);
+		const Py_ssize_t count = packedLength / sizeof(int);
+		for (Py_ssize_t i = 0; i < count; i += 3)
+		{
+			Host()->Send(pane, values[i], values[i + 1], values[i + 2]);
+		}
+
+		results = IncrefAndReturnNone();
+	}
+	else
+	{
+		const Py_ssize_t count = PySequence_Fast_GET_SIZE(sequence);
+		std::vector<BatchFunction> resolved;
+		results = PyList_New(count);
+		for (Py_ssize_t i = 0; results && i < count; i++)
+		{
+			PyObject* result = CallBatchItem(pane, PySequence_Fast_GET_ITEM(sequence, i), resolved);
+			if (!result)
+			{
+				// calls before this one have been made and are left in place
+				Py_CLEAR(results);
+				break;
+			}
+
+			PyList_SET_ITEM(results, i, result);
+		}
+
+		Py_DECREF(sequence);
+	}
+
+	Host()->Send(pane, SCI_ENDUNDOACTION, 0, 0);
+	return results;
+}
+
 PyObject* pyfun_app_GetConstant(PyObject*, PyObject* args)
 {
 	const char* propName = NULL; // we don't own this.
@@ -1316,8 +2583,94 @@ PyObject* pyfun_app_GetConstant(PyObject*, PyObject* args)
 	return pyValueOut;
 }
 
+PyObject* pyfun_app_SubmitTask(PyObject*, PyObject* args)
+{
+	PyObject *function = NULL, *functionArgs = NULL, *callback = NULL;
+	double timeout = 0;
+	if (!PyArg_ParseTuple(args, "OO!O|d", &function, &PyTuple_Type, &functionArgs, &callback, &timeout) ||
+		!RequireMainThread())
+	{
+		return NULL;
+	}
+	else if (!PyCallable_Check(function) || (callback != Py_None && !PyCallable_Check(callback)))
+	{
+		PyErr_SetString(PyExc_RuntimeError, "expected a function and a callback function or None.");
+		return NULL;
+	}
+	
+	return PyInt_FromLong(pythonTaskPool.Submit(function, functionArgs, callback, timeout));
+}
+
+PyObject* pyfun_app_CancelTask(PyObject*, PyObject* args)
+{
+	int id = 0;
+	if (!PyArg_ParseTuple(args, "i", &id) || !RequireMainThread())
+	{
+		return NULL;
+	}
+	
+	return PyBool_FromLong(pythonTaskPool.Cancel(id));
+}
+
+PyObject* pyfun_app_RecordTiming(PyObject*, PyObject* args)
+{
+	const char* name = NULL; // we don't own this.
+	double seconds = 0;
+	if (!PyArg_ParseTuple(args, "sd", &name, &seconds) || !name || !RequireMainThread())
+	{
+		return NULL;
+	}
+	
+	// returns whether the handler should now be disabled.
+	CallbackTiming* timing = NULL;
+	bool disable = false;
+	if (callbackProfiler.Record(name, seconds, &timing))
+	{
+		if (timing->overBudget == 1)
+		{
+			callbackProfiler.ReportOverBudget(name, seconds);
+		}
+		
+		disable = callbackProfiler.ShouldDisable(*timing);
+		if (disable)
+		{
+			trace(">Python: disabled ", name);
+			trace(", it went over budget ", timing->overBudget);
+			trace(" times.\n");
+		}
+	}
+	
+	return PyBool_FromLong(disable);
+}
+
+PyObject* pyfun_app_GetCallbackTimings(PyObject*, PyObject* args)
+{
+	if (!PyArg_ParseTuple(args, "") || !RequireMainThread())
+	{
+		return NULL;
+	}
+	
+	return callbackProfiler.GetTimings();
+}
+
+PyObject* pyfun_app_ResetCallbackTimings(PyObject*, PyObject* args)
+{
+	if (!PyArg_ParseTuple(args, "") || !RequireMainThread())
+	{
+		return NULL;
+	}
+	
+	callbackProfiler.Reset();
+	return IncrefAndReturnNone();
+}
+
 PyObject* pyfun_app_EnableNotification(PyObject*, PyObject* args)
 {
+	if (!RequireMainThread())
+	{
+		return NULL;
+	}
+	
 	const char* eventName = NULL; // we don't own this.
 	int value = 0;
 	if (!PyArg_ParseTuple(args, "si", &eventName, &value) || !eventName)
@@ -1331,6 +2684,11 @@ PyObject* pyfun_app_EnableNotification(PyObject*, PyObject* args)
 
 PyObject* pyfun_app_SciteCommand(PyObject*, PyObject* args)
 {
+	if (!RequireMainThread())
+	{
+		return NULL;
+	}
+	
 	const char* propName = NULL; // we don't own this.
 	if (!PyArg_ParseTuple(args, "s", &propName) || !propName)
 	{
@@ -1351,6 +2709,11 @@ PyObject* pyfun_app_SciteCommand(PyObject*, PyObject* args)
 
 PyObject* pyfun_app_UpdateStatusBar(PyObject*, PyObject* args)
 {
+	if (!RequireMainThread())
+	{
+		return NULL;
+	}
+	
 	PyObject * pyObjBoolUpdate = NULL;
 	if (!PyArg_ParseTuple(args, "O", &pyObjBoolUpdate))
 	{
@@ -1364,6 +2727,11 @@ PyObject* pyfun_app_UpdateStatusBar(PyObject*, PyObject* args)
 
 PyObject* pyfun_app_UserStripShow(PyObject*, PyObject* args)
 {
+	if (!RequireMainThread())
+	{
+		return NULL;
+	}
+	
 	const char* s = NULL; // we don't own this.
 	if (!PyArg_ParseTuple(args, "s", &s) || !s)
 	{
@@ -1376,6 +2744,11 @@ PyObject* pyfun_app_UserStripShow(PyObject*, PyObject* args)
 
 PyObject* pyfun_app_UserStripSet(PyObject*, PyObject* args)
 {
+	if (!RequireMainThread())
+	{
+		return NULL;
+	}
+	
 	int control = 0;
 	const char* value = NULL; // we don't own this.
 	if (!PyArg_ParseTuple(args, "is", &control, &value) || !value)
@@ -1389,6 +2762,11 @@ PyObject* pyfun_app_UserStripSet(PyObject*, PyObject* args)
 
 PyObject* pyfun_app_UserStripSetList(PyObject*, PyObject* args)
 {
+	if (!RequireMainThread())
+	{
+		return NULL;
+	}
+	
 	int control = 0;
 	const char* value = NULL; // we don't own this.
 	if (!PyArg_ParseTuple(args, "is", &control, &value) || !value)
@@ -1402,6 +2780,11 @@ PyObject* pyfun_app_UserStripSetList(PyObject*, PyObject* args)
 
 PyObject* pyfun_app_UserStripGetValue(PyObject*, PyObject* args)
 {
+	if (!RequireMainThread())
+	{
+		return NULL;
+	}
+	
 	int control = 0;
 	if (!PyArg_ParseTuple(args, "i", &control))
 	{
@@ -1654,6 +3037,11 @@ void onChangeCurrentFile()
 
 PyObject* pyfun_app_GetNextOrPreviousLocation(PyObject*, PyObject* args)
 {
+	if (!RequireMainThread())
+	{
+		return NULL;
+	}
+	
 	const std::string* file = NULL;
 	int line = 0;
 	int isNext = 0;
@@ -1684,6 +3072,11 @@ static PyMethodDef methodsExportedToPython[] =
 	{"app_UnsetProperty", pyfun_UnsetProperty, METH_VARARGS, "Unset SciTE Property"},
 	{"app_GetConstant", pyfun_app_GetConstant, METH_VARARGS, ""},
 	{"app_EnableNotification", pyfun_app_EnableNotification, METH_VARARGS, ""},
+	{"app_RecordTiming", pyfun_app_RecordTiming, METH_VARARGS, ""},
+	{"app_GetCallbackTimings", pyfun_app_GetCallbackTimings, METH_VARARGS, ""},
+	{"app_ResetCallbackTimings", pyfun_app_ResetCallbackTimings, METH_VARARGS, ""},
+	{"app_SubmitTask", pyfun_app_SubmitTask, METH_VARARGS, ""},
+	{"app_CancelTask", pyfun_app_CancelTask, METH_VARARGS, ""},
 	{"app_UpdateStatusBar", pyfun_app_UpdateStatusBar, METH_VARARGS, ""},
 	{"app_UserStripShow", pyfun_app_UserStripShow, METH_VARARGS, ""},
 	{"app_UserStripSet", pyfun_app_UserStripSet, METH_VARARGS, ""},
@@ -1696,7 +3089,10 @@ static PyMethodDef methodsExportedToPython[] =
 	{"pane_Remove", pyfun_pane_Remove, METH_VARARGS, ""},
 	{"pane_Textrange", pyfun_pane_TextRange, METH_VARARGS, ""},
 	{"pane_FindText", pyfun_pane_FindText, METH_VARARGS, ""},
+	{"pane_GetBuffer", pyfun_pane_GetBuffer, METH_VARARGS, ""},
 	{"pane_SendScintilla", pyfun_pane_SendScintilla, METH_VARARGS, ""},
+	{"pane_SendScintillaBatch", pyfun_pane_SendScintillaBatch, METH_VARARGS, ""},
+	{"pane_GetMessage", pyfun_pane_GetMessage, METH_VARARGS, ""},
 	{NULL, NULL, 0, NULL}
 };
 
@@ -1733,9 +3129,26 @@ void PythonExtension::SetupPythonNamespace()
 	
 	// initialize without signal handling
 	Py_InitializeEx(0);
+	PyEval_InitThreads();
 	
 	// add our C module
-	Py_InitModule("SciTEModule", methodsExportedToPython);
+	PyObject* sciteModule = Py_InitModule("SciTEModule", methodsExportedToPython);
+	taskCancelledError = PyErr_NewException((char*) "SciTEModule.TaskCancelled", NULL, NULL);
+	
+	// the module steals a reference, we keep our own
+	Py_XINCREF(taskCancelledError);
+	if (!sciteModule || !taskCancelledError ||
+		PyModule_AddObject(sciteModule, "TaskCancelled", taskCancelledError) != 0)
+	{
+		trace_error("Python extension could not create the TaskCancelled exception.");
+		PyErr_Print();
+	}
+	
+	if (PyType_Ready(&paneBufferType) < 0)
+	{
+		trace_error("Python extension could not create the PaneBuffer type.");
+		PyErr_Print();
+	}
 	
 	// add to system path. 'sys' is built-in, no worry of importing the wrong sys
 	std::string pathToImport = "import sys; sys.path.insert(0, \"";
@@ -1766,7 +3179,11 @@ void PythonExtension::SetupPythonNamespace()
 
 bool GetPaneFromInt(int nPane, ExtensionAPI::Pane* outPane)
 {
-	if (nPane == 0)
+	if (!RequireMainThread())
+	{
+		return false;
+	}
+	else if (nPane == 0)
 	{
 		*outPane = ExtensionAPI::paneEditor;
 		return true;
@@ -1783,6 +3200,19 @@ bool GetPaneFromInt(int nPane, ExtensionAPI::Pane* outPane)
 	}
 }
 
+bool RequireMainThread()
+{
+	if (IsMainThread())
+	{
+		return true;
+	}
+	else
+	{
+		PyErr_SetString(PyExc_RuntimeError, "SciTE can only be used from the main thread, not from a background task.");
+		return false;
+	}
+}
+
 void trace(const char* text1, const char* text2)
 {
 	if (Host())
@@ -20,6 +20,8 @@ enum EventNumber
 	EventNumber_OnKey,
 	EventNumber_OnUserStrip,
 	EventNumber_OnFileChange,
+	EventNumber_OnCharBatch,
+	EventNumber_OnKeyBatch,
 	EventNumber_LEN
 };
 
@@ -58,6 +60,7 @@ public:
 	virtual bool OnClose(const char*);
 	virtual bool OnUserStrip(int, int);
 	virtual bool NeedsOnClose();
+	virtual bool OnIdle();
 	bool OnFileChange();
 
 	static const IFaceConstant* const constantsTable;
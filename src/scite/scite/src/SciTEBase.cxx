@@ -113,6 +113,7 @@ bool &Searcher::FlagFromCmd(int cmd) {
 
 SciTEBase::SciTEBase(Extension *ext) : apis(true), extender(ext) {
 	needIdle = false;
+	grepIndexer = 0;
 	codePage = 0;
 	characterSet = 0;
 	language = "java";
@@ -214,6 +215,16 @@ SciTEBase::SciTEBase(Extension *ext) : apis(true), extender(ext) {
 
 SciTEBase::~SciTEBase() {
 	TimerEnd(timerAutoSave);
+	Worker *indexer = 0;
+	{
+		Lock lock(jobQueue.mutex);
+		indexer = grepIndexer;
+		grepIndexer = 0;
+	}
+	if (indexer) {
+		indexer->Cancel();
+		delete indexer;
+	}
 	if (extender)
 		extender->Finalise();
 	popup.Destroy();
@@ -230,8 +241,25 @@ void SciTEBase::WorkerCommand(int cmd, Worker *pWorker) {
 		UpdateProgress(pWorker);
 		break;
 	case WORK_FILEPROGRESS:
+		TextReadProgress(static_cast<FileWorker *>(pWorker));
  		UpdateProgress(pWorker);
 		break;
+	case WORK_GREPINDEXED: {
+			bool finished = false;
+			{
+				Lock lock(jobQueue.mutex);
+				if (grepIndexer == pWorker) {
+					grepIndexer = 0;
+					finished = true;
+				}
+			}
+			if (finished)
+				delete pWorker;
+		}
+		break;
+	case WORK_EXTENSION:
+		static_cast<ExtensionWorker *>(pWorker)->FinishOnMainThread();
+		break;
 	}
 }
 
@@ -1196,6 +1224,28 @@ int SciTEBase::DoReplaceAll(bool inSelection) {
 
 	const std::string replaceTarget = UnSlashAsNeeded(EncodeString(replaceWhat), unSlash, regExp);
 	wEditor.Call(SCI_SETSEARCHFLAGS, SearchFlags(regExp));
+
+	// Replace inside Scintilla unless matches need checking one at a time or the strings contain NULs
+	const bool startOfLine = (findTarget.length() == 1) && regExp && (findTarget[0] == '^');
+	if (!(inSelection && countSelections > 1) && !findInStyle && !startOfLine &&
+		(findTarget.find('\0') == std::string::npos) && (replaceTarget.find('\0') == std::string::npos)) {
+		const int lengthBefore = LengthDocument();
+		wEditor.Call(SCI_SETTARGETSTART, startPosition);
+		wEditor.Call(SCI_SETTARGETEND, endPosition);
+		const int replacements = wEditor.Call(SCI_REPLACEALLINTARGET,
+			reinterpret_cast<uptr_t>(findTarget.c_str()), reinterpret_cast<sptr_t>(replaceTarget.c_str()));
+		if (replacements <= 0) {
+			return 0;
+		}
+		if (inSelection) {
+			SetSelection(startPosition, endPosition + LengthDocument() - lengthBefore);
+		} else {
+			const int lastMatch = wEditor.Call(SCI_GETTARGETEND);
+			SetSelection(lastMatch, lastMatch);
+		}
+		return replacements;
+	}
+
 	int posFind = FindInTarget(findTarget, startPosition, endPosition);
 	if ((findTarget.length() == 1) && regExp && (findTarget[0] == '^')) {
 		// Special case for replace all start of line so it hits the first line
@@ -4290,6 +4340,9 @@ void SciTEBase::OnIdle() {
 		matchMarker.Continue();
 		return;
 	}
+	if (extender && extender->OnIdle()) {
+		return;
+	}
 	SetIdler(false);
 }
 
@@ -4842,6 +4895,10 @@ void SciTEBase::DoMenuCommand(int cmdID) {
 	MenuCommand(cmdID, 0);
 }
 
+void SciTEBase::RequestIdle() {
+	SetIdler(true);
+}
+
 void SciTEBase::LoadSearchState() {
 	if (enableSaveSearchesAcrossInstances) {
 		// don't read a new search state immediately, so that we don't
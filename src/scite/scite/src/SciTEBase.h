@@ -99,6 +99,8 @@ public:
 };
 
 struct FileWorker;
+class GrepEngine;
+class GrepIndex;
 
 class Buffer : public RecentFile {
 public:
@@ -107,6 +109,8 @@ public:
 	bool isReadOnly;
 	bool failedSave;
 	bool useMonoFont;
+	bool mapped;	///< Document may still read its text from the mapped file
+	long mappedSize;	///< Length of the file when it was mapped
 	enum { empty, reading, readAll, open } lifeState;
 	UniMode unicodeMode;
 	time_t fileModTime;
@@ -120,7 +124,7 @@ public:
 	PropSetFile props;
 	enum FutureDo { fdNone=0, fdFinishSave=1 } futureDo;
 	Buffer() :
-			RecentFile(), doc(0), isDirty(false), isReadOnly(false), failedSave(false), useMonoFont(false), lifeState(empty),
+			RecentFile(), doc(0), isDirty(false), isReadOnly(false), failedSave(false), useMonoFont(false), mapped(false), mappedSize(0), lifeState(empty),
 			unicodeMode(uni8Bit), fileModTime(0), fileModLastAsk(0), documentModTime(0),
 			findMarks(fmNone), pFileWorker(0), futureDo(fdNone) {}
 
@@ -130,6 +134,8 @@ public:
 		isReadOnly = false;
 		failedSave = false;
 		useMonoFont = false;
+		mapped = false;
+		mappedSize = 0;
 		lifeState = empty;
 		unicodeMode = uni8Bit;
 		fileModTime = 0;
@@ -528,6 +534,8 @@ protected:
 	int scrollOutput;
 	bool returnOutputToCommand;
 	JobQueue jobQueue;
+	/// Background update of a find in files index, protected by jobQueue.mutex.
+	Worker *grepIndexer;
 
 	bool enableSaveSearchesAcrossInstances;
 	BasicSearcherState previouslySavedSearchState;
@@ -637,6 +645,7 @@ protected:
 	void DiscoverIndentSetting();
 	std::string DiscoverLanguage();
 	void OpenCurrentFile(long fileSize, bool suppressMessage, bool asynchronous);
+	bool OpenCurrentFileMapped(int documentOptions);
 	virtual void OpenUriList(const char *) {}
 	virtual bool OpenDialog(FilePath directory, const GUI::gui_char *filesFilter) = 0;
 	virtual bool SaveAsDialog() = 0;
@@ -652,6 +661,8 @@ protected:
 	    ofSynchronous = 16	// Force synchronous read
 	};
 	void TextRead(FileWorker *pFileLoader);
+	void TextReadProgress(FileWorker *pFileLoader);
+	void ShowPendingText();
 	void TextWritten(FileWorker *pFileStorer);
 	void UpdateProgress(Worker *pWorker);
 	void PerformDeferredTasks();
@@ -961,7 +972,10 @@ protected:
 	};
 	GrepFlags GrepFlagsFromString(const GUI::gui_string &spec);
 	virtual bool GrepIntoDirectory(const FilePath &directory);
-	void GrepRecursive(GrepFlags gf, FilePath baseDir, const char *searchString, const GUI::gui_char *fileTypes);
+	void GrepOutput(GrepFlags gf, const std::string &os);
+	void GrepRecursive(GrepEngine &engine, GrepIndex *index, GrepFlags gf, FilePath baseDir, const GUI::gui_char *fileTypes);
+	FilePath GrepIndexPath(const FilePath &root);
+	void StartGrepIndexer(const FilePath &root, const FilePath &indexPath);
 	void InternalGrep(GrepFlags gf, const GUI::gui_char *directory, const GUI::gui_char *files,
 			  const char *search, sptr_t &originalEnd);
 	void EnumProperties(const char *action);
@@ -982,6 +996,7 @@ protected:
 	void ShutDown();
 	void Perform(const char *actions);
 	void DoMenuCommand(int cmdID);
+	void RequestIdle();
 
 	// Valid CurrentWord characters
 	bool iswordcharforsel(char ch);
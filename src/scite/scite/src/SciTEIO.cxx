@@ -15,6 +15,7 @@
 
 #include <string>
 #include <vector>
+#include <deque>
 #include <set>
 #include <map>
 #include <algorithm>
@@ -39,12 +40,10 @@
 #include "FileWorker.h"
 #include "MatchMarker.h"
 #include "SciTEBase.h"
+#include "GrepWorker.h"
+#include "GrepIndex.h"
 #include "Utf8_16.h"
 
-#if CXX11_REGEX_ENABLED
-#include <regex>
-#endif
-
 #if defined(GTK)
 const GUI::gui_char propUserFileName[] = GUI_TEXT(".SciTE_with_python_user.properties");
 #elif defined(__APPLE__)
@@ -56,6 +55,44 @@ const GUI::gui_char propUserFileName[] = GUI_TEXT("SciTE_with_python_user.proper
 const GUI::gui_char propGlobalFileName[] = GUI_TEXT("SciTEGlobal.properties");
 const GUI::gui_char propAbbrevFileName[] = GUI_TEXT("abbrev.properties");
 
+#ifdef SCI_NAMESPACE
+using Scintilla::IMappedText;
+#endif
+
+/// Text of a file that a Scintilla document reads from a memory mapping.
+/// Other programs may append to the file but the document only sees the length mapped.
+/// On Unix a file cut short under the mapping faults when read so CheckReload watches for that.
+class MappedFileText : public IMappedText {
+	FileContents contents;
+	size_t start;
+public:
+	explicit MappedFileText(const FilePath &fPath) : contents(fPath, true), start(0) {
+	}
+	virtual ~MappedFileText() {
+	}
+	bool Valid() const {
+		return contents.Data() != 0;
+	}
+	const char *Data() const {
+		return contents.Data();
+	}
+	size_t Size() const {
+		return contents.Length();
+	}
+	void SkipStart(size_t skip) {
+		start = skip;
+	}
+	virtual void SCI_METHOD Release() {
+		delete this;
+	}
+	virtual const char * SCI_METHOD Text() {
+		return contents.Data() + start;
+	}
+	virtual Sci_Position SCI_METHOD Length() {
+		return static_cast<Sci_Position>(contents.Length() - start);
+	}
+};
+
 void SciTEBase::SetFileName(FilePath openName, bool fixCase) {
 	if (openName.AsInternal()[0] == '\"') {
 		// openName is surrounded by double quotes
@@ -264,6 +301,20 @@ void SciTEBase::OpenCurrentFile(long fileSize, bool suppressMessage, bool asynch
 	}
 
 	CurrentBuffer()->SetTimeFromFile();
+	CurrentBuffer()->mapped = false;
+
+	// Very large files are stored in chunks when a new document is created for them.
+	const int sizeChunked = props.GetInt("open.chunked.size");
+	const int documentOptions = ((sizeChunked > 0) && (fileSize >= sizeChunked)) ?
+		SC_DOCUMENTOPTION_TEXT_CHUNKED : SC_DOCUMENTOPTION_DEFAULT;
+
+	// Large files are shown directly from a mapping when the load is not being added to the undo history.
+	const int sizeMapped = props.GetInt("open.mapped.size");
+	if ((sizeMapped > 0) && (fileSize >= sizeMapped) && !wEditor.Call(SCI_GETUNDOCOLLECTION) &&
+		OpenCurrentFileMapped(documentOptions)) {
+		fclose(fp);
+		return;
+	}
 
 	wEditor.Call(SCI_BEGINUNDOACTION);	// Group together clear and insert
 	wEditor.Call(SCI_CLEARALL);
@@ -274,14 +325,25 @@ void SciTEBase::OpenCurrentFile(long fileSize, bool suppressMessage, bool asynch
 		wEditor.Call(SCI_STYLESETBACK, STYLE_DEFAULT, 0xEEEEEE);
 		wEditor.Call(SCI_SETREADONLY, 1);
 		assert(CurrentBuffer()->pFileWorker == NULL);
-		ILoader *pdocLoad;
-		try {
-			pdocLoad = reinterpret_cast<ILoader *>(wEditor.CallReturnPointer(SCI_CREATELOADER, fileSize + 1000));
-		} catch (...) {
-			wEditor.Call(SCI_SETSTATUS, 0);
-			return;
+		// A progressive load appends to the visible document as the file is read
+		// instead of switching to a separately loaded document at the end.
+		const int sizeFirstShow = props.GetInt("background.open.progressive");
+		ILoader *pdocLoad = 0;
+		if (sizeFirstShow > 0) {
+			// This document stays in place, so close the group now or every later edit joins it.
+			wEditor.Call(SCI_ENDUNDOACTION);
+			wEditor.Call(SCI_ALLOCATE, fileSize + 1000);
+		} else {
+			try {
+				pdocLoad = reinterpret_cast<ILoader *>(wEditor.CallReturnPointer(SCI_CREATELOADER, fileSize + 1000, documentOptions));
+			} catch (...) {
+				wEditor.Call(SCI_SETSTATUS, 0);
+				return;
+			}
 		}
-		CurrentBuffer()->pFileWorker = new FileLoader(this, pdocLoad, filePath, fileSize, fp);
+		FileLoader *pFileLoader = new FileLoader(this, pdocLoad, filePath, fileSize, fp);
+		pFileLoader->sizeFirstShow = sizeFirstShow;
+		CurrentBuffer()->pFileWorker = pFileLoader;
 		CurrentBuffer()->pFileWorker->sleepTime = props.GetInt("asynchronous.sleep");
 		PerformOnNewThread(CurrentBuffer()->pFileWorker);
 	} else {
@@ -319,6 +381,44 @@ void SciTEBase::OpenCurrentFile(long fileSize, bool suppressMessage, bool asynch
 	}
 }
 
+bool SciTEBase::OpenCurrentFileMapped(int documentOptions) {
+	MappedFileText *mappedText = new MappedFileText(filePath);
+	const unsigned char *data = reinterpret_cast<const unsigned char *>(mappedText->Data());
+	const size_t size = mappedText->Size();
+	UniMode unicodeMode = uni8Bit;
+	bool mappable = mappedText->Valid() && (size < 0x7fffffff);
+	if (mappable && (size >= 2) &&
+		(((data[0] == 0xFF) && (data[1] == 0xFE)) || ((data[0] == 0xFE) && (data[1] == 0xFF)))) {
+		// UTF-16 has to be converted so can not be shown from the mapping
+		mappable = false;
+	} else if (mappable && (size >= 3) && (data[0] == 0xEF) && (data[1] == 0xBB) && (data[2] == 0xBF)) {
+		unicodeMode = uniUTF8;
+		mappedText->SkipStart(3);
+	} else if (mappable) {
+		unicodeMode = CodingCookieValue(mappedText->Data(), std::min<size_t>(size, blockSize));
+	}
+	if (!mappable) {
+		delete mappedText;
+		return false;
+	}
+	sptr_t pdocMapped = 0;
+	try {
+		// The document owns mappedText from here
+		pdocMapped = wEditor.CallReturnPointer(SCI_CREATEMAPPEDDOCUMENT, documentOptions,
+			reinterpret_cast<sptr_t>(static_cast<IMappedText *>(mappedText)));
+	} catch (...) {
+		wEditor.Call(SCI_SETSTATUS, 0);
+		return false;
+	}
+	SwitchDocumentAt(buffers.Current(), pdocMapped);
+	CurrentBuffer()->mapped = true;
+	CurrentBuffer()->mappedSize = static_cast<long>(size);
+	CurrentBuffer()->unicodeMode = unicodeMode;
+	CurrentBuffer()->lifeState = Buffer::readAll;
+	CompleteOpen(ocCompleteCurrent);
+	return true;
+}
+
 void SciTEBase::TextRead(FileWorker *pFileWorker) {
 	FileLoader *pFileLoader = static_cast<FileLoader *>(pFileWorker);
 	int iBuffer = buffers.GetDocumentByWorker(pFileLoader);
@@ -332,21 +432,71 @@ void SciTEBase::TextRead(FileWorker *pFileWorker) {
 			// Should refuse to save when failure occurs
 			buffers.buffers[iBuffer].lifeState = Buffer::empty;
 		}
-		// Switch documents
-		sptr_t pdocLoading = reinterpret_cast<sptr_t>(pFileLoader->pLoader->ConvertToDocument());
-		pFileLoader->pLoader = 0;
-		SwitchDocumentAt(iBuffer, pdocLoading);
+		const bool progressive = pFileLoader->Progressive();
+		if (progressive) {
+			// Text is already in the document apart from the last piece read.
+			// A buffer that is not current catches up when switched to.
+			if (iBuffer == buffers.Current())
+				ShowPendingText();
+		} else {
+			// Switch documents
+			sptr_t pdocLoading = reinterpret_cast<sptr_t>(pFileLoader->pLoader->ConvertToDocument());
+			pFileLoader->pLoader = 0;
+			SwitchDocumentAt(iBuffer, pdocLoading);
+		}
 		if (iBuffer == buffers.Current()) {
+			// Keep the user's place if they moved while the file was loading.
+			const int anchor = wEditor.Call(SCI_GETANCHOR);
+			const int caret = wEditor.Call(SCI_GETCURRENTPOS);
+			const int firstVisible = wEditor.Call(SCI_GETFIRSTVISIBLELINE);
 			CompleteOpen(ocCompleteCurrent);
 			if (extender)
 				extender->OnOpen(buffers.buffers[iBuffer].AsUTF8().c_str());
 			RestoreState(buffers.buffers[iBuffer], true);
 			DisplayAround(buffers.buffers[iBuffer]);
 			wEditor.Call(SCI_SCROLLCARET);
+			if (progressive && (anchor || caret || firstVisible)) {
+				wEditor.Call(SCI_SETSEL, anchor, caret);
+				wEditor.Call(SCI_SETFIRSTVISIBLELINE, firstVisible);
+			}
 		}
 	}
 }
 
+void SciTEBase::TextReadProgress(FileWorker *pFileWorker) {
+	int iBuffer = buffers.GetDocumentByWorker(pFileWorker);
+	// Other buffers are updated when switched to
+	if ((iBuffer >= 0) && (iBuffer == buffers.Current()))
+		ShowPendingText();
+}
+
+void SciTEBase::ShowPendingText() {
+	FileWorker *pFileWorker = CurrentBuffer()->pFileWorker;
+	if (!pFileWorker || !pFileWorker->IsLoading())
+		return;
+	FileLoader *pFileLoader = static_cast<FileLoader *>(pFileWorker);
+	if (!pFileLoader->Progressive())
+		return;
+	std::string text;
+	const UniMode unicodeModeStart = pFileLoader->TakePending(text);
+	if (text.empty())
+		return;
+	if ((wEditor.Call(SCI_GETLENGTH) == 0) && (unicodeModeStart != uni8Bit)) {
+		// Show Unicode files correctly before CompleteOpen sets the code page
+		wEditor.Call(SCI_SETCODEPAGE, SC_CP_UTF8);
+	}
+	// Appending extends the line index while styling follows lazily as lines are shown.
+	// Only a document that held just the file's text is marked unmodified afterwards.
+	const bool unmodified = !wEditor.Call(SCI_GETMODIFY);
+	wEditor.Call(SCI_SETREADONLY, 0);
+	wEditor.CallString(SCI_APPENDTEXT, text.length(), text.c_str());
+	wEditor.Call(SCI_SETREADONLY, 1);
+	if (unmodified)
+		wEditor.Call(SCI_SETSAVEPOINT);
+	if (lineNumbers && lineNumbersExpand)
+		SetLineNumberWidth();
+}
+
 void SciTEBase::PerformDeferredTasks() {
 	if (buffers.buffers[buffers.Current()].futureDo & Buffer::fdFinishSave) {
 		wEditor.Call(SCI_SETSAVEPOINT);
@@ -597,7 +747,13 @@ bool SciTEBase::Open(FilePath file, OpenFlags of) {
 			wEditor.Call(SCI_EMPTYUNDOBUFFER);
 		}
 		CurrentBuffer()->isReadOnly = props.GetInt("read.only");
-		wEditor.Call(SCI_SETREADONLY, CurrentBuffer()->isReadOnly);
+		// A progressive load shows the file in this document so it stays read-only
+		// until CompleteOpen, otherwise typing would be mixed into the file's text.
+		const FileWorker *pFileWorker = CurrentBuffer()->pFileWorker;
+		const bool loadingProgressively = pFileWorker && pFileWorker->IsLoading() &&
+			static_cast<const FileLoader *>(pFileWorker)->Progressive();
+		if (!loadingProgressively)
+			wEditor.Call(SCI_SETREADONLY, CurrentBuffer()->isReadOnly);
 	}
 	RemoveFileFromStack(filePath);
 	DeleteFileStackMenu();
@@ -742,6 +898,21 @@ void SciTEBase::Revert() {
 }
 
 void SciTEBase::CheckReload() {
+	if (CurrentBuffer()->mapped) {
+		// Reading a mapped file that has been cut short faults, so a document that is still
+		// the unedited mapping is reloaded without waiting to ask. Edits copy the text.
+		long long modified = 0;
+		long long sizeFile = 0;
+		if (GrepFileStatus(filePath, modified, sizeFile) && (sizeFile < CurrentBuffer()->mappedSize)) {
+			CurrentBuffer()->mapped = false;
+			if (!CurrentBuffer()->isDirty) {
+				RecentFile rf = GetFilePosition();
+				Open(filePath, static_cast<OpenFlags>(ofQuiet | ofForceLoad));
+				DisplayAround(rf);
+				return;
+			}
+		}
+	}
 	if (props.GetInt("load.on.activate")) {
 		// Make a copy of fullPath as otherwise it gets aliased in Open
 		time_t newModTime = filePath.ModifiedTime();
@@ -966,6 +1137,11 @@ bool SciTEBase::SaveBuffer(FilePath saveName, SaveFlags sf) {
 
 	if (!retVal) {
 
+		if (CurrentBuffer()->mapped) {
+			// Copy a document shown from a mapped file into memory so the file can be written
+			wEditor.CallReturnPointer(SCI_GETCHARACTERPOINTER);
+			CurrentBuffer()->mapped = false;
+		}
 		FILE *fp = saveName.Open(fileWrite);
 		if (fp) {
 			int lengthDoc = LengthDocument();
@@ -1212,199 +1388,6 @@ void SciTEBase::OpenFilesFromStdin() {
 		Open(GUI_TEXT(""));
 }
 
-class BufferedFile {
-	FILE *fp;
-	bool readAll;
-	bool exhausted;
-	enum {bufLen = 64 * 1024};
-	char buffer[bufLen];
-	size_t pos;
-	size_t valid;
-	void EnsureData() {
-		if (pos >= valid) {
-			if (readAll || !fp) {
-				exhausted = true;
-			} else {
-				valid = fread(buffer, 1, bufLen, fp);
-				if (valid < bufLen) {
-					readAll = true;
-				}
-				pos = 0;
-			}
-		}
-	}
-public:
-	explicit BufferedFile(FilePath fPath) {
-		fp = fPath.Open(fileRead);
-		readAll = false;
-		exhausted = fp == NULL;
-		buffer[0] = 0;
-		pos = 0;
-		valid = 0;
-	}
-	~BufferedFile() {
-		if (fp) {
-			fclose(fp);
-		}
-		fp = NULL;
-	}
-	bool Exhausted() const {
-		return exhausted;
-	}
-	int NextByte() {
-		EnsureData();
-		if (pos >= valid) {
-			return 0;
-		}
-		return buffer[pos++];
-	}
-	bool BufferContainsNull() {
-		EnsureData();
-		for (size_t i = 0;i < valid;i++) {
-			if (buffer[i] == '\0')
-				return true;
-		}
-		return false;
-	}
-};
-
-class FileReader {
-	BufferedFile *bf;
-	int lineNum;
-	bool lastWasCR;
-	std::string lineToCompare;
-	std::string lineToShow;
-	bool caseSensitive;
-	// Deleted so FileReader objects can not be copied
-	FileReader(const FileReader &);
-public:
-
-	FileReader(FilePath fPath, bool caseSensitive_) {
-		bf = new BufferedFile(fPath);
-		lineNum = 0;
-		lastWasCR = false;
-		caseSensitive = caseSensitive_;
-	}
-	~FileReader() {
-		delete bf;
-		bf = NULL;
-	}
-	const char *Next() {
-		if (bf->Exhausted()) {
-			return NULL;
-		}
-		lineToShow.clear();
-		while (!bf->Exhausted()) {
-			int ch = bf->NextByte();
-			if (lastWasCR && ch == '\n' && lineToShow.empty()) {
-				lastWasCR = false;
-			} else if (ch == '\r' || ch == '\n') {
-				lastWasCR = ch == '\r';
-				break;
-			} else {
-				lineToShow.push_back(static_cast<char>(ch));
-			}
-		}
-		lineNum++;
-		lineToCompare = lineToShow;
-		if (!caseSensitive) {
-			for (unsigned int j = 0; j < lineToCompare.length(); j++) {
-				if (lineToCompare[j] >= 'A' && lineToCompare[j] <= 'Z') {
-					lineToCompare[j] = static_cast<char>(lineToCompare[j] - 'A' + 'a');
-				}
-			}
-		}
-		return lineToCompare.c_str();
-	}
-	int LineNumber() const {
-		return lineNum;
-	}
-	const char *Original() const {
-		return lineToShow.c_str();
-	}
-	bool BufferContainsNull() {
-		return bf->BufferContainsNull();
-	}
-};
-
-static bool IsWordCharacter(int ch) {
-	return (ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z')  || (ch >= '0' && ch <= '9')  || (ch == '_');
-}
-
-#if CXX11_REGEX_ENABLED
-
-class RegexpSearch
-{
-	bool use;
-	bool valid;
-	stdregex::regex regexObject;
-
-public:
-	RegexpSearch() : use(false), valid(false) {}
-
-	bool Init(const char *searchString, bool matchCase, bool wholeWord) {
-		stdregex::regex::flag_type flagsRe = stdregex::regex::ECMAScript;
-		std::string sRegex = searchString;
-		use = true;
-
-		if (!searchString || !searchString[0]) {
-			return false;
-		}
-
-		if (!matchCase) {
-			flagsRe |= stdregex::regex::icase;
-		}
-
-		if (wholeWord) {
-			sRegex = std::string("\\b") + sRegex + "\\b";
-		}
-
-		try {
-			regexObject.assign(sRegex, flagsRe);
-		} catch (stdregex::regex_error &) {
-			// Failed to create regular expression
-			return false;
-		}
-
-		valid = true;
-		return true;
-	}
-
-	const char *Search(const char *line) { 
-		try {
-			if (valid && stdregex::regex_search(line, regexObject)) {
-				return line;
-			}
-		} catch (stdregex::regex_error &) {
-			return NULL;
-		}
-
-		return NULL;
-	}
-
-	bool Use() {
-		return use;
-	}
-
-	bool Enabled() { 
-		return true;
-	}
-};
-
-#else
-
-class RegexpSearch
-{
-public:
-	RegexpSearch::RegexpSearch() {}
-	bool Init(const char *, bool, bool) { return false; }
-	const char *Search(const char *) { return NULL; }
-	bool Use() { return false; }
-	bool Enabled() { return false; }
-};
-
-#endif
-
 SciTEBase::GrepFlags SciTEBase::GrepFlagsFromString(const GUI::gui_string &spec)
 {
 	// [w~][c~][d~][b~][r~]
@@ -1432,77 +1415,75 @@ bool SciTEBase::GrepIntoDirectory(const FilePath &directory) {
     return sDirectory[0] != '.';
 }
 
-void SciTEBase::GrepRecursive(GrepFlags gf, FilePath baseDir, const char *searchString, const GUI::gui_char *fileTypes) {
-	FilePathSet directories;
-	FilePathSet files;
-
-	bool flagsRegexp = gf & grepRegexp;
-	bool flagsMatchCase = gf & grepMatchCase;
-	bool flagsWholeWord = gf & grepWholeWord;
-	RegexpSearch regexpSearch;
-	if (flagsRegexp && regexpSearch.Enabled() && props.GetInt("find.in.files.enable.regexp"))
-	{
-		if (!regexpSearch.Init(searchString, flagsMatchCase, flagsWholeWord)) {
-			return;
+void SciTEBase::GrepOutput(GrepFlags gf, const std::string &os) {
+	if (os.length()) {
+		if (gf & grepStdOut) {
+			fwrite(os.c_str(), os.length(), 1, stdout);
+		} else {
+			OutputAppendStringSynchronised(os.c_str());
 		}
 	}
+}
 
+void SciTEBase::GrepRecursive(GrepEngine &engine, GrepIndex *index, GrepFlags gf, FilePath baseDir, const GUI::gui_char *fileTypes) {
+	FilePathSet directories;
+	FilePathSet files;
 	baseDir.List(directories, files);
-	size_t searchLength = strlen(searchString);
-	std::string os;
 	for (size_t i = 0; i < files.size(); i ++) {
-		if (jobQueue.Cancelled())
-			return;
 		FilePath fPath = files[i];
 		if (*fileTypes == '\0' || fPath.Matches(fileTypes)) {
-			//OutputAppendStringSynchronised(i->AsInternal());
-			//OutputAppendStringSynchronised("\n");
-			FileReader fr(fPath, flagsMatchCase || regexpSearch.Use());
-			if ((gf & grepBinary) || !fr.BufferContainsNull()) {
-				while (const char *line = fr.Next()) {
-					const char *match = regexpSearch.Use() ? 
-						regexpSearch.Search(line) :
-						strstr(line, searchString);
-					if (match) {
-						if (flagsWholeWord && !regexpSearch.Use()) {
-							const char *lineEnd = line + strlen(line);
-							while (match) {
-								if (((match == line) || !IsWordCharacter(match[-1])) &&
-								        ((match + searchLength == (lineEnd)) || !IsWordCharacter(match[searchLength]))) {
-									break;
-								}
-								match = strstr(match + 1, searchString);
-							}
-						}
-						if (match) {
-							os.append(fPath.AsUTF8().c_str());
-							os.append(":");
-							std::string lNumber = StdStringFromInteger(fr.LineNumber());
-							os.append(lNumber.c_str());
-							os.append(":");
-							os.append(fr.Original());
-							os.append("\n");
-						}
-					}
-				}
-			}
-		}
-	}
-	if (os.length()) {
-		if (gf & grepStdOut) {
-			fwrite(os.c_str(), os.length(), 1, stdout);
-		} else {
-			OutputAppendStringSynchronised(os.c_str());
+			if (!index || !index->Excludes(fPath))
+				engine.AddFile(fPath);
 		}
 	}
+	// Release results found by the grep threads while enumeration continues.
+	std::string os;
+	engine.TakeOutput(os);
+	GrepOutput(gf, os);
 	for (size_t j = 0; j < directories.size(); j++) {
+		if (jobQueue.Cancelled()) {
+			engine.Cancel();
+			return;
+		}
 		FilePath fPath = directories[j];
 		if ((gf & grepDot) || GrepIntoDirectory(fPath.Name())) {
-			GrepRecursive(gf, fPath, searchString, fileTypes);
+			GrepRecursive(engine, index, gf, fPath, fileTypes);
 		}
 	}
 }
 
+FilePath SciTEBase::GrepIndexPath(const FilePath &root) {
+	// Name the index after a hash of the directory so each directory has its own index.
+	const std::string rootName = root.AsUTF8();
+	unsigned int hash = 2166136261U;
+	for (size_t i = 0; i < rootName.length(); i++) {
+		hash ^= static_cast<unsigned char>(rootName[i]);
+		hash *= 16777619U;
+	}
+	char sHash[20];
+	sprintf(sHash, "%08x", hash);
+	GUI::gui_string indexName = configFileVisibilityString;
+	indexName += GUI_TEXT("SciTE_grep_");
+	indexName += GUI::StringFromUTF8(sHash);
+	indexName += GUI_TEXT(".index");
+	FilePath indexDirectory = GUI::StringFromUTF8(props.GetExpandedString("find.in.files.index.directory"));
+	if (!indexDirectory.IsSet())
+		indexDirectory = GetSciteUserHome();
+	return FilePath(indexDirectory, indexName.c_str());
+}
+
+void SciTEBase::StartGrepIndexer(const FilePath &root, const FilePath &indexPath) {
+	Lock lock(jobQueue.mutex);
+	if (grepIndexer)
+		return;	// Already updating an index so leave this one for the next search.
+	GrepIndexer *indexer = new GrepIndexer(this, root, indexPath);
+	if (PerformOnNewThread(indexer)) {
+		grepIndexer = indexer;
+	} else {
+		delete indexer;
+	}
+}
+
 void SciTEBase::InternalGrep(GrepFlags gf, const GUI::gui_char *directory, const GUI::gui_char *fileTypes, const char *search, sptr_t &originalEnd) {
 	GUI::ElapsedTime commandTime;
 	if (!(gf & grepStdOut)) {
@@ -1520,7 +1501,47 @@ void SciTEBase::InternalGrep(GrepFlags gf, const GUI::gui_char *directory, const
 	if (!(gf & grepMatchCase)) {
 		LowerCaseAZ(searchString);
 	}
-	GrepRecursive(gf, FilePath(directory), searchString.c_str(), fileTypes);
+	GrepParameters params;
+	params.searchString = searchString;
+	params.matchCase = (gf & grepMatchCase) != 0;
+	params.wholeWord = (gf & grepWholeWord) != 0;
+	params.binary = (gf & grepBinary) != 0;
+	params.regExp = (gf & grepRegexp) && props.GetInt("find.in.files.enable.regexp");
+	params.regExpAutomaton = props.GetInt("find.in.files.regexp.automaton", 1) != 0;
+	// The index only covers the directories that are searched without grepDot.
+	const bool useIndex = props.GetInt("find.in.files.index") && !(gf & grepDot) && !(gf & grepStdOut);
+	const FilePath root(directory);
+	FilePath indexPath;
+	bool updateIndex = false;
+	GrepEngine engine;
+	if (engine.Init(params)) {
+		GrepIndex index;
+		if (useIndex) {
+			indexPath = GrepIndexPath(root);
+			if (index.Load(indexPath, root))
+				index.SelectCandidates(engine.RequiredLiteral());
+			else
+				updateIndex = true;
+		}
+		// Directories are enumerated on this thread while grep threads search the files found.
+		engine.Start(this, props.GetInt("find.in.files.threads", 0));
+		GrepRecursive(engine, useIndex ? &index : 0, gf, root, fileTypes);
+		engine.EnumerationComplete();
+		while (!engine.Finished()) {
+			if (jobQueue.Cancelled()) {
+				engine.Cancel();
+				break;
+			}
+			engine.Wait();
+			std::string os;
+			engine.TakeOutput(os);
+			GrepOutput(gf, os);
+		}
+		updateIndex = useIndex && !engine.Cancelled() && (updateIndex || index.Stale());
+	}
+	// Started after the index is closed so it can be replaced.
+	if (updateIndex)
+		StartGrepIndexer(root, indexPath);
 	if (!(gf & grepStdOut)) {
 		std::string sExitMessage(">");
 		if (jobQueue.TimeCommands()) {
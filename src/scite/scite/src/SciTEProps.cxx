@@ -1017,6 +1017,7 @@ void SciTEBase::ReadProperties() {
 	wOutput.Call(SCI_SETPHASESDRAW, phasesDraw);
 
 	wEditor.Call(SCI_SETLAYOUTCACHE, props.GetInt("cache.layout", SC_CACHE_CARET));
+	wEditor.Call(SCI_SETLAYOUTCACHEBUDGET, props.GetInt("cache.layout.budget"));
 	wOutput.Call(SCI_SETLAYOUTCACHE, props.GetInt("output.cache.layout", SC_CACHE_CARET));
 
 	bracesCheck = props.GetInt("braces.check");
@@ -1084,6 +1085,10 @@ void SciTEBase::ReadProperties() {
 
 	wEditor.Call(SCI_SETIDLESTYLING, props.GetInt("idle.styling", SC_IDLESTYLING_NONE));
 	wOutput.Call(SCI_SETIDLESTYLING, props.GetInt("output.idle.styling", SC_IDLESTYLING_NONE));
+	wEditor.Call(SCI_SETBACKGROUNDLEXING, props.GetInt("lexing.background"));
+	wEditor.Call(SCI_SETPARALLELLEXING, props.GetInt("lexing.parallel"));
+
+	wEditor.Call(SCI_SETUNDOMEMORYLIMIT, props.GetInt("undo.memory.limit"));
 
 	if (props.GetInt("os.x.home.end.keys")) {
 		AssignKey(SCK_HOME, 0, SCI_SCROLLTOSTART);
@@ -61,6 +61,22 @@ public:
 	}
 };
 
+/// A worker started by an extension, which posts WORK_EXTENSION when done so
+/// that its results are handled on the main thread.
+struct ExtensionWorker : public Worker {
+	virtual void FinishOnMainThread() = 0;
+};
+
 struct WorkerListener {
+	virtual bool PerformOnNewThread(Worker *pWorker) = 0;
 	virtual void PostOnMainThread(int cmd, Worker *pWorker) = 0;
 };
+
+enum {
+	WORK_FILEREAD = 1,
+	WORK_FILEWRITTEN = 2,
+	WORK_FILEPROGRESS = 3,
+	WORK_GREPINDEXED = 4,
+	WORK_EXTENSION = 5,
+	WORK_PLATFORM = 100
+};
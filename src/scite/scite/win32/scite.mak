@@ -67,6 +67,9 @@ SHAREDOBJS=\
 	ExportXML.obj \
 	FilePath.obj \
 	FileWorker.obj \
+	GrepIndex.obj \
+	GrepRegex.obj \
+	GrepWorker.obj \
 	GUIWin.obj \
 	IFaceTable.obj \
 	JobQueue.obj \
@@ -603,6 +606,45 @@ FileWorker.obj: \
 	../src/Worker.h \
 	../src/FileWorker.h \
 	../src/Utf8_16.h
+GrepIndex.obj: \
+	../src/GrepIndex.cxx \
+	../../scintilla/include/Scintilla.h \
+	../../scintilla/include/Sci_Position.h \
+	../../scintilla/include/ILexer.h \
+	../src/GUI.h \
+	../src/FilePath.h \
+	../src/Mutex.h \
+	../src/Cookie.h \
+	../src/Worker.h \
+	../src/FileWorker.h \
+	../src/GrepWorker.h \
+	../src/GrepIndex.h
+GrepRegex.obj: \
+	../src/GrepRegex.cxx \
+	../src/GrepRegex.h
+GrepWorker.obj: \
+	../src/GrepWorker.cxx \
+	../../scintilla/include/Scintilla.h \
+	../../scintilla/include/Sci_Position.h \
+	../../scintilla/include/ILexer.h \
+	../src/GUI.h \
+	../src/StringList.h \
+	../src/StringHelpers.h \
+	../src/FilePath.h \
+	../src/StyleDefinition.h \
+	../src/PropSetFile.h \
+	../src/StyleWriter.h \
+	../src/Extender.h \
+	../src/SciTE.h \
+	../src/Mutex.h \
+	../src/JobQueue.h \
+	../src/Cookie.h \
+	../src/Worker.h \
+	../src/FileWorker.h \
+	../src/MatchMarker.h \
+	../src/SciTEBase.h \
+	../src/GrepRegex.h \
+	../src/GrepWorker.h
 JobQueue.obj: \
 	../src/JobQueue.cxx \
 	../../scintilla/include/Scintilla.h \
@@ -640,6 +682,8 @@ PythonExtension.obj: \
 	../../scintilla/include/Scintilla.h \
 	../../scintilla/include/Sci_Position.h \
 	../src/GUI.h \
+	../src/Mutex.h \
+	../src/Worker.h \
 	../src/PythonExtension.h \
 	../src/Extender.h
 SciTEBase.obj: \
@@ -707,6 +751,7 @@ SciTEIO.obj: \
 	../src/FileWorker.h \
 	../src/MatchMarker.h \
 	../src/SciTEBase.h \
+	../src/GrepWorker.h \
 	../src/Utf8_16.h
 SciTEProps.obj: \
 	../src/SciTEProps.cxx \